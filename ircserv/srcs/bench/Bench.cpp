@@ -0,0 +1,32 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Bench.cpp                                          :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 04:11:37 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 04:11:37 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "Bench.hpp"
+#include <cstdio>
+
+void Bench::title(const std::string& name, const std::string& what)
+{
+	std::printf("\n== %s: %s\n", name.c_str(), what.c_str());
+}
+
+void Bench::row(const std::string& label, double value, const char* unit)
+{
+	std::printf("  %-34s %12.2f %s\n", label.c_str(), value, unit);
+}
+
+//* Same row plus the replaced approach and how many times slower it is
+void Bench::row(const std::string& label, double value, const char* unit,
+	double baseline, const char* baselineName)
+{
+	std::printf("  %-34s %12.2f %s   %s %12.2f %s (x%.1f)\n", label.c_str(), value, unit,
+		baselineName, baseline, unit, value > 0 ? baseline / value : 0.0);
+}
@@ -0,0 +1,89 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Bench.hpp                                          :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 04:11:37 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 04:11:37 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include <string>
+#include <cstddef>
+#include <ctime>
+
+/**
+ * Bench: Micro-benchmarks of the server's hot paths (make bench)
+ *
+ * Each case links the server's own objects and times one mechanism in
+ * isolation, next to the approach it replaced where that still makes
+ * sense to reproduce, so the two columns come from the same build. Whole
+ * server behavior (latency, throughput, scaling) is the load generator's
+ * job, not this one's.
+ *
+ * Timing: an operation batch is repeated until MIN_TIME_NS have passed,
+ * the result is nanoseconds per operation. Numbers depend on the build
+ * flags, so compare runs of the same binary.
+ *
+ * Usage:
+ *   ./microbench              // every case
+ *   ./microbench fd-table     // only the named ones
+ */
+
+class Bench
+{
+	public:
+		static const unsigned long MIN_TIME_NS = 200000000UL;	//* Per measurement
+
+		static unsigned long	nowNs()
+		{
+			struct timespec ts;
+			clock_gettime(CLOCK_MONOTONIC, &ts);
+			return (static_cast<unsigned long>(ts.tv_sec) * 1000000000UL
+				+ static_cast<unsigned long>(ts.tv_nsec));
+		}
+
+		//* op() runs one batch and returns how many operations it did
+		template <typename Op>
+		static double	nsPerOp(Op& op)
+		{
+			unsigned long operations = op();		//* Warm caches and branch predictors
+			operations = 0;
+			unsigned long start = nowNs();
+			unsigned long elapsed = 0;
+			while (elapsed < MIN_TIME_NS)
+			{
+				operations += op();
+				elapsed = nowNs() - start;
+			}
+			return (static_cast<double>(elapsed) / operations);
+		}
+
+		//* The optimizer must assume value is read, so the work producing it stays
+		static void	keep(const void* value)
+		{
+			__asm__ __volatile__ ("" : : "r" (value) : "memory");
+		}
+
+		static void	title(const std::string& name, const std::string& what);
+		static void	row(const std::string& label, double value, const char* unit);
+		static void	row(const std::string& label, double value, const char* unit,
+						double baseline, const char* baselineName);
+
+	private:
+		Bench();
+};
+
+//* One function per case (bench_*.cpp), registered in main_bench.cpp
+void	benchFdTable();
+void	benchDisconnect();
+void	benchFraming();
+void	benchDispatch();
+void	benchEventLine();
+
+#endif
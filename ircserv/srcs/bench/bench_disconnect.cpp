@@ -0,0 +1,116 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   bench_disconnect.cpp                               :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 04:41:19 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 04:41:19 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "Bench.hpp"
+#include "../net/PollBackend.hpp"
+#include <vector>
+#include <algorithm>
+#include <sstream>
+#include <poll.h>
+
+// Mass disconnect (netsplit, load balancer drain): every client goes away
+// in the same turn, in no particular order. Times the bookkeeping only:
+// PollBackend::remove() plus the swap-and-pop of the client list, against
+// the vector::erase() from the middle of both lists they replaced.
+
+static const int FIRST_FD = 5;
+
+struct Client
+{
+	int		fd;
+	size_t	slot;
+};
+
+// Same shuffled order for both sides
+static void shuffle(std::vector<size_t>& order)
+{
+	unsigned long state = 42;
+	for (size_t i = order.size(); i > 1; --i)
+	{
+		state = state * 6364136223846793005UL + 1442695040888963407UL;
+		std::swap(order[i - 1], order[(state >> 33) % i]);
+	}
+}
+
+static double swapAndPop(std::vector<Client>& clients, const std::vector<size_t>& order)
+{
+	PollBackend backend;
+	std::vector<Client*> list;
+	for (size_t i = 0; i < clients.size(); ++i)
+	{
+		backend.add(clients[i].fd, POLLIN);
+		clients[i].slot = list.size();
+		list.push_back(&clients[i]);
+	}
+
+	unsigned long start = Bench::nowNs();
+	for (size_t i = 0; i < order.size(); ++i)
+	{
+		Client* client = &clients[order[i]];
+		backend.remove(client->fd);
+		Client* last = list.back();
+		list[client->slot] = last;
+		last->slot = client->slot;
+		list.pop_back();
+	}
+	return ((Bench::nowNs() - start) / 1e6);
+}
+
+static double eraseFromMiddle(std::vector<Client>& clients, const std::vector<size_t>& order)
+{
+	std::vector<struct pollfd> fds;
+	std::vector<Client*> list;
+	for (size_t i = 0; i < clients.size(); ++i)
+	{
+		struct pollfd pfd;
+		pfd.fd = clients[i].fd;
+		pfd.events = POLLIN;
+		pfd.revents = 0;
+		fds.push_back(pfd);
+		list.push_back(&clients[i]);
+	}
+
+	unsigned long start = Bench::nowNs();
+	for (size_t i = 0; i < order.size(); ++i)
+	{
+		Client* client = &clients[order[i]];
+		size_t pos = 0;
+		while (fds[pos].fd != client->fd)
+			++pos;
+		fds.erase(fds.begin() + pos);
+		list.erase(std::find(list.begin(), list.end(), client));
+	}
+	return ((Bench::nowNs() - start) / 1e6);
+}
+
+void benchDisconnect()
+{
+	static const size_t sizes[] = { 1000, 5000, 20000 };
+
+	Bench::title("disconnect", "ms to remove every client at once (swap-and-pop vs erase)");
+	for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+	{
+		std::vector<Client> clients(sizes[s]);
+		std::vector<size_t> order(sizes[s]);
+		for (size_t i = 0; i < sizes[s]; ++i)
+		{
+			clients[i].fd = FIRST_FD + static_cast<int>(i);
+			order[i] = i;
+		}
+		shuffle(order);
+
+		std::ostringstream label;
+		label << sizes[s] << " clients";
+		double fast = swapAndPop(clients, order);
+		Bench::row(label.str(), fast, "ms", eraseFromMiddle(clients, order), "erase");
+	}
+}
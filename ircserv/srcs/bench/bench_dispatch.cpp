@@ -0,0 +1,81 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   bench_dispatch.cpp                                 :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 05:21:08 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 05:21:08 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "Bench.hpp"
+#include "../irc/CommandTable.hpp"
+#include "../irc/Parser.hpp"
+#include "../utils/StrView.hpp"
+#include <map>
+#include <string>
+#include <vector>
+#include <cstring>
+
+// Command name -> handler id for every line. The table side is
+// lookupCommand() on the raw bytes; the replaced side upper-cases a copy
+// (Parser::toUpper) and looks it up in a std::map<std::string, ...>, as
+// the old _commandMap did. Same names, same order for both.
+
+// Traffic-like mix: mostly PRIVMSG, some lower case, one unknown
+static const char* const NAMES[] =
+{
+	"PRIVMSG", "PRIVMSG", "PRIVMSG", "privmsg", "PING", "PONG", "JOIN",
+	"NOTICE", "MODE", "who", "PART", "TOPIC", "NICK", "QUIT", "BOGUS", "WHOIS"
+};
+static const size_t NAME_COUNT = sizeof(NAMES) / sizeof(NAMES[0]);
+
+struct TableDispatch
+{
+	std::vector<StrView>	names;
+
+	unsigned long operator()()
+	{
+		unsigned long sum = 0;
+		for (size_t i = 0; i < names.size(); ++i)
+			sum += lookupCommand(names[i].data(), names[i].size());
+		Bench::keep(&sum);
+		return (names.size());
+	}
+};
+
+struct MapDispatch
+{
+	std::vector<StrView>				names;
+	std::map<std::string, CommandId>	commands;
+
+	unsigned long operator()()
+	{
+		unsigned long sum = 0;
+		for (size_t i = 0; i < names.size(); ++i)
+		{
+			std::map<std::string, CommandId>::const_iterator it = commands.find(Parser::toUpper(names[i]));
+			sum += (it == commands.end()) ? CMD_UNKNOWN : it->second;
+		}
+		Bench::keep(&sum);
+		return (names.size());
+	}
+};
+
+void benchDispatch()
+{
+	TableDispatch table;
+	MapDispatch map;
+	for (size_t i = 0; i < NAME_COUNT; ++i)
+	{
+		table.names.push_back(StrView(NAMES[i], std::strlen(NAMES[i])));
+		map.names.push_back(table.names.back());
+	}
+	for (size_t id = CMD_UNKNOWN + 1; id < CMD_COUNT; ++id)
+		map.commands[commandName(static_cast<CommandId>(id))] = static_cast<CommandId>(id);
+
+	Bench::title("dispatch", "ns per command name resolved (perfect hash vs toupper + std::map)");
+	Bench::row("lookupCommand()", Bench::nsPerOp(table), "ns", Bench::nsPerOp(map), "map");
+}
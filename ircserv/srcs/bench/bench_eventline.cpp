@@ -0,0 +1,139 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   bench_eventline.cpp                                :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 07:02:44 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 07:02:44 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "Bench.hpp"
+#include "../client/User.hpp"
+#include "../irc/IrcLine.hpp"
+#include "../utils/SharedBuffer.hpp"
+#include "../utils/Colors.hpp"
+#include <string>
+#include <new>
+#include <cstdlib>
+#include <ctime>
+
+// Heap allocations and time to turn one PRIVMSG into the line its
+// recipients get: IrcLine body, "@time=" tag, SharedBuffer. The cached
+// side uses User::getPrefix() and the loop's "HH:MM:SS" string, as the
+// handlers do. The replaced side rebuilds nick!user@host with operator+
+// and formats the time with time()/localtime()/strftime(), as the old
+// getPrefix() and getCurrentTimestamp() did. Everything else is the same.
+
+// Every operator new of this binary goes through here
+static unsigned long	g_allocations = 0;
+
+void* operator new(size_t size) throw(std::bad_alloc)
+{
+	++g_allocations;
+	void* memory = std::malloc(size ? size : 1);
+	if (!memory)
+		throw std::bad_alloc();
+	return (memory);
+}
+
+void operator delete(void* memory) throw()
+{
+	std::free(memory);
+}
+
+void* operator new[](size_t size) throw(std::bad_alloc)
+{
+	return (operator new(size));
+}
+
+void operator delete[](void* memory) throw()
+{
+	operator delete(memory);
+}
+
+static const char* const TARGET = "#loadgen";
+static const char* const TEXT = "the quick brown fox jumps over the lazy dog, 64 bytes of text..";
+
+static std::string legacyPrefix(const User& user)
+{
+	return user.getNickname() + "!" + user.getUsername() + "@" + user.getHostname();
+}
+
+static std::string legacyTimestamp()
+{
+	time_t now = std::time(NULL);
+	struct tm* timeinfo = std::localtime(&now);
+	char buffer[9];
+	std::strftime(buffer, sizeof(buffer), "%H:%M:%S", timeinfo);
+	return (std::string(buffer));
+}
+
+//* The untagged STYLE_COLOR variant of TimedLine::bufferFor()
+static void buildLine(const std::string& prefix, const std::string& timestamp)
+{
+	IrcLine body;
+	body.source(prefix).command("PRIVMSG").add(' ')
+		.paint(CYAN, TARGET).add(" :").add(TEXT).end();
+	std::string line;
+	line.reserve(body.str().size() + 48);
+	line.append(BRIGHT_MAGENTA "@time=").append(timestamp).append(RESET " ");
+	line.append(body.str());
+	SharedBuffer* buffer = SharedBuffer::create(line);
+	Bench::keep(buffer);
+	buffer->release();
+}
+
+struct CachedLine
+{
+	const User*	sender;
+	std::string	timestamp;					//* EventLoop::timestamp(), once per second
+
+	unsigned long operator()()
+	{
+		for (int i = 0; i < 64; ++i)
+			buildLine(sender->getPrefix(), timestamp);
+		return (64);
+	}
+};
+
+struct LegacyLine
+{
+	const User*	sender;
+
+	unsigned long operator()()
+	{
+		for (int i = 0; i < 64; ++i)
+			buildLine(legacyPrefix(*sender), legacyTimestamp());
+		return (64);
+	}
+};
+
+template <typename Op>
+static double allocationsPerOp(Op& op)
+{
+	unsigned long before = g_allocations;
+	unsigned long operations = op();
+	return (static_cast<double>(g_allocations - before) / operations);
+}
+
+void benchEventLine()
+{
+	User sender("loadgen_sender42");
+	sender.setUsername("loadgen_sender42");
+	sender.setHostname("192.168.100.200");
+
+	CachedLine cached;
+	cached.sender = &sender;
+	cached.timestamp = legacyTimestamp();
+	LegacyLine legacy;
+	legacy.sender = &sender;
+
+	Bench::title("event-line", "one PRIVMSG line built for its recipients (cached vs per-message prefix and time)");
+	Bench::row("heap allocations", allocationsPerOp(cached), "/line",
+		allocationsPerOp(legacy), "legacy");
+	Bench::row("build time", Bench::nsPerOp(cached), "ns",
+		Bench::nsPerOp(legacy), "legacy");
+}
@@ -0,0 +1,132 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   bench_fdtable.cpp                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 04:16:02 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 04:16:02 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "Bench.hpp"
+#include "../utils/FdTable.hpp"
+#include <vector>
+#include <sstream>
+
+// fd -> connection lookup, the first thing done for every ready descriptor.
+// One "iteration" resolves READY descriptors out of N connections, like an
+// event loop turn; the replaced code scanned the client list comparing fds.
+
+static const size_t	READY = 64;
+static const int	FIRST_FD = 5;		// stdio, listener, wakeup pipe
+
+struct Connection
+{
+	int	fd;
+};
+
+// Same pseudo-random ready set for both sides
+static void pickReady(std::vector<int>& ready, size_t clients)
+{
+	unsigned long state = 12345;
+	ready.resize(READY);
+	for (size_t i = 0; i < READY; ++i)
+	{
+		state = state * 6364136223846793005UL + 1442695040888963407UL;
+		ready[i] = FIRST_FD + static_cast<int>((state >> 33) % clients);
+	}
+}
+
+struct TableLookup
+{
+	const FdTable<Connection>&	table;
+	const std::vector<int>&		ready;
+
+	TableLookup(const FdTable<Connection>& t, const std::vector<int>& r) : table(t), ready(r) {}
+
+	unsigned long operator()()
+	{
+		for (size_t i = 0; i < ready.size(); ++i)
+			Bench::keep(table.find(ready[i]));
+		return (ready.size());
+	}
+};
+
+struct ScanLookup
+{
+	const std::vector<Connection*>&	clients;
+	const std::vector<int>&			ready;
+
+	ScanLookup(const std::vector<Connection*>& c, const std::vector<int>& r) : clients(c), ready(r) {}
+
+	unsigned long operator()()
+	{
+		for (size_t i = 0; i < ready.size(); ++i)
+		{
+			Connection* found = NULL;
+			for (size_t j = 0; j < clients.size() && !found; ++j)
+			{
+				if (clients[j]->fd == ready[i])
+					found = clients[j];
+			}
+			Bench::keep(found);
+		}
+		return (ready.size());
+	}
+};
+
+// Disconnect + accept of the same fd: the table's bookkeeping per churn
+struct TableChurn
+{
+	FdTable<Connection>&		table;
+	std::vector<Connection>&	connections;
+	const std::vector<int>&		ready;
+
+	TableChurn(FdTable<Connection>& t, std::vector<Connection>& c, const std::vector<int>& r)
+		: table(t), connections(c), ready(r) {}
+
+	unsigned long operator()()
+	{
+		for (size_t i = 0; i < ready.size(); ++i)
+		{
+			Connection* connection = &connections[ready[i] - FIRST_FD];
+			table.erase(ready[i], connection);
+			table.insert(ready[i], connection);
+		}
+		return (ready.size());
+	}
+};
+
+void benchFdTable()
+{
+	static const size_t sizes[] = { 100, 1000, 10000, 50000 };
+
+	Bench::title("fd-table", "ns per ready descriptor resolved (FdTable vs linear scan)");
+	for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+	{
+		size_t clients = sizes[s];
+		std::vector<Connection> connections(clients);
+		std::vector<Connection*> list(clients);
+		FdTable<Connection> table;
+		for (size_t i = 0; i < clients; ++i)
+		{
+			connections[i].fd = FIRST_FD + static_cast<int>(i);
+			list[i] = &connections[i];
+			table.insert(connections[i].fd, &connections[i]);
+		}
+		std::vector<int> ready;
+		pickReady(ready, clients);
+
+		TableLookup lookup(table, ready);
+		ScanLookup scan(list, ready);
+		TableChurn churn(table, connections, ready);
+		std::ostringstream label;
+		label << clients << " clients, lookup";
+		Bench::row(label.str(), Bench::nsPerOp(lookup), "ns", Bench::nsPerOp(scan), "scan");
+		label.str("");
+		label << clients << " clients, erase + insert";
+		Bench::row(label.str(), Bench::nsPerOp(churn), "ns");
+	}
+}
@@ -0,0 +1,143 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   bench_framing.cpp                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 05:02:44 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 05:02:44 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "Bench.hpp"
+#include "../client/RecvBuffer.hpp"
+#include "../irc/Parser.hpp"
+#include "../irc/Message.hpp"
+#include <string>
+#include <sstream>
+#include <cstdio>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Receive path of one pipelined client: write a burst of lines into a
+// socketpair, then read, frame and parse all of them. The ring side is
+// RecvBuffer::readFrom() + nextLine() + the zero-copy Parser::parse(); the
+// replaced side is recv() into a stack buffer, std::string append, find()
+// + substr() + erase(0, ...) per line and the owning Parser::parse().
+// Both sides pay the same syscalls, one core does everything.
+
+static std::string burst(size_t lines)
+{
+	std::ostringstream out;
+	for (size_t i = 0; i < lines; ++i)
+		out << "PRIVMSG #bench :pipelined line number " << i << " with some text\r\n";
+	return (out.str());
+}
+
+static void fill(int fd, const std::string& data)
+{
+	ssize_t written = write(fd, data.data(), data.size());
+	(void)written;
+}
+
+struct RingPath
+{
+	int					fds[2];
+	const std::string&	data;
+	size_t				lines;
+	RecvBuffer			ring;
+
+	RingPath(const int* pair, const std::string& d, size_t n) : data(d), lines(n)
+	{
+		fds[0] = pair[0];
+		fds[1] = pair[1];
+	}
+
+	unsigned long operator()()
+	{
+		fill(fds[1], data);
+		size_t framed = 0;
+		while (framed < lines)
+		{
+			ring.readFrom(fds[0]);
+			const char* line;
+			size_t length;
+			while (ring.nextLine(line, length))
+			{
+				MessageView msg;
+				Parser::parse(line, length, msg);
+				Bench::keep(msg.command.data());
+				++framed;
+			}
+		}
+		return (framed);
+	}
+};
+
+struct StringPath
+{
+	int					fds[2];
+	const std::string&	data;
+	size_t				lines;
+	std::string			buffer;
+
+	StringPath(const int* pair, const std::string& d, size_t n) : data(d), lines(n)
+	{
+		fds[0] = pair[0];
+		fds[1] = pair[1];
+	}
+
+	unsigned long operator()()
+	{
+		fill(fds[1], data);
+		size_t framed = 0;
+		while (framed < lines)
+		{
+			char chunk[4096];
+			ssize_t bytes = recv(fds[0], chunk, sizeof(chunk) - 1, 0);
+			if (bytes > 0)
+				buffer += std::string(chunk, bytes);
+			while (buffer.find("\r\n") != std::string::npos || buffer.find("\n") != std::string::npos)
+			{
+				size_t pos = buffer.find("\r\n");
+				std::string line = buffer.substr(0, pos);
+				buffer.erase(0, pos + 2);
+				Message msg = Parser::parse(line);
+				Bench::keep(msg.command.data());
+				++framed;
+			}
+		}
+		return (framed);
+	}
+};
+
+void benchFraming()
+{
+	static const size_t bursts[] = { 1, 16, 100 };
+
+	Bench::title("framing", "ns per line read, framed and parsed (RecvBuffer vs std::string)");
+	for (size_t b = 0; b < sizeof(bursts) / sizeof(bursts[0]); ++b)
+	{
+		int pair[2];
+		if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) == -1)
+		{
+			std::perror("socketpair");
+			return;
+		}
+		std::string data = burst(bursts[b]);
+		RingPath ring(pair, data, bursts[b]);
+		StringPath string(pair, data, bursts[b]);
+		double ringNs = Bench::nsPerOp(ring);
+		double stringNs = Bench::nsPerOp(string);
+
+		std::ostringstream label;
+		label << bursts[b] << " lines per read";
+		Bench::row(label.str(), ringNs, "ns", stringNs, "string");
+		label.str("");
+		label << bursts[b] << " lines per read, ring throughput";
+		Bench::row(label.str(), 1e3 / ringNs, "M/s");
+		close(pair[0]);
+		close(pair[1]);
+	}
+}
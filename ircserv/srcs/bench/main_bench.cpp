@@ -0,0 +1,69 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   main_bench.cpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 04:11:37 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 04:11:37 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "Bench.hpp"
+#include <iostream>
+#include <cstring>
+
+struct BenchCase
+{
+    const char* name;
+    void (*run)();
+    const char* what;
+};
+
+static const BenchCase CASES[] =
+{
+    { "fd-table", &benchFdTable, "fd -> connection lookup (FdTable)" },
+    { "disconnect", &benchDisconnect, "mass disconnect bookkeeping (swap-and-pop)" },
+    { "framing", &benchFraming, "receive, frame and parse pipelined lines (RecvBuffer)" },
+    { "dispatch", &benchDispatch, "command name -> id (perfect hash)" },
+    { "event-line", &benchEventLine, "PRIVMSG line with cached prefix and time" },
+};
+
+static const size_t CASE_COUNT = sizeof(CASES) / sizeof(CASES[0]);
+
+static void usage(const char* program)
+{
+    std::cerr << "Usage: " << program << " [case...]\n";
+    std::cerr << "Cases (all of them when none is given):\n";
+    for (size_t i = 0; i < CASE_COUNT; ++i)
+    {
+        std::cerr << "  " << CASES[i].name
+                  << std::string(20 - std::strlen(CASES[i].name), ' ')
+                  << CASES[i].what << "\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc == 1)
+    {
+        for (size_t i = 0; i < CASE_COUNT; ++i)
+            CASES[i].run();
+        return (0);
+    }
+    for (int arg = 1; arg < argc; ++arg)
+    {
+        size_t i = 0;
+        while (i < CASE_COUNT && std::strcmp(CASES[i].name, argv[arg]) != 0)
+            ++i;
+        if (i == CASE_COUNT)
+        {
+            std::cerr << "[ERROR] Unknown case: " << argv[arg] << "\n";
+            usage(argv[0]);
+            return (1);
+        }
+        CASES[i].run();
+    }
+    return (0);
+}
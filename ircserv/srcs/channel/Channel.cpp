@@ -1,6 +1,8 @@
 #include "Channel.hpp"
 #include "../client/User.hpp"
 #include "../client/ClientConnection.hpp"
+#include "../irc/IrcLine.hpp"
+#include "../irc/CaseMapping.hpp"
 #include "../utils/Colors.hpp"
 #include <algorithm>
 #include <iostream>
@@ -12,7 +14,8 @@
 
 Channel::Channel(const std::string& name) : 
     _name(name), _topic(""), _key(""), _limit(0),
-    _inviteOnly(false), _topicOpOnly(false), _hasKey(false), _hasLimit(false)
+    _inviteOnly(false), _topicOpOnly(false), _hasKey(false), _hasLimit(false),
+    _memberCacheValid(false)
 {
 }
 
@@ -21,7 +24,7 @@ Channel::~Channel()
     // Don't delete users (User*), they belong to the Server.
     // Just clear the lists.
     _members.clear();
-    _operators.clear();
+    _memberIndex.clear();
     _invites.clear();
 }
 
@@ -32,7 +35,7 @@ Channel::~Channel()
 const std::string& Channel::getName() const { return _name; }
 const std::string& Channel::getTopic() const { return _topic; }
 const std::string& Channel::getKey() const { return _key; }
-size_t Channel::getUserCount() const { return _members.size(); }
+size_t Channel::getUserCount() const { return _memberIndex.size(); }
 int Channel::getLimit() const { return _limit; }
 
 // ============================================================================
@@ -104,44 +107,55 @@ void Channel::setTopic(const std::string& topic)
 // MEMBER MANAGEMENT
 // ============================================================================
 
+Channel::Membership* Channel::findMembership(User* user) const
+{
+    const MemberList::iterator* it = _memberIndex.find(user);
+    return it ? &(**it) : NULL;
+}
+
 void Channel::addMember(User* user)
 {
     if (!isMember(user))
-        _members.push_back(user);
+    {
+        Membership entry;
+        entry.user = user;
+        entry.isOperator = false;
+        _memberIndex.set(user, _members.insert(_members.end(), entry));
+        _memberCacheValid = false;
+    }
     
     // If user was invited, remove from pending invites
-    if (_invites.count(user->getNickname()))
-        _invites.erase(user->getNickname());
+    _invites.erase(ircCaseFold(user->getNickname()));
 }
 
+// Removing the record also drops operator status
 void Channel::removeMember(User* user)
 {
-    std::vector<User*>::iterator it = std::find(_members.begin(), _members.end(), user);
-    if (it != _members.end())
-        _members.erase(it);
-
-    // If user was an operator, remove from operators too
-    removeOperator(user);
+    MemberList::iterator* it = _memberIndex.find(user);
+    if (!it)
+        return;
+    _members.erase(*it);
+    _memberIndex.erase(user);
+    _memberCacheValid = false;
 }
 
 bool Channel::isMember(User* user) const
 {
-    return std::find(_members.begin(), _members.end(), user) != _members.end();
-}
-
-User* Channel::getMember(const std::string& nick) const
-{
-    for (size_t i = 0; i < _members.size(); ++i) {
-        if (_members[i]->getNickname() == nick)
-            return _members[i];
-    }
-    return NULL;
+    return _memberIndex.find(user) != NULL;
 }
 
 // [CRITICAL] Implementation needed for NICK spam fix
 const std::vector<User*>& Channel::getMembers() const
 {
-    return _members;
+    if (!_memberCacheValid)
+    {
+        _memberCache.clear();
+        _memberCache.reserve(_memberIndex.size());
+        for (MemberList::const_iterator it = _members.begin(); it != _members.end(); ++it)
+            _memberCache.push_back(it->user);
+        _memberCacheValid = true;
+    }
+    return _memberCache;
 }
 
 // ============================================================================
@@ -150,45 +164,51 @@ const std::vector<User*>& Channel::getMembers() const
 
 void Channel::addOperator(User* user)
 {
-    if (!isOperator(user))
-        _operators.push_back(user);
+    Membership* member = findMembership(user);
+    if (member)
+        member->isOperator = true;
 }
 
 void Channel::removeOperator(User* user)
 {
-    std::vector<User*>::iterator it = std::find(_operators.begin(), _operators.end(), user);
-    if (it != _operators.end())
-        _operators.erase(it);
+    Membership* member = findMembership(user);
+    if (member)
+        member->isOperator = false;
 }
 
 bool Channel::isOperator(User* user) const
 {
-    return std::find(_operators.begin(), _operators.end(), user) != _operators.end();
+    Membership* member = findMembership(user);
+    return member && member->isOperator;
 }
 
 // ============================================================================
 // INVITE MANAGEMENT
 // ============================================================================
 
+// Keyed by the casefolded nick, the same way the server resolves the target
 void Channel::addInvite(const std::string& nick)
 {
-    _invites.insert(nick);
+    _invites.insert(ircCaseFold(nick));
 }
 
 bool Channel::isInvited(User* user) const
 {
-    return _invites.find(user->getNickname()) != _invites.end();
+    return _invites.find(ircCaseFold(user->getNickname())) != _invites.end();
 }
 
 // ============================================================================
 // COMMUNICATION
 // ============================================================================
 
-void Channel::broadcast(const std::string& message, User* exclude)
+void Channel::broadcast(TimedLine& line, User* exclude,
+                        ClientConnection::OutputPriority priority)
 {
-    for (std::vector<User*>::iterator it = _members.begin(); it != _members.end(); ++it)
+    // Serialized once per variant (tagged or not), every member's queue
+    // references the same bytes
+    for (MemberList::iterator it = _members.begin(); it != _members.end(); ++it)
     {
-        User* member = *it;
+        User* member = it->user;
         
         if (member == exclude)
             continue;
@@ -196,28 +216,23 @@ void Channel::broadcast(const std::string& message, User* exclude)
         ClientConnection* conn = member->getConnection();
         if (conn && !conn->isClosed())
         {
-            conn->queueSend(message);
-            
-            // FIX: Force immediate send if possible
-            // This can't be done from here because Channel doesn't know Server
+            line.sendTo(conn, priority);
         }
     }
 }
 
-std::string Channel::getNamesList() const
+void Channel::appendNamesList(IrcLine& line) const
 {
-    std::string list = "";
-    for (size_t i = 0; i < _members.size(); ++i)
+    for (MemberList::const_iterator it = _members.begin(); it != _members.end(); ++it)
     {
-        if (i > 0) list += " ";
+        if (it != _members.begin()) line.add(' ');
         
-        // Operator prefix with color
-        if (isOperator(_members[i]))
-            list += std::string(BRIGHT_RED) + "@" + MAGENTA;
+        // Operator prefix with color (flag read from the record, no lookup)
+        if (it->isOperator)
+            line.color(BRIGHT_RED).add('@').color(MAGENTA);
         else
-            list += std::string(GREEN);
+            line.color(GREEN);
         
-        list += _members[i]->getNickname() + RESET;
+        line.add(it->user->getNickname()).reset();
     }
-    return list;
 }
@@ -3,11 +3,16 @@
 
 #include <string>
 #include <vector>
+#include <list>
 #include <set>
 #include <algorithm>
+#include "../utils/HashMap.hpp"
+#include "../client/ClientConnection.hpp"
 
 // Forward declaration to avoid circular dependencies
 class User;
+class IrcLine;
+class TimedLine;
 
 class Channel
 {
@@ -44,7 +49,6 @@ class Channel
         void    addMember(User* user);
         void    removeMember(User* user);
         bool    isMember(User* user) const;
-        User*   getMember(const std::string& nick) const;
 
         /**
          * [IMPORTANT] REQUIRED FOR NICK COMMAND (Avoid Spam)
@@ -56,6 +60,7 @@ class Channel
 
         // ------------------------------------------------------------------
         // OPERATOR MANAGEMENT (+o)
+        // Operator status is a flag on the membership: only members can be OP
         // ------------------------------------------------------------------
         void    addOperator(User* user);
         void    removeOperator(User* user);
@@ -77,13 +82,14 @@ class Channel
          * If excludeUser is NULL, the message is sent to everyone.
          * If excludeUser is a valid User pointer, that user is skipped.
          * 
-         * @param msg Message to send (must end with \r\n for IRC protocol)
+         * @param line Event line (body ends with \r\n), time-tagged per member
          * @param excludeUser User to skip sending to (NULL = send to everyone)
          */
-        void    broadcast(const std::string& msg, User* excludeUser);
+        void    broadcast(TimedLine& line, User* excludeUser,
+                          ClientConnection::OutputPriority priority = ClientConnection::OUTPUT_NORMAL);
         
-        // Generates the names list for RPL_NAMREPLY (e.g.: "@Admin +User1 User2")
-        std::string getNamesList() const;
+        // Appends the names list for RPL_NAMREPLY (e.g.: "@Admin +User1 User2")
+        void    appendNamesList(IrcLine& line) const;
 
     private:
         std::string _name;
@@ -97,13 +103,29 @@ class Channel
         bool _hasKey;           // +k enabled
         bool _hasLimit;         // +l enabled
 
+        // Per-member record: privileges live next to the membership itself
+        struct Membership
+        {
+            User*   user;
+            bool    isOperator;     // +o
+        };
+        typedef std::list<Membership> MemberList;
+
         // Internal lists
-        std::vector<User*>    _members;   // All users inside
-        std::vector<User*>    _operators; // Subset of users who are OP
-        std::set<std::string> _invites;   // Invited nicks (whitelist for +i)
+        MemberList            _members;     // All users inside, in join order (NAMES/WHO)
+        HashMap<User*, MemberList::iterator, PointerHash> _memberIndex; // User -> record, O(1)
+        std::set<std::string> _invites;     // Invited nicks, casefolded (whitelist for +i)
+
+        // getMembers() snapshot, rebuilt only after the member list changed
+        mutable std::vector<User*> _memberCache;
+        mutable bool               _memberCacheValid;
+
+        Membership* findMembership(User* user) const;
 
         // Private constructor to forbid channels without name
         Channel(); 
+        Channel(const Channel&);
+        Channel& operator=(const Channel&);
 };
 
 #endif
\ No newline at end of file
@@ -11,12 +11,17 @@
 /* ************************************************************************** */
 
 #include "ClientConnection.hpp"
+#include "../utils/SharedBuffer.hpp"
+#include "../server/EventLoop.hpp"
+#include "../utils/Clock.hpp"
 #include <ctime>
 
-ClientConnection::ClientConnection(int fd): _fd(fd), _recvBuffer(""),
-_sendBuffer(""), _registered(false), _hasSentPass(false), _closed(false),
-_lastActivity(std::time(NULL)), _connectTime(std::time(NULL)), _user(NULL)
+ClientConnection::ClientConnection(int fd): _fd(fd), _registered(false), _hasSentPass(false), _caps(0), _negotiating(false), _closed(false),
+_quitReason("Connection closed"), _sendqLow(0), _sendqHigh(0), _sendqMax(0), _readPaused(false),
+_sendqExceeded(false), _dropped(0), _sendqCounted(0), _deferred(false), _lastActivity(Clock::nowMs()), _connectTime(std::time(NULL)), _pingSentAt(0), _user(NULL),
+_loop(NULL), _outputList(NULL), _outputQueued(false), _pollEvents(0), _slot(0)
 {
+	_timer.owner = this;
 }
 
 ClientConnection::~ClientConnection()
@@ -48,6 +53,29 @@ bool ClientConnection::hasSentPass() const
 	return _hasSentPass;
 }
 
+bool ClientConnection::hasCapability(Capability cap) const
+{
+	return (_caps & cap) != 0;
+}
+
+void ClientConnection::setCapability(Capability cap, bool enabled)
+{
+	if (enabled)
+		_caps |= cap;
+	else
+		_caps &= ~static_cast<unsigned>(cap);
+}
+
+bool ClientConnection::isNegotiating() const
+{
+	return _negotiating;
+}
+
+void ClientConnection::setNegotiating(bool negotiating)
+{
+	_negotiating = negotiating;
+}
+
 // ========================================================================
 // 							 	  Socket Info
 // ========================================================================
@@ -61,80 +89,207 @@ int ClientConnection::getFd() const
 // 							  IO Operations
 // ========================================================================
 
-void ClientConnection::appendRecvData(const std::string& data)
+ssize_t ClientConnection::readSocket()
+{
+	return _recvBuffer.readFrom(_fd);
+}
+
+bool ClientConnection::nextLine(const char*& line, size_t& length)
 {
-	_recvBuffer += data; 
+	return _recvBuffer.nextLine(line, length);
 }
 
-bool ClientConnection::hasCompleteLine() const
+size_t ClientConnection::getRecvQueueSize() const
 {
-	// Accept both \r\n (IRC standard) and \n (telnet/nc)
-	return (_recvBuffer.find("\r\n") != std::string::npos || 
-	        _recvBuffer.find("\n") != std::string::npos);
+	return _recvBuffer.size();
 }
 
-std::string ClientConnection::popLine()
+bool ClientConnection::isRecvBufferFull() const
 {
-	std::string line;
-	
-	// Look for \r\n first (standard IRC protocol)
-	size_t pos = _recvBuffer.find("\r\n");
-	
-	if (pos != std::string::npos) 
+	return _recvBuffer.freeSpace() == 0;
+}
+
+// Buffers belong to the owning loop's thread. From any other thread the
+// line is posted to that loop, which queues it on its next iteration.
+void ClientConnection::queueSend(const std::string& data, OutputPriority priority)
+{
+	if (data.empty())
+		return;
+	if (_loop && !_loop->isCurrent())
 	{
-		line = _recvBuffer.substr(0, pos);
-		_recvBuffer.erase(0, pos + 2); // Remove line + \r\n
+		SharedBuffer* buffer = SharedBuffer::create(data);
+		_loop->post(this, buffer, priority);
+		buffer->release();
+		return;
 	}
-	else 
+	if (!admitOutput(data.size(), priority))
+		return;
+	_sendQueue.append(data.data(), data.size());
+	EventLoop::countLineOut(data.size());
+	notifyOutput();
+}
+
+void ClientConnection::queueShared(SharedBuffer* buffer, OutputPriority priority)
+{
+	if (buffer->size() == 0)
+		return;
+	if (_loop && !_loop->isCurrent())
 	{
-		// Fallback: look for just \n (telnet, netcat without -C)
-		pos = _recvBuffer.find("\n");
-		if (pos != std::string::npos) 
-		{
-			line = _recvBuffer.substr(0, pos);
-			_recvBuffer.erase(0, pos + 1); // Remove line + \n
-			
-			// Clean possible trailing \r
-			if (!line.empty() && line[line.length() - 1] == '\r')
-				line.erase(line.length() - 1);
-		}
+		_loop->post(this, buffer, priority);
+		return;
 	}
-	
-	return line;
+	queuePosted(buffer, priority);
 }
 
-void ClientConnection::queueSend(const std::string& data)
+// Owner thread: a shared line, or one another loop posted to us. Counted
+// once it is in the queue, so lines dropped or discarded by the send-queue
+// limits don't show up as sent.
+void ClientConnection::queuePosted(SharedBuffer* buffer, OutputPriority priority)
 {
-	_sendBuffer += data;
+	if (!admitOutput(buffer->size(), priority))
+		return;
+	_sendQueue.append(buffer);
+	EventLoop::countLineOut(buffer->size());
+	notifyOutput();
+}
+
+// Applies the send-queue limits before anything is appended (owner thread).
+// Past the hard limit the queue is replaced by a single ERROR line and the
+// connection is closed; the loop evicts it at the end of the iteration.
+// The limits bound the memory the queue holds, not just its unsent bytes.
+bool ClientConnection::admitOutput(size_t length, OutputPriority priority)
+{
+	if (_sendqExceeded)
+		return false;
+	size_t queued = _sendQueue.memory();
+	if (_sendqMax && queued + length > _sendqMax)
+	{
+		static const char error[] = "ERROR :Closing Link: (SendQ exceeded)\r\n";
+		_sendqExceeded = true;
+		_sendQueue.clear();
+		_sendQueue.append(error, sizeof(error) - 1);
+		_quitReason = "SendQ exceeded";
+		closeConnection();
+		notifyOutput();
+		return false;
+	}
+	if (priority == OUTPUT_LOW && _sendqHigh && queued >= _sendqHigh)
+	{
+		++_dropped;
+		return false;
+	}
+	return true;
+}
+
+void ClientConnection::notifyOutput()
+{
+	// Let the server know this fd may need POLLOUT, without it rescanning everyone
+	if (_outputList && !_outputQueued)
+	{
+		_outputQueued = true;
+		_outputList->push_back(this);
+	}
 }
 
 bool ClientConnection::hasPendingSend() const
 {
-	return !_sendBuffer.empty();
+	return !_sendQueue.empty();
+}
+
+size_t ClientConnection::getSendQueueSize() const
+{
+	return _sendQueue.size();
 }
 
-const std::string& ClientConnection::getSendBuffer() const
+size_t ClientConnection::getSendQueueMemory() const
 {
-	return _sendBuffer;
+	return _sendQueue.memory();
+}
+
+int ClientConnection::fillSendIovec(struct iovec* iov, int max) const
+{
+	return _sendQueue.fillIovec(iov, max);
 }
 
 void ClientConnection::clearSentData(size_t bytes)
 {
-	_sendBuffer.erase(0, bytes);
+	_sendQueue.consume(bytes);
+}
+
+// ========================================================================
+// 							Output Backpressure
+// ========================================================================
+
+void ClientConnection::setSendQueueLimits(size_t low, size_t high, size_t max)
+{
+	_sendqLow = low;
+	_sendqHigh = high;
+	_sendqMax = max;
+}
+
+// Hysteresis: reading stops once the queue reaches the high mark and only
+// resumes after it drained to the low mark, so a slow reader doesn't flap.
+bool ClientConnection::updateReadPause()
+{
+	size_t queued = _sendQueue.memory();
+	if (_sendqHigh && queued >= _sendqHigh)
+		_readPaused = true;
+	else if (queued <= _sendqLow)
+		_readPaused = false;
+	return _readPaused;
+}
+
+bool ClientConnection::isSendQueueExceeded() const
+{
+	return _sendqExceeded;
+}
+
+unsigned long ClientConnection::getDroppedCount() const
+{
+	return _dropped;
+}
+
+size_t ClientConnection::getCountedSendQueue() const
+{
+	return _sendqCounted;
+}
+
+void ClientConnection::setCountedSendQueue(size_t bytes)
+{
+	_sendqCounted = bytes;
+}
+
+// ========================================================================
+// 							  Flood Control
+// ========================================================================
+
+TokenBucket& ClientConnection::getFloodBucket()
+{
+	return _flood;
+}
+
+bool ClientConnection::isDeferred() const
+{
+	return _deferred;
+}
+
+void ClientConnection::setDeferred(bool deferred)
+{
+	_deferred = deferred;
 }
 
 // ========================================================================
 // 							Activity Tracking
 // ========================================================================
 
-void ClientConnection::updateActivity()
+void ClientConnection::updateActivity(unsigned long now)
 {
-	_lastActivity = std::time(NULL);
+	__atomic_store_n(&_lastActivity, now, __ATOMIC_RELAXED);
 }
 
-time_t ClientConnection::getLastActivity() const
+unsigned long ClientConnection::getLastActivity() const
 {
-	return _lastActivity;
+	return __atomic_load_n(&_lastActivity, __ATOMIC_RELAXED);
 }
 
 time_t ClientConnection::getConnectTime() const
@@ -142,18 +297,49 @@ time_t ClientConnection::getConnectTime() const
     return _connectTime;
 }
 
+TimerWheel::Node& ClientConnection::getTimer()
+{
+	return _timer;
+}
+
+void ClientConnection::markPingSent(unsigned long now)
+{
+	_pingSentAt = now ? now : 1;
+}
+
+unsigned long ClientConnection::getPingSentAt() const
+{
+	return _pingSentAt;
+}
+
+void ClientConnection::clearPingSent()
+{
+	_pingSentAt = 0;
+}
+
 // ========================================================================
 // 						  Connection Management
 // ========================================================================
 
 void ClientConnection::closeConnection()
 {
-	_closed = true;
+	__atomic_store_n(&_closed, true, __ATOMIC_RELAXED);
 }
 
 bool ClientConnection::isClosed() const
 {
-	return _closed;
+	// Also read by other loops from Channel::broadcast
+	return __atomic_load_n(&_closed, __ATOMIC_RELAXED);
+}
+
+void ClientConnection::setQuitReason(const std::string& reason)
+{
+	_quitReason = reason;
+}
+
+const std::string& ClientConnection::getQuitReason() const
+{
+	return _quitReason;
 }
 
 // ========================================================================
@@ -168,4 +354,48 @@ void ClientConnection::setUser(User* user)
 User* ClientConnection::getUser() const
 {
 	return _user;
-}
\ No newline at end of file
+}
+
+// ========================================================================
+// 						  Event Loop Bookkeeping
+// ========================================================================
+
+void ClientConnection::setLoop(EventLoop* loop)
+{
+	_loop = loop;
+}
+
+EventLoop* ClientConnection::getLoop() const
+{
+	return _loop;
+}
+
+void ClientConnection::setOutputList(std::vector<ClientConnection*>* list)
+{
+	_outputList = list;
+}
+
+void ClientConnection::clearOutputQueued()
+{
+	_outputQueued = false;
+}
+
+short ClientConnection::getPollEvents() const
+{
+	return _pollEvents;
+}
+
+void ClientConnection::setPollEvents(short events)
+{
+	_pollEvents = events;
+}
+
+size_t ClientConnection::getSlot() const
+{
+	return _slot;
+}
+
+void ClientConnection::setSlot(size_t slot)
+{
+	_slot = slot;
+}
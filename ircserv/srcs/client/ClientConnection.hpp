@@ -15,10 +15,18 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
 #include <ctime>
+#include <sys/uio.h>
+#include "SendQueue.hpp"
+#include "RecvBuffer.hpp"
+#include "../utils/TokenBucket.hpp"
+#include "../utils/TimerWheel.hpp"
 
 class Server;
 class User;
+class SharedBuffer;
+class EventLoop;
 
 /** 
  * -R- Manages the TCP connection state, I/O buffers, and authentication status.
@@ -27,6 +35,19 @@ class User;
 class ClientConnection
 {
     public:
+        /* Low-priority output is dropped while the send queue is above its high mark */
+        enum OutputPriority
+        {
+            OUTPUT_NORMAL,
+            OUTPUT_LOW
+        };
+
+        /* IRCv3 capabilities negotiated with CAP (bit mask) */
+        enum Capability
+        {
+            CAP_SERVER_TIME = 1
+        };
+
         ClientConnection(int fd);
         ~ClientConnection();
 
@@ -35,48 +56,113 @@ class ClientConnection
         void	setRegistered(bool r);
         void	markPassReceived();
         bool	hasSentPass() const;
+        bool	hasCapability(Capability cap) const;
+        void	setCapability(Capability cap, bool enabled);
+        bool	isNegotiating() const;					//* Between CAP LS/REQ and CAP END
+        void	setNegotiating(bool negotiating);
         
         /* Socket info */
         int		getFd() const;
         
         /* IO operations */
-        void	appendRecvData(const std::string& data);
-        bool	hasCompleteLine() const;
-        std::string	popLine();
+        ssize_t	readSocket();							//* recv straight into the ring buffer
+        bool	nextLine(const char*& line, size_t& length);	//* View valid until next read/line
+        size_t	getRecvQueueSize() const;				//* Received bytes not yet executed
+        bool	isRecvBufferFull() const;				//* No room to read until lines run
         
-        void	queueSend(const std::string& data);
+        void	queueSend(const std::string& data, OutputPriority priority = OUTPUT_NORMAL);
+        void	queueShared(SharedBuffer* buffer, OutputPriority priority = OUTPUT_NORMAL);	//* By reference (fan-out)
+        void	queuePosted(SharedBuffer* buffer, OutputPriority priority);	//* From the loop inbox (owner thread)
         bool	hasPendingSend() const;
-        const std::string& getSendBuffer() const;
+        size_t	getSendQueueSize() const;				//* Bytes still waiting to be sent
+        size_t	getSendQueueMemory() const;				//* Heap held for them (what the limits bound)
+        int		fillSendIovec(struct iovec* iov, int max) const;	//* Head of the queue for writev()
         void	clearSentData(size_t bytes);
 
-        /* Activity tracking */
-        void	updateActivity();
-        time_t	getLastActivity() const;
+        /* Output backpressure */
+        void	setSendQueueLimits(size_t low, size_t high, size_t max);
+        bool	updateReadPause();						//* Re-evaluate the watermarks, true = don't read
+        bool	isSendQueueExceeded() const;			//* Hit the hard limit, pending eviction
+        unsigned long	getDroppedCount() const;		//* Low-priority lines dropped so far
+        size_t	getCountedSendQueue() const;			//* Share of the loop's sendq gauge
+        void	setCountedSendQueue(size_t bytes);
+
+        /* Flood control */
+        TokenBucket&	getFloodBucket();
+        bool	isDeferred() const;						//* Has lines waiting for tokens
+        void	setDeferred(bool deferred);
+
+        /* Activity tracking (Clock::nowMs(), read by WHOIS from any loop) */
+        void	updateActivity(unsigned long now);
+        unsigned long	getLastActivity() const;
         time_t  getConnectTime() const;
 
+        /* Keepalive: one timer per connection in its loop's wheel */
+        TimerWheel::Node&	getTimer();
+        void	markPingSent(unsigned long now);
+        unsigned long	getPingSentAt() const;		//* 0 = no PING outstanding
+        void	clearPingSent();
+
         /* Connection management */
         void	closeConnection();
         bool	isClosed() const;
+        void	setQuitReason(const std::string& reason);	//* QUIT text shown to the channels
+        const std::string&	getQuitReason() const;
 
         /* User association */
         void	setUser(User* user);
         User*	getUser() const;
 
+        /* Event loop bookkeeping */
+        void	setLoop(EventLoop* loop);				//* Owner thread of the buffers
+        EventLoop*	getLoop() const;
+        void	setOutputList(std::vector<ClientConnection*>* list);
+        void	notifyOutput();							//* Join the loop's flush list (once per iteration)
+        void	clearOutputQueued();
+        short	getPollEvents() const;
+        void	setPollEvents(short events);
+        size_t	getSlot() const;
+        void	setSlot(size_t slot);
+
     private:
         const int _fd;							//* TCP socket (const after construction)
         
-        std::string	_recvBuffer;				//* Incoming data buffer
-        std::string _sendBuffer;				//* Outgoing data buffer
+        RecvBuffer	_recvBuffer;				//* Incoming ring buffer, framed in place
+        SendQueue	_sendQueue;					//* Outgoing chunks + shared lines, drained with writev()
+
+        bool	admitOutput(size_t length, OutputPriority priority);
         
         bool _registered;						//* True after PASS + NICK + USER sequence
         bool _hasSentPass;						//* True after valid PASS command
+        unsigned _caps;							//* Capability bits (read by other loops under the state lock)
+        bool _negotiating;						//* Registration waits for CAP END
         bool _closed;							//* True if connection should be terminated
+        std::string _quitReason;				//* Sent with the QUIT broadcast on teardown
+
+        size_t _sendqLow;						//* Resume reading at or below (0 = no limits)
+        size_t _sendqHigh;						//* Pause reading / drop low priority at or above
+        size_t _sendqMax;						//* Hard limit: evict
+        bool _readPaused;						//* Between the high and the low mark
+        bool _sendqExceeded;					//* Evicted, further output is discarded
+        unsigned long _dropped;					//* Low-priority lines discarded
+        size_t _sendqCounted;					//* Bytes last added to the loop's sendq gauge
+
+        TokenBucket _flood;						//* Command rate limit
+        bool _deferred;							//* Listed in EventLoop::run_queue_
         
-        time_t _lastActivity;					//* Timestamp of last received data
+        unsigned long _lastActivity;			//* Monotonic ms of last received data (__atomic)
         time_t _connectTime;                    //* Timestamp of connection time
+        TimerWheel::Node _timer;				//* Registration / PING / idle deadline
+        unsigned long _pingSentAt;				//* When our PING went out (0 = none pending)
         
         User* _user;							//* Pointer to associated User (NULL until registered)
 
+        EventLoop* _loop;						//* Owning loop (NULL until registered in one)
+        std::vector<ClientConnection*>* _outputList;	//* Loop list told when output gets queued
+        bool _outputQueued;						//* Already present in _outputList
+        short _pollEvents;						//* Interest currently registered in the event backend
+        size_t _slot;							//* Position in EventLoop::clients_ (swap-and-pop removal)
+
         ClientConnection(const ClientConnection&);
         ClientConnection& operator=(const ClientConnection&);
 };
@@ -0,0 +1,146 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   RecvBuffer.cpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 16:02:44 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 16:02:44 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "RecvBuffer.hpp"
+#include <cstring>
+#include <cerrno>
+#include <sys/uio.h>
+
+static const size_t MASK = RecvBuffer::CAPACITY - 1;
+
+RecvBuffer::RecvBuffer() : _head(0), _tail(0), _scan(0), _discarding(false)
+{
+}
+
+size_t RecvBuffer::size() const
+{
+	return (_tail - _head);
+}
+
+size_t RecvBuffer::freeSpace() const
+{
+	return (CAPACITY - (_tail - _head));
+}
+
+// ========================================================================
+// 							   Receiving
+// ========================================================================
+
+ssize_t RecvBuffer::readFrom(int fd)
+{
+	size_t space = freeSpace();
+	if (space == 0)							//* Deferred lines filled it: not EOF
+	{
+		errno = EAGAIN;
+		return (-1);
+	}
+	size_t offset = _tail & MASK;
+	size_t first = CAPACITY - offset;
+	if (first > space)
+		first = space;
+
+	struct iovec iov[2];
+	int count = 1;
+	iov[0].iov_base = _data + offset;
+	iov[0].iov_len = first;
+	if (space > first)						//* Free space wraps to the front
+	{
+		iov[1].iov_base = _data;
+		iov[1].iov_len = space - first;
+		count = 2;
+	}
+
+	ssize_t bytes = readv(fd, iov, count);
+	if (bytes > 0)
+		_tail += bytes;
+	return (bytes);
+}
+
+// ========================================================================
+// 							   Line framing
+// ========================================================================
+
+// Continue the '\n' search where the previous call stopped
+bool RecvBuffer::findNewline(size_t& pos)
+{
+	while (_scan < _tail)
+	{
+		size_t offset = _scan & MASK;
+		size_t run = CAPACITY - offset;		//* Contiguous bytes before the wrap
+		if (run > _tail - _scan)
+			run = _tail - _scan;
+
+		const char* hit = static_cast<const char*>(std::memchr(_data + offset, '\n', run));
+		if (hit)
+		{
+			pos = _scan + (hit - (_data + offset));
+			_scan = pos + 1;
+			return (true);
+		}
+		_scan += run;
+	}
+	return (false);
+}
+
+void RecvBuffer::makeView(size_t start, size_t length, const char*& line)
+{
+	size_t offset = start & MASK;
+	if (offset + length <= CAPACITY)
+	{
+		line = _data + offset;
+		return;
+	}
+	size_t first = CAPACITY - offset;
+	std::memcpy(_scratch, _data + offset, first);
+	std::memcpy(_scratch + first, _data, length - first);
+	line = _scratch;
+}
+
+bool RecvBuffer::nextLine(const char*& line, size_t& length)
+{
+	size_t pos;
+
+	while (findNewline(pos))
+	{
+		size_t start = _head;
+		_head = pos + 1;
+
+		if (_discarding)					//* Tail end of a truncated line
+		{
+			_discarding = false;
+			continue;
+		}
+
+		// Accept both \r\n (IRC standard) and \n (telnet/nc)
+		length = pos - start;
+		if (length > 0 && _data[(pos - 1) & MASK] == '\r')
+			length--;
+		if (length > MAX_LINE)
+			length = MAX_LINE;
+		makeView(start, length, line);
+		return (true);
+	}
+
+	// No newline yet. Bytes of a discarded line can go right away; a line
+	// already over the limit is cut here so it can never fill the ring.
+	if (_discarding)
+		_head = _tail;
+	else if (_tail - _head > MAX_LINE)
+	{
+		length = MAX_LINE;
+		makeView(_head, length, line);
+		_head = _tail;
+		_discarding = true;
+		return (true);
+	}
+	return (false);
+}
@@ -0,0 +1,64 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   RecvBuffer.hpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 16:02:44 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 16:02:44 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef RECV_BUFFER_HPP
+#define RECV_BUFFER_HPP
+
+#include <cstddef>
+#include <sys/types.h>
+
+/**
+ * RecvBuffer: Fixed-size ring buffer for incoming bytes of one connection
+ *
+ * - readFrom() readv()s straight into the free space (up to two regions
+ *   when the free space wraps), there is no intermediate stack buffer.
+ * - nextLine() hands out complete lines as pointer + length views into the
+ *   ring. Framing is incremental: bytes already scanned for '\n' are never
+ *   scanned again, and consuming a line only advances the head index.
+ * - A line that wraps around the end of the ring is the only case copied,
+ *   into a small scratch buffer, so views are always contiguous.
+ * - Lines longer than the RFC limit (510 bytes + CRLF) are truncated and
+ *   the rest of them is discarded up to the next newline.
+ *
+ * A view stays valid until the next call to readFrom() or nextLine().
+ */
+
+class RecvBuffer
+{
+	public:
+		static const size_t CAPACITY = 8192;		//* Power of two (index masking), recvq upper bound
+		static const size_t MAX_LINE = 510;			//* RFC 1459 limit without CRLF
+
+		RecvBuffer();
+
+		ssize_t	readFrom(int fd);				//* readv() result; -1/EAGAIN when full
+		bool	nextLine(const char*& line, size_t& length);
+
+		size_t	size() const;					//* Buffered bytes not yet consumed
+		size_t	freeSpace() const;
+
+	private:
+		char	_data[CAPACITY];
+		char	_scratch[MAX_LINE];			//* Linearized copy of a wrapped line
+		size_t	_head;						//* First unconsumed byte (free-running)
+		size_t	_tail;						//* One past the last received byte
+		size_t	_scan;						//* Bytes before this were checked for '\n'
+		bool	_discarding;				//* Dropping the rest of an overlong line
+
+		bool	findNewline(size_t& pos);
+		void	makeView(size_t start, size_t length, const char*& line);
+
+		RecvBuffer(const RecvBuffer&);
+		RecvBuffer& operator=(const RecvBuffer&);
+};
+
+#endif
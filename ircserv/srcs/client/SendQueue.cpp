@@ -0,0 +1,166 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   SendQueue.cpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 15:21:07 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 15:21:07 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "SendQueue.hpp"
+#include "../utils/SharedBuffer.hpp"
+#include <cstring>
+
+SendQueue::SendQueue() : _size(0), _chunks(0), _sharedBytes(0), _spare(NULL)
+{
+}
+
+SendQueue::~SendQueue()
+{
+	clear();
+	delete _spare;
+}
+
+// ========================================================================
+// 							   Appending
+// ========================================================================
+
+void SendQueue::append(const char* data, size_t length)
+{
+	_size += length;
+	while (length > 0)
+	{
+		// Fill the tail chunk first, open a new one only when it is full
+		if (_segments.empty() || _segments.back().chunk == NULL
+			|| _segments.back().end == CHUNK_SIZE)
+		{
+			Segment segment;
+			segment.shared = NULL;
+			segment.chunk = takeChunk();
+			segment.offset = 0;
+			segment.end = 0;
+			_segments.push_back(segment);
+		}
+		Segment& tail = _segments.back();
+		size_t room = CHUNK_SIZE - tail.end;
+		size_t n = (length < room) ? length : room;
+		std::memcpy(tail.chunk->data + tail.end, data, n);
+		tail.end += n;
+		data += n;
+		length -= n;
+	}
+}
+
+void SendQueue::append(SharedBuffer* buffer)
+{
+	if (buffer->size() == 0)
+		return;
+	Segment segment;
+	segment.shared = buffer;
+	segment.chunk = NULL;
+	segment.offset = 0;
+	segment.end = buffer->size();
+	buffer->retain();
+	_segments.push_back(segment);
+	_size += buffer->size();
+	_sharedBytes += buffer->size();
+}
+
+// ========================================================================
+// 							   Draining
+// ========================================================================
+
+bool SendQueue::empty() const
+{
+	return _size == 0;
+}
+
+size_t SendQueue::size() const
+{
+	return _size;
+}
+
+size_t SendQueue::memory() const
+{
+	return _chunks * CHUNK_SIZE + _sharedBytes;
+}
+
+const char* SendQueue::segmentData(const Segment& segment) const
+{
+	return segment.shared ? segment.shared->data() : segment.chunk->data;
+}
+
+// Point up to 'max' iovecs at the unsent bytes, in order (no copy)
+int SendQueue::fillIovec(struct iovec* iov, int max) const
+{
+	int count = 0;
+	for (std::deque<Segment>::const_iterator it = _segments.begin();
+		 it != _segments.end() && count < max; ++it, ++count)
+	{
+		iov[count].iov_base = const_cast<char*>(segmentData(*it) + it->offset);
+		iov[count].iov_len = it->end - it->offset;
+	}
+	return count;
+}
+
+void SendQueue::consume(size_t bytes)
+{
+	_size -= (bytes < _size) ? bytes : _size;
+	while (bytes > 0 && !_segments.empty())
+	{
+		Segment& head = _segments.front();
+		size_t left = head.end - head.offset;
+		if (bytes < left)
+		{
+			head.offset += bytes;
+			return;
+		}
+		bytes -= left;
+		dropSegment(head);
+		_segments.pop_front();
+	}
+}
+
+void SendQueue::clear()
+{
+	for (size_t i = 0; i < _segments.size(); ++i)
+		dropSegment(_segments[i]);
+	_segments.clear();
+	_size = 0;
+}
+
+// ========================================================================
+// 							 Chunk recycling
+// ========================================================================
+
+SendQueue::Chunk* SendQueue::takeChunk()
+{
+	_chunks++;
+	if (_spare)
+	{
+		Chunk* chunk = _spare;
+		_spare = NULL;
+		return chunk;
+	}
+	return new Chunk;
+}
+
+void SendQueue::dropSegment(Segment& segment)
+{
+	if (segment.shared)
+	{
+		_sharedBytes -= segment.end;
+		segment.shared->release();
+	}
+	else
+	{
+		_chunks--;
+		if (_spare == NULL)
+			_spare = segment.chunk;
+		else
+			delete segment.chunk;
+	}
+}
@@ -0,0 +1,89 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   SendQueue.hpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 15:21:07 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 15:21:07 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef SEND_QUEUE_HPP
+#define SEND_QUEUE_HPP
+
+#include <deque>
+#include <string>
+#include <cstddef>
+#include <sys/uio.h>
+
+class SharedBuffer;
+
+/**
+ * SendQueue: Outgoing byte queue of one connection
+ *
+ * Holds two kinds of segments, drained in order with writev():
+ * - Private data (replies to this client only) is copied into fixed-size
+ *   chunks; consecutive small replies share the tail chunk instead of
+ *   allocating one block each.
+ * - Shared data (broadcasts) is referenced through its SharedBuffer.
+ *
+ * Sent bytes only advance the head segment's offset; fully sent chunks
+ * are freed (one is kept as spare), so a partial send never moves the
+ * rest of the queue.
+ *
+ * Memory is not the unsent byte count: a short reply between two shared
+ * segments still takes a whole chunk, and a shared line is held whole
+ * until its last byte is sent. memory() is what the send-queue limits
+ * are checked against.
+ */
+
+class SendQueue
+{
+	public:
+		static const size_t CHUNK_SIZE = 4096;
+
+		SendQueue();
+		~SendQueue();
+
+		void	append(const char* data, size_t length);	//* Copy into chunks
+		void	append(SharedBuffer* buffer);				//* Reference, no copy
+
+		bool	empty() const;
+		size_t	size() const;								//* Unsent bytes
+		size_t	memory() const;								//* Private chunks + shared lines referenced
+
+		int		fillIovec(struct iovec* iov, int max) const;
+		void	consume(size_t bytes);
+		void	clear();
+
+	private:
+		struct Chunk
+		{
+			char	data[CHUNK_SIZE];
+		};
+
+		struct Segment
+		{
+			SharedBuffer*	shared;		//* Set for broadcast segments
+			Chunk*			chunk;		//* Set for private segments
+			size_t			offset;		//* First unsent byte
+			size_t			end;		//* One past the last byte (chunk fill level)
+		};
+
+		std::deque<Segment>	_segments;
+		size_t				_size;
+		size_t				_chunks;	//* Chunks currently referenced by _segments
+		size_t				_sharedBytes;	//* Whole size of the shared lines in _segments
+		Chunk*				_spare;		//* One recycled chunk, avoids new/delete churn
+
+		const char*	segmentData(const Segment& segment) const;
+		Chunk*		takeChunk();
+		void		dropSegment(Segment& segment);
+
+		SendQueue(const SendQueue&);
+		SendQueue& operator=(const SendQueue&);
+};
+
+#endif
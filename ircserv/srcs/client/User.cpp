@@ -13,7 +13,7 @@
 #include "User.hpp"
 #include <algorithm>
 
-User::User() : _nickname(""), _username(""), _realname(""), _hostname(""),
+User::User() : _nickname(""), _username(""), _realname(""), _hostname(""), _prefix("!@"),
 _isOperator(false), _isInvisible(false), _isAway(false), _awayMessage(""),
 _connection(NULL)
 {
@@ -23,6 +23,7 @@ User::User(const std::string& nickname): _nickname(nickname), _username(""),
 _realname(""), _hostname(""), _isOperator(false), _isInvisible(false),
 _isAway(false), _awayMessage(""), _connection(NULL)
 {
+	updatePrefix();
 }
 
 User::~User()
@@ -62,11 +63,13 @@ const std::string& User::getHostname() const
 void User::setNickname(const std::string& nick)
 {
 	_nickname = nick;
+	updatePrefix();
 }
 
 void User::setUsername(const std::string& user)
 {
 	_username = user;
+	updatePrefix();
 }
 
 void User::setRealname(const std::string& real)
@@ -77,15 +80,25 @@ void User::setRealname(const std::string& real)
 void User::setHostname(const std::string& host)
 {
 	_hostname = host;
+	updatePrefix();
 }
 
 // ========================================================================
 // 							  Prefix Generation
 // ========================================================================
 
-std::string User::getPrefix() const
+// Every message a user sends or causes carries its prefix, while the parts
+// change a handful of times per session: build it on change, not per use.
+const std::string& User::getPrefix() const
 {
-	return _nickname + "!" + _username + "@" + _hostname;
+	return _prefix;
+}
+
+void User::updatePrefix()
+{
+	_prefix.clear();
+	_prefix.reserve(_nickname.size() + _username.size() + _hostname.size() + 2);
+	_prefix.append(_nickname).append(1, '!').append(_username).append(1, '@').append(_hostname);
 }
 
 // ========================================================================
@@ -45,7 +45,7 @@ class User
         void				setHostname(const std::string& host);
 
         /* Full user mask: nick!user@host */
-        std::string			getPrefix() const;	//* Returns nick!user@host
+        const std::string&	getPrefix() const;	//* Cached, rebuilt when a part changes
 
         /* Modes */
         bool				isOperator() const;
@@ -75,6 +75,7 @@ class User
         std::string	_username;					//* Username from USER command
         std::string	_realname;					//* Real name from USER command
         std::string	_hostname;					//* Client hostname/IP
+        std::string	_prefix;					//* nick!user@host, kept in sync by the setters
 
         bool		_isOperator;				//* Server operator status
         bool		_isInvisible;				//* Invisible mode (+i)
@@ -84,6 +85,8 @@ class User
         std::vector<Channel*>	_channels;		//* List of joined channels
         ClientConnection*		_connection;	//* NULL if disconnected
 
+        void		updatePrefix();
+
         User(const User&);
         User& operator=(const User&);
 };
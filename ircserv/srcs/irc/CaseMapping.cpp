@@ -0,0 +1,48 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   CaseMapping.cpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 12:10:52 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 12:10:52 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "CaseMapping.hpp"
+
+char ircToLower(char c)
+{
+	if (c >= 'A' && c <= 'Z')
+		return (c + ('a' - 'A'));
+	if (c == '[')
+		return ('{');
+	if (c == ']')
+		return ('}');
+	if (c == '\\')
+		return ('|');
+	if (c == '~')
+		return ('^');
+	return (c);
+}
+
+std::string ircCaseFold(const std::string& name)
+{
+	std::string folded(name);
+	for (size_t i = 0; i < folded.length(); ++i)
+		folded[i] = ircToLower(folded[i]);
+	return (folded);
+}
+
+bool ircEquals(const std::string& a, const std::string& b)
+{
+	if (a.length() != b.length())
+		return (false);
+	for (size_t i = 0; i < a.length(); ++i)
+	{
+		if (ircToLower(a[i]) != ircToLower(b[i]))
+			return (false);
+	}
+	return (true);
+}
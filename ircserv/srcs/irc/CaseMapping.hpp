@@ -0,0 +1,34 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   CaseMapping.hpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 12:10:52 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 12:10:52 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef CASE_MAPPING_HPP
+#define CASE_MAPPING_HPP
+
+#include <string>
+
+/**
+ * RFC 1459 casemapping: nicknames and channel names compare
+ * case-insensitively, and (Scandinavian origin) {}|^ are the
+ * lowercase equivalents of []\~.
+ *
+ *   A-Z  ->  a-z
+ *   [ ] \ ~  ->  { } | ^
+ */
+
+char		ircToLower(char c);
+
+//* Folded copy of a name, used as key of every name index
+std::string	ircCaseFold(const std::string& name);
+
+bool		ircEquals(const std::string& a, const std::string& b);
+
+#endif
@@ -12,9 +12,10 @@
 
 #include "CommandHelpers.hpp"
 #include "../client/User.hpp"
+#include "../server/EventLoop.hpp"
 #include "../irc/NumericReplies.hpp"
 #include "../utils/Colors.hpp"
-#include <iostream>
+#include "../utils/Log.hpp"
 #include <sstream>
 
 void sendReply(ClientConnection* client, std::string num, std::string msg)
@@ -24,6 +25,12 @@ void sendReply(ClientConnection* client, std::string num, std::string msg)
     client->queueSend(finalMsg);
 }
 
+// Same reply with colored params (plain text under --format=rfc)
+void sendReply(ClientConnection* client, const std::string& num, const IrcLine& params)
+{
+    sendReply(client, num, params.str());
+}
+
 void sendError(ClientConnection* client, std::string num, std::string arg)
 {
     if (!client) return;
@@ -50,6 +57,8 @@ void sendError(ClientConnection* client, std::string num, std::string arg)
     else if (num == ERR_USERNOTINCHANNEL) msg = arg + " :They aren't on that channel";
     else if (num == ERR_NOTREGISTERED) msg = ":You have not registered";
     else if (num == ERR_BADCHANMASK) msg = arg + " :Bad Channel Mask";
+    else if (num == ERR_NOPRIVILEGES) msg = ":Permission Denied- You're not an IRC operator";
+    else if (num == ERR_NOOPERHOST) msg = ":No O-lines for your host";
     else msg = arg + " :Unknown Error";
 
     sendReply(client, num, msg);
@@ -69,18 +78,20 @@ std::vector<std::string> split(const std::string &s, char delimiter) {
 void checkRegistration(ClientConnection* client)
 {
     if (client->isRegistered()) return;
+    if (client->isNegotiating()) return; // Held until CAP END
     
     User* user = client->getUser();
     // Requirement: Must have sent PASS, have Nick and have User
     if (client->hasSentPass() && !user->getNickname().empty() && !user->getUsername().empty())
     {
         client->setRegistered(true);
+        client->getLoop()->onRegistered(client);	// Commands run on the owner loop
         // Standard welcome messages with colors
-        sendReply(client, RPL_WELCOME, std::string(":") + BRIGHT_GREEN + "Welcome to the FT_IRC Network " + MAGENTA + user->getPrefix() + RESET);
-        sendReply(client, RPL_YOURHOST, std::string(":") + CYAN + "Your host is ft_irc, running version 1.0" + RESET);
-        sendReply(client, RPL_CREATED, std::string(":") + CYAN + "This server was created today" + RESET);
-        sendReply(client, RPL_MYINFO, std::string(CYAN) + "ft_irc 1.0 io tkl" + RESET); // Supported modes
+        sendReply(client, RPL_WELCOME, IrcLine().add(":").color(BRIGHT_GREEN).add("Welcome to the FT_IRC Network ").paint(MAGENTA, user->getPrefix()));
+        sendReply(client, RPL_YOURHOST, IrcLine().add(":").paint(CYAN, "Your host is ft_irc, running version 1.0"));
+        sendReply(client, RPL_CREATED, IrcLine().add(":").paint(CYAN, "This server was created today"));
+        sendReply(client, RPL_MYINFO, IrcLine().paint(CYAN, "ft_irc 1.0 io tkl")); // Supported modes
         
-        std::cout << BRIGHT_GREEN << "[SERVER] User registered: " << MAGENTA << user->getNickname() << RESET << std::endl;
+        LOG_INFO(BRIGHT_GREEN << "[SERVER] User registered: " << MAGENTA << user->getNickname() << RESET);
     }
 }
@@ -16,6 +16,7 @@
 #include <string>
 #include <vector>
 #include "../client/ClientConnection.hpp"
+#include "IrcLine.hpp"
 
 // Security definitions for numeric replies
 #ifndef RPL_CHANNELMODEIS
@@ -30,6 +31,7 @@
 
 // Helper function declarations
 void sendReply(ClientConnection* client, std::string num, std::string msg);
+void sendReply(ClientConnection* client, const std::string& num, const IrcLine& params);
 void sendError(ClientConnection* client, std::string num, std::string arg);
 std::vector<std::string> split(const std::string &s, char delimiter);
 void checkRegistration(ClientConnection* client);
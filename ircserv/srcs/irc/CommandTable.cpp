@@ -0,0 +1,134 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   CommandTable.cpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 17:10:52 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 17:10:52 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "CommandTable.hpp"
+#include <cstring>
+
+struct CommandEntry
+{
+	const char*	name;
+	size_t		length;
+	CommandId	id;
+};
+
+static const size_t TABLE_SIZE = 32;
+static const size_t MIN_LENGTH = 3;
+static const size_t MAX_LENGTH = 7;
+
+static const unsigned char ASSOC[26] =
+{
+	20,  0,  1,  0, 28,  0, 27, 24,  4,  7, 14, 26, 17,	//* A..M
+	31, 21,  6, 28,  2,  4, 16,  9,  0, 31,  0,  0,  0	//* N..Z
+};
+
+static const CommandEntry SLOTS[TABLE_SIZE] =
+{
+	{ "WHOIS",   5, CMD_WHOIS },
+	{ "OPER",    4, CMD_OPER },
+	{ "PASS",    4, CMD_PASS },
+	{ NULL,      0, CMD_UNKNOWN },
+	{ "KICK",    4, CMD_KICK },
+	{ "INVITE",  6, CMD_INVITE },
+	{ "MODE",    4, CMD_MODE },
+	{ NULL,      0, CMD_UNKNOWN },
+	{ NULL,      0, CMD_UNKNOWN },
+	{ "PING",    4, CMD_PING },
+	{ "PRIVMSG", 7, CMD_PRIVMSG },
+	{ "TOPIC",   5, CMD_TOPIC },
+	{ NULL,      0, CMD_UNKNOWN },
+	{ "LUSERS",  6, CMD_LUSERS },
+	{ "PART",    4, CMD_PART },
+	{ "WHO",     3, CMD_WHO },
+	{ NULL,      0, CMD_UNKNOWN },
+	{ NULL,      0, CMD_UNKNOWN },
+	{ NULL,      0, CMD_UNKNOWN },
+	{ "USER",    4, CMD_USER },
+	{ NULL,      0, CMD_UNKNOWN },
+	{ "NICK",    4, CMD_NICK },
+	{ "NOTICE",  6, CMD_NOTICE },
+	{ NULL,      0, CMD_UNKNOWN },
+	{ NULL,      0, CMD_UNKNOWN },
+	{ "QUIT",    4, CMD_QUIT },
+	{ "PONG",    4, CMD_PONG },
+	{ NULL,      0, CMD_UNKNOWN },
+	{ "NAMES",   5, CMD_NAMES },
+	{ "STATS",   5, CMD_STATS },
+	{ "CAP",     3, CMD_CAP },
+	{ "JOIN",    4, CMD_JOIN },
+};
+
+static inline char upper(char c)
+{
+	return (c >= 'a' && c <= 'z') ? c - ('a' - 'A') : c;
+}
+
+static inline unsigned int assoc(char c)
+{
+	c = upper(c);
+	return (c >= 'A' && c <= 'Z') ? ASSOC[c - 'A'] : 0;
+}
+
+CommandId lookupCommand(const char* name, size_t length)
+{
+	if (length < MIN_LENGTH || length > MAX_LENGTH)
+		return (CMD_UNKNOWN);
+
+	size_t slot = (length + assoc(name[0]) + assoc(name[1])
+				   + assoc(name[length - 1])) % TABLE_SIZE;
+	const CommandEntry& entry = SLOTS[slot];
+	if (entry.length != length)
+		return (CMD_UNKNOWN);
+	for (size_t i = 0; i < length; ++i)
+	{
+		if (upper(name[i]) != entry.name[i])
+			return (CMD_UNKNOWN);
+	}
+	return (entry.id);
+}
+
+const char* commandName(CommandId id)
+{
+	for (size_t i = 0; i < TABLE_SIZE; ++i)
+	{
+		if (SLOTS[i].id == id && SLOTS[i].name)
+			return (SLOTS[i].name);
+	}
+	return ("UNKNOWN");
+}
+
+//* Every named slot must be found again through the hash, and every id
+//* except CMD_UNKNOWN must own exactly one slot: catches a hand edit of
+//* ASSOC or SLOTS, or a CommandId the generator never saw.
+bool checkCommandTable()
+{
+	size_t seen[CMD_COUNT] = {};
+	for (size_t slot = 0; slot < TABLE_SIZE; ++slot)
+	{
+		const CommandEntry& entry = SLOTS[slot];
+		if (!entry.name)
+		{
+			if (entry.id != CMD_UNKNOWN)
+				return (false);
+			continue;
+		}
+		if (std::strlen(entry.name) != entry.length
+			|| lookupCommand(entry.name, entry.length) != entry.id)
+			return (false);
+		++seen[entry.id];
+	}
+	for (size_t id = CMD_UNKNOWN + 1; id < CMD_COUNT; ++id)
+	{
+		if (seen[id] != 1)
+			return (false);
+	}
+	return (true);
+}
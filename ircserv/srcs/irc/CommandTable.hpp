@@ -0,0 +1,67 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   CommandTable.hpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 17:10:52 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 17:10:52 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef COMMAND_TABLE_HPP
+#define COMMAND_TABLE_HPP
+
+#include <cstddef>
+
+/**
+ * CommandTable: Allocation-free, case-insensitive command name lookup
+ *
+ * Command names map to a CommandId through a perfect hash (gperf style):
+ *
+ *   slot = (len + ASSOC[c0] + ASSOC[c1] + ASSOC[c_last]) % TABLE_SIZE
+ *
+ * ASSOC weights letters case-insensitively and was chosen so that every
+ * known command lands in its own slot. One case-insensitive compare
+ * against that slot confirms the hit. No std::string, no toupper copy.
+ *
+ * Adding a command: add its CMD_<NAME> id before CMD_COUNT, then run
+ * `python3 tools/gen_command_table.py --write` from ircserv/ to search
+ * new ASSOC weights and rewrite SLOTS (seeded, so it is reproducible).
+ * checkCommandTable() runs at startup and refuses a table that no longer
+ * matches the enum or the hash.
+ */
+
+enum CommandId
+{
+	CMD_UNKNOWN = 0,
+	CMD_PASS,
+	CMD_NICK,
+	CMD_USER,
+	CMD_PING,
+	CMD_PONG,
+	CMD_QUIT,
+	CMD_JOIN,
+	CMD_PART,
+	CMD_PRIVMSG,
+	CMD_NOTICE,
+	CMD_NAMES,
+	CMD_WHO,
+	CMD_WHOIS,
+	CMD_KICK,
+	CMD_INVITE,
+	CMD_TOPIC,
+	CMD_MODE,
+	CMD_CAP,
+	CMD_OPER,
+	CMD_STATS,
+	CMD_LUSERS,
+	CMD_COUNT
+};
+
+CommandId	lookupCommand(const char* name, size_t length);
+const char*	commandName(CommandId id);
+bool		checkCommandTable();
+
+#endif
@@ -0,0 +1,155 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   IrcLine.cpp                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 19:40:12 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 19:40:12 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "IrcLine.hpp"
+#include "../server/EventLoop.hpp"
+#include "../utils/SharedBuffer.hpp"
+#include "../utils/Colors.hpp"
+
+IrcLine::Style IrcLine::_style = IrcLine::STYLE_COLOR;
+
+//* ============================================================================
+//* STYLE
+//* ============================================================================
+
+void IrcLine::setStyle(Style style)
+{
+	_style = style;
+}
+
+IrcLine::Style IrcLine::getStyle()
+{
+	return (_style);
+}
+
+//* ============================================================================
+//* BUILDER
+//* ============================================================================
+
+//* Most lines fit, so appends rarely reallocate
+IrcLine::IrcLine() : _colors(_style == STYLE_COLOR)
+{
+	_text.reserve(_colors ? 256 : 128);
+}
+
+IrcLine& IrcLine::add(const std::string& text)
+{
+	_text.append(text);
+	return (*this);
+}
+
+IrcLine& IrcLine::add(const StrView& text)
+{
+	_text.append(text.data(), text.size());
+	return (*this);
+}
+
+IrcLine& IrcLine::add(const char* text)
+{
+	_text.append(text);
+	return (*this);
+}
+
+IrcLine& IrcLine::add(char c)
+{
+	_text.push_back(c);
+	return (*this);
+}
+
+IrcLine& IrcLine::color(const char* code)
+{
+	if (_colors)
+		_text.append(code);
+	return (*this);
+}
+
+IrcLine& IrcLine::reset()
+{
+	return (color(RESET));
+}
+
+IrcLine& IrcLine::paint(const char* code, const std::string& text)
+{
+	return (color(code).add(text).reset());
+}
+
+IrcLine& IrcLine::paint(const char* code, const StrView& text)
+{
+	return (color(code).add(text).reset());
+}
+
+IrcLine& IrcLine::paint(const char* code, const char* text)
+{
+	return (color(code).add(text).reset());
+}
+
+IrcLine& IrcLine::source(const std::string& prefix)
+{
+	return (color(BRIGHT_CYAN).add(':').add(prefix).reset());
+}
+
+IrcLine& IrcLine::command(const char* name)
+{
+	return (add(' ').paint(BRIGHT_YELLOW, name));
+}
+
+IrcLine& IrcLine::end()
+{
+	_text.append("\r\n", 2);
+	return (*this);
+}
+
+const std::string& IrcLine::str() const
+{
+	return (_text);
+}
+
+//* ============================================================================
+//* TIMED LINE
+//* ============================================================================
+
+TimedLine::TimedLine(const IrcLine& body) : _body(body.str()), _tagged(NULL), _untagged(NULL)
+{
+}
+
+TimedLine::~TimedLine()
+{
+	if (_tagged)
+		_tagged->release();
+	if (_untagged)
+		_untagged->release();
+}
+
+//* Tags come from the calling loop's clock, read once per wakeup
+SharedBuffer* TimedLine::bufferFor(const ClientConnection* client)
+{
+	bool tagged = client->hasCapability(ClientConnection::CAP_SERVER_TIME);
+	SharedBuffer*& slot = tagged ? _tagged : _untagged;
+	if (slot)
+		return (slot);
+
+	EventLoop* loop = EventLoop::current();
+	std::string line;
+	line.reserve(_body.size() + 48);
+	if (tagged)
+		line.append("@time=").append(loop->serverTime()).append(1, ' ');
+	else if (IrcLine::getStyle() == IrcLine::STYLE_COLOR)
+		line.append(BRIGHT_MAGENTA "@time=").append(loop->timestamp()).append(RESET " ");
+	line.append(_body);
+	slot = SharedBuffer::create(line);
+	return (slot);
+}
+
+void TimedLine::sendTo(ClientConnection* client, ClientConnection::OutputPriority priority)
+{
+	client->queueShared(bufferFor(client), priority);
+}
@@ -0,0 +1,106 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   IrcLine.hpp                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 19:40:12 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 19:40:12 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef IRC_LINE_HPP
+#define IRC_LINE_HPP
+
+#include <string>
+#include <cstddef>
+#include "../utils/StrView.hpp"
+#include "../client/ClientConnection.hpp"
+
+class SharedBuffer;
+
+/**
+ * IrcLine: Builder for one outgoing protocol line
+ *
+ * The output style (--format) is fixed at startup: STYLE_COLOR keeps the
+ * ANSI-colored lines this server always sent, STYLE_RFC emits plain
+ * RFC 1459/2812 text. A line reads the style once when it's created and
+ * every color() / paint() after that is either an append or nothing, so
+ * a handler writes each reply once for both styles. Fragments go straight
+ * into one reserved string instead of a chain of operator+ temporaries.
+ *
+ * Usage:
+ *   IrcLine line;
+ *   line.source(prefix).command("JOIN").add(' ').paint(CYAN, chan).end();
+ *   client->queueSend(line.str());
+ */
+
+class IrcLine
+{
+	public:
+		enum Style
+		{
+			STYLE_COLOR,							//* ANSI colors in every line (default)
+			STYLE_RFC								//* Plain protocol text
+		};
+
+		static void		setStyle(Style style);		//* At startup, before the loops run
+		static Style	getStyle();
+
+		IrcLine();
+
+		IrcLine&	add(const std::string& text);
+		IrcLine&	add(const StrView& text);
+		IrcLine&	add(const char* text);
+		IrcLine&	add(char c);
+		IrcLine&	color(const char* code);		//* Skipped in STYLE_RFC
+		IrcLine&	reset();						//* RESET, skipped in STYLE_RFC
+		IrcLine&	paint(const char* code, const std::string& text);	//* Colored span
+		IrcLine&	paint(const char* code, const StrView& text);
+		IrcLine&	paint(const char* code, const char* text);
+
+		//* Shapes shared by every event line
+		IrcLine&	source(const std::string& prefix);	//* ":nick!user@host"
+		IrcLine&	command(const char* name);			//* " NAME"
+		IrcLine&	end();								//* "\r\n"
+
+		const std::string&	str() const;
+
+	private:
+		std::string	_text;
+		bool		_colors;
+
+		static Style	_style;
+};
+
+/**
+ * TimedLine: An event line ("JOIN", "PRIVMSG"...) as each recipient sees it
+ *
+ * Clients that negotiated the IRCv3 server-time capability get the line
+ * behind an "@time=<ISO 8601>" tag. Everybody else gets it untagged in
+ * STYLE_RFC, or behind the legacy colored "@time=HH:MM:SS" in STYLE_COLOR.
+ * Each variant is serialized at most once, on first use, and then shared
+ * by every recipient of that kind (see SharedBuffer).
+ */
+
+class TimedLine
+{
+	public:
+		explicit TimedLine(const IrcLine& body);	//* Body must outlive this
+		~TimedLine();
+
+		SharedBuffer*	bufferFor(const ClientConnection* client);	//* Borrowed reference
+		void	sendTo(ClientConnection* client,
+					ClientConnection::OutputPriority priority = ClientConnection::OUTPUT_NORMAL);
+
+	private:
+		const std::string&	_body;
+		SharedBuffer*		_tagged;				//* server-time negotiated
+		SharedBuffer*		_untagged;				//* Everyone else
+
+		TimedLine(const TimedLine&);
+		TimedLine& operator=(const TimedLine&);
+};
+
+#endif
@@ -15,6 +15,7 @@
 
 #include <string>
 #include <vector>
+#include "../utils/StrView.hpp"
 
 struct Message {
     std::string prefix;      // Optional (e.g.: :nick!user@host)
@@ -25,4 +26,40 @@ struct Message {
     bool isValid() const { return !command.empty(); }
 };
 
+/**
+ * Non-owning parse result: every field is a span into the raw line, and the
+ * parameters live in a fixed inline array (RFC 1459 allows at most 15), so
+ * parsing a line allocates nothing. Handlers read it directly and convert a
+ * field to std::string only when they keep it past the call.
+ */
+struct MessageView {
+    static const size_t MAX_PARAMS = 15;
+
+    struct Params {
+        StrView items[MAX_PARAMS];
+        size_t count;
+
+        Params() : count(0) {}
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+        const StrView& operator[](size_t i) const { return items[i]; }
+    };
+
+    StrView prefix;          // Without the leading ':'
+    StrView command;         // As sent by the client (not upper-cased)
+    Params params;
+
+    bool isValid() const { return !command.empty(); }
+
+    // Owning copy, for the rare caller that must keep the whole message
+    Message toMessage() const {
+        Message msg;
+        msg.prefix = prefix;
+        msg.command = command;
+        for (size_t i = 0; i < params.size(); ++i)
+            msg.params.push_back(params[i]);
+        return msg;
+    }
+};
+
 #endif
@@ -26,6 +26,19 @@
 // Server Ops
 #define RPL_YOUREOPER       "381"
 
+// Server Statistics (STATS, LUSERS)
+#define RPL_STATSCOMMANDS   "212" // <command> <count> <bytes> <remote count>
+#define RPL_ENDOFSTATS      "219" // <stats letter> :End of STATS report
+#define RPL_STATSUPTIME     "242"
+#define RPL_STATSDEBUG      "249" // Free-form counters (ircu/hybrid)
+#define RPL_LUSERCLIENT     "251"
+#define RPL_LUSEROP         "252"
+#define RPL_LUSERUNKNOWN    "253"
+#define RPL_LUSERCHANNELS   "254"
+#define RPL_LUSERME         "255"
+#define RPL_LOCALUSERS      "265"
+#define RPL_GLOBALUSERS     "266"
+
 // Channel Info
 #define RPL_CHANNELMODEIS   "324" // <channel> <modes> <mode-params>
 #define RPL_CREATIONTIME    "329" // <channel> <creationtime>
@@ -62,6 +75,7 @@
 #define ERR_CANNOTSENDTOCHAN    "404"
 #define ERR_TOOMANYCHANNELS     "405"
 #define ERR_NOORIGIN            "409"
+#define ERR_INVALIDCAPCMD       "410" // IRCv3 CAP
 #define ERR_NORECIPIENT         "411"
 #define ERR_NOTEXTTOSEND        "412"
 #define ERR_UNKNOWNCOMMAND      "421"
@@ -91,6 +105,7 @@
 // Permissions
 #define ERR_NOPRIVILEGES        "481"
 #define ERR_CHANOPRIVSNEEDED    "482"
+#define ERR_NOOPERHOST          "491"
 
 // Mode specific
 #define ERR_UMODEUNKNOWNFLAG    "501"
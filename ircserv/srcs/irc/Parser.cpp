@@ -11,84 +11,81 @@
 /* ************************************************************************** */
 
 #include "Parser.hpp"
-#include <iostream>
-#include <algorithm> // for transform
+#include <cctype>
 
-std::string Parser::trim(const std::string& str) {
-    std::string result = str;
-    // Remove \r and \n from the end (common in IRC)
-    size_t end = result.find_last_not_of("\r\n");
-    if (end != std::string::npos)
-        result = result.substr(0, end + 1);
-    else
-        return ""; // Empty string or only line breaks
-    return result;
-}
-
-std::string Parser::toUpper(const std::string& str) {
+std::string Parser::toUpper(const StrView& str) {
     std::string upper = str;
     for (size_t i = 0; i < upper.length(); ++i)
         upper[i] = std::toupper(upper[i]);
     return upper;
 }
 
+// Owning parse, built on the view parser (command is upper-cased here)
 Message Parser::parse(const std::string& rawLine) {
-    Message msg;
-    
-    // 1. Basic cleanup
-    std::string line = trim(rawLine);
-    if (line.empty()) return msg;
+    MessageView view;
+    if (!parse(rawLine.data(), rawLine.size(), view))
+        return Message();
+    Message msg = view.toMessage();
+    msg.command = toUpper(view.command);
+    return msg;
+}
+
+// Walks the line once; no substr, no allocation. Returns false when there
+// is no command (blank line, only spaces, or only a prefix).
+bool Parser::parse(const char* line, size_t length, MessageView& msg) {
+    msg = MessageView();
+
+    // 1. Basic cleanup: drop trailing \r and \n (common in IRC)
+    while (length > 0 && (line[length - 1] == '\r' || line[length - 1] == '\n'))
+        --length;
 
     size_t pos = 0;
-    size_t len = line.length();
 
     // 2. Parse Prefix (Optional)
     // The prefix starts with ':' but only if it's the FIRST character of the line
-    if (pos < len && line[pos] == ':') {
-        size_t spacePos = line.find(' ', pos);
-        if (spacePos != std::string::npos) {
-            msg.prefix = line.substr(pos + 1, spacePos - pos - 1); // +1 to skip the ':'
-            pos = line.find_first_not_of(' ', spacePos); // Skip spaces
-        } else {
-            // Rare case: Line only contains ":something" (invalid but shouldn't crash)
-            return msg; 
-        }
+    if (pos < length && line[pos] == ':') {
+        size_t end = pos;
+        while (end < length && line[end] != ' ')
+            ++end;
+        // Rare case: Line only contains ":something" (invalid but shouldn't crash)
+        if (end == length)
+            return false;
+        msg.prefix = StrView(line + pos + 1, end - pos - 1); // +1 to skip the ':'
+        pos = end;
     }
-
-    // If we reach the end with only prefix, return
-    if (pos == std::string::npos || pos >= len) return msg;
+    while (pos < length && line[pos] == ' ')
+        ++pos;
+    if (pos >= length)
+        return false;
 
     // 3. Parse Command
-    size_t spacePos = line.find(' ', pos);
-    if (spacePos != std::string::npos) {
-        msg.command = toUpper(line.substr(pos, spacePos - pos));
-        pos = line.find_first_not_of(' ', spacePos);
-    } else {
-        // Case: Command without parameters (e.g.: "QUIT")
-        msg.command = toUpper(line.substr(pos));
-        return msg;
-    }
+    size_t end = pos;
+    while (end < length && line[end] != ' ')
+        ++end;
+    msg.command = StrView(line + pos, end - pos);
+    pos = end;
 
     // 4. Parse Parameters
-    while (pos != std::string::npos && pos < len) {
-        // Check Trailing Parameter (starts with ':')
-        if (line[pos] == ':') {
-            // Take ALL the rest of the line as is (without the ':')
-            msg.params.push_back(line.substr(pos + 1));
-            break; // No more parameters after the trailing
-        }
-        
-        // Normal parameter (separated by space)
-        spacePos = line.find(' ', pos);
-        if (spacePos != std::string::npos) {
-            msg.params.push_back(line.substr(pos, spacePos - pos));
-            pos = line.find_first_not_of(' ', spacePos);
-        } else {
-            // Last parameter (without previous ':')
-            msg.params.push_back(line.substr(pos));
+    while (true) {
+        while (pos < length && line[pos] == ' ')
+            ++pos;
+        if (pos >= length)
+            break;
+
+        // Trailing parameter (starts with ':'), or the 15th one: rest of the line as is
+        if (line[pos] == ':' || msg.params.count == MessageView::MAX_PARAMS - 1) {
+            if (line[pos] == ':')
+                ++pos;
+            msg.params.items[msg.params.count++] = StrView(line + pos, length - pos);
             break;
         }
-    }
 
-    return msg;
+        // Normal parameter (separated by space)
+        end = pos;
+        while (end < length && line[end] != ' ')
+            ++end;
+        msg.params.items[msg.params.count++] = StrView(line + pos, end - pos);
+        pos = end;
+    }
+    return true;
 }
@@ -20,10 +20,11 @@ class Parser {
     public:
         // Static method: receives raw string, returns clean structure
         static Message parse(const std::string& rawLine);
+        // Zero-copy variant: fills 'msg' with spans into [line, line + length)
+        static bool parse(const char* line, size_t length, MessageView& msg);
+        static std::string toUpper(const StrView& str);
     private:
         Parser(); // Not instantiable
-        static std::string trim(const std::string& str);
-        static std::string toUpper(const std::string& str);
 };
 
 #endif
@@ -16,8 +16,12 @@
 #include "../channel/Channel.hpp"
 #include "CommandHelpers.hpp"
 #include "../irc/NumericReplies.hpp"
+#include "../irc/IrcLine.hpp"
 #include "../utils/Colors.hpp"
+#include "../utils/Log.hpp"
+#include "../utils/SharedBuffer.hpp"
 #include <set> // Required to avoid NICK spam
+#include <cctype>
 
 // ============================================================================
 // HELPER: Send informational NOTICE from server
@@ -30,15 +34,20 @@ static void sendServerNotice(ClientConnection* client, const std::string& msg)
     client->queueSend(notice);
 }
 
+static void sendServerNotice(ClientConnection* client, const IrcLine& msg)
+{
+    sendServerNotice(client, msg.str());
+}
+
 // ============================================================================
 // AUTHENTICATION COMMANDS WITH FEEDBACK
 // ============================================================================
 
-void Server::cmdPass(ClientConnection* client, const Message& msg)
+void Server::cmdPass(ClientConnection* client, const MessageView& msg)
 {
     if (msg.params.empty()) 
     {
-        sendServerNotice(client, std::string(CYAN) + "*** Syntax: PASS <password>" + RESET);
+        sendServerNotice(client, IrcLine().paint(CYAN, "*** Syntax: PASS <password>"));
         return sendError(client, ERR_NEEDMOREPARAMS, "PASS");
     }
     
@@ -52,46 +61,45 @@ void Server::cmdPass(ClientConnection* client, const Message& msg)
     {
         // ❌ INCORRECT PASSWORD
         sendServerNotice(client, "");
-        sendServerNotice(client, std::string(BRIGHT_RED) + "╔════════════════════════════════════════════════╗" + RESET);
-        sendServerNotice(client, std::string(BRIGHT_RED) + "║                                                ║" + RESET);
-        sendServerNotice(client, std::string(BRIGHT_RED) + "║  ✗  AUTHENTICATION FAILED                      ║" + RESET);
-        sendServerNotice(client, std::string(BRIGHT_RED) + "║                                                ║" + RESET);
-        sendServerNotice(client, std::string(BRIGHT_RED) + "║  Password incorrect.                           ║" + RESET);
-        sendServerNotice(client, std::string(BRIGHT_RED) + "║  Connection will be closed.                    ║" + RESET);
-        sendServerNotice(client, std::string(BRIGHT_RED) + "║                                                ║" + RESET);
-        sendServerNotice(client, std::string(BRIGHT_RED) + "╚════════════════════════════════════════════════╝" + RESET);
+        sendServerNotice(client, IrcLine().paint(BRIGHT_RED, "╔════════════════════════════════════════════════╗"));
+        sendServerNotice(client, IrcLine().paint(BRIGHT_RED, "║                                                ║"));
+        sendServerNotice(client, IrcLine().paint(BRIGHT_RED, "║  ✗  AUTHENTICATION FAILED                      ║"));
+        sendServerNotice(client, IrcLine().paint(BRIGHT_RED, "║                                                ║"));
+        sendServerNotice(client, IrcLine().paint(BRIGHT_RED, "║  Password incorrect.                           ║"));
+        sendServerNotice(client, IrcLine().paint(BRIGHT_RED, "║  Connection will be closed.                    ║"));
+        sendServerNotice(client, IrcLine().paint(BRIGHT_RED, "║                                                ║"));
+        sendServerNotice(client, IrcLine().paint(BRIGHT_RED, "╚════════════════════════════════════════════════╝"));
         sendServerNotice(client, "");
         sendError(client, ERR_PASSWDMISMATCH, "");
-        sendPendingData(client);
         // Server log
-        std::cout << RED << "[AUTH] ✗ Password incorrect (fd=" 
-            << client->getFd() << ")" << RESET << std::endl;
+        LOG_WARN(RED << "[AUTH] ✗ Password incorrect (fd=" 
+            << client->getFd() << ")" << RESET);
         client->closeConnection();
         return;
     }
 
     // Password accepted
     client->markPassReceived();
-    std::cout << BRIGHT_GREEN << "[AUTH] ✓ Password accepted (fd=" 
-            << client->getFd() << ")" << RESET << std::endl;
+    LOG_INFO(BRIGHT_GREEN << "[AUTH] ✓ Password accepted (fd=" 
+            << client->getFd() << ")" << RESET);
     sendServerNotice(client, "");
-    sendServerNotice(client, std::string(BRIGHT_GREEN) + "╔════════════════════════════════════════════════╗" + RESET);
-    sendServerNotice(client, std::string(BRIGHT_GREEN) + "║                                                ║" + RESET);
-    sendServerNotice(client, std::string(BRIGHT_GREEN) + "║  ✓  PASSWORD ACCEPTED                          ║" + RESET);
-    sendServerNotice(client, std::string(BRIGHT_GREEN) + "║                                                ║" + RESET);
-    sendServerNotice(client, std::string(BRIGHT_GREEN) + "╚════════════════════════════════════════════════╝" + RESET);
+    sendServerNotice(client, IrcLine().paint(BRIGHT_GREEN, "╔════════════════════════════════════════════════╗"));
+    sendServerNotice(client, IrcLine().paint(BRIGHT_GREEN, "║                                                ║"));
+    sendServerNotice(client, IrcLine().paint(BRIGHT_GREEN, "║  ✓  PASSWORD ACCEPTED                          ║"));
+    sendServerNotice(client, IrcLine().paint(BRIGHT_GREEN, "║                                                ║"));
+    sendServerNotice(client, IrcLine().paint(BRIGHT_GREEN, "╚════════════════════════════════════════════════╝"));
     sendServerNotice(client, "");
-    sendServerNotice(client, std::string(BRIGHT_GREEN) + "*** Password accepted. Please identify yourself:" + RESET);
-    sendServerNotice(client, std::string(CYAN) + "*** Use: NICK <your_nickname>" + RESET);
-    sendServerNotice(client, std::string(CYAN) + "*** Then: USER <username> 0 * :<realname>" + RESET);
+    sendServerNotice(client, IrcLine().paint(BRIGHT_GREEN, "*** Password accepted. Please identify yourself:"));
+    sendServerNotice(client, IrcLine().paint(CYAN, "*** Use: NICK <your_nickname>"));
+    sendServerNotice(client, IrcLine().paint(CYAN, "*** Then: USER <username> 0 * :<realname>"));
     sendServerNotice(client, "");
 }
 
-void Server::cmdNick(ClientConnection* client, const Message& msg)
+void Server::cmdNick(ClientConnection* client, const MessageView& msg)
 {
     if (msg.params.empty())
     {
-        sendServerNotice(client, std::string(CYAN) + "*** Syntax: NICK <nickname>" + RESET);
+        sendServerNotice(client, IrcLine().paint(CYAN, "*** Syntax: NICK <nickname>"));
         return sendError(client, ERR_NONICKNAMEGIVEN, "");
     }
 
@@ -100,32 +108,30 @@ void Server::cmdNick(ClientConnection* client, const Message& msg)
     // Check maximum length (9 characters)
     if (newNick.length() > 9)
     {
-        sendServerNotice(client, std::string(BRIGHT_RED) + "* ERROR: Nickname too long (max 9 chars)" + RESET);
+        sendServerNotice(client, IrcLine().paint(BRIGHT_RED, "* ERROR: Nickname too long (max 9 chars)"));
         return sendError(client, ERR_ERRONEUSNICKNAME, newNick);
     }
 
     // Check that it doesn't start with digit or '-'
     if (std::isdigit(newNick[0]) || newNick[0] == '-')
     {
-        sendServerNotice(client, std::string(BRIGHT_RED) + "*** ERROR: Nickname cannot start with a digit or '-'" + RESET);
+        sendServerNotice(client, IrcLine().paint(BRIGHT_RED, "*** ERROR: Nickname cannot start with a digit or '-'"));
         return sendError(client, ERR_ERRONEUSNICKNAME, newNick);
     }
 
     // Allowed characters (RFC 2812)
     if (newNick.find_first_not_of("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789[]{}\\|-_^") != std::string::npos)
     {
-        sendServerNotice(client, std::string(BRIGHT_RED) + "*** ERROR: Invalid nickname. Use only letters, numbers, and -_[]{}\\|^" + RESET);
+        sendServerNotice(client, IrcLine().paint(BRIGHT_RED, "*** ERROR: Invalid nickname. Use only letters, numbers, and -_[]{}\\|^"));
         return sendError(client, ERR_ERRONEUSNICKNAME, newNick);
     }
 
-    // Check if nickname already exists on server
-    for (size_t i = 0; i < clients_.size(); ++i)
+    // Check if nickname already exists on server (case-insensitive, RFC 1459)
+    User* holder = findUserByNick(newNick);
+    if (holder && holder != client->getUser())
     {
-        if (clients_[i] != client && clients_[i]->getUser() && clients_[i]->getUser()->getNickname() == newNick)
-        {
-            sendServerNotice(client, std::string(BRIGHT_RED) + "*** ERROR: Nickname '" + newNick + "' is already in use. Try another." + RESET);
-            return sendError(client, ERR_NICKNAMEINUSE, newNick);
-        }
+        sendServerNotice(client, IrcLine().color(BRIGHT_RED).add("*** ERROR: Nickname '").add(newNick).add("' is already in use. Try another.").reset());
+        return sendError(client, ERR_NICKNAMEINUSE, newNick);
     }
 
     // Notify change (if already registered)
@@ -152,45 +158,47 @@ void Server::cmdNick(ClientConnection* client, const Message& msg)
             }
         }
 
+        SharedBuffer* shared = SharedBuffer::create(notification);
         for (std::set<ClientConnection*>::iterator it = uniqueRecipients.begin(); it != uniqueRecipients.end(); ++it)
         {
-            (*it)->queueSend(notification);
+            (*it)->queueShared(shared);
         }
+        shared->release();
         
-        sendServerNotice(client, std::string(BRIGHT_GREEN) + "*** Nickname changed to: " + MAGENTA + newNick + RESET);
+        sendServerNotice(client, IrcLine().color(BRIGHT_GREEN).add("*** Nickname changed to: ").paint(MAGENTA, newNick));
     }
     else if (!client->hasSentPass())
     {
-        sendServerNotice(client, std::string(YELLOW) + "*** Please authenticate first with: PASS <password>" + RESET);
+        sendServerNotice(client, IrcLine().paint(YELLOW, "*** Please authenticate first with: PASS <password>"));
     }
     else
     {
-        sendServerNotice(client, std::string(BRIGHT_GREEN) + "*** Nickname set to: " + MAGENTA + newNick + RESET);
-        sendServerNotice(client, std::string(CYAN) + "*** Next step: USER <username> 0 * :<realname>" + RESET);
+        sendServerNotice(client, IrcLine().color(BRIGHT_GREEN).add("*** Nickname set to: ").paint(MAGENTA, newNick));
+        sendServerNotice(client, IrcLine().paint(CYAN, "*** Next step: USER <username> 0 * :<realname>"));
     }
 
-    // Apply the change
-    client->getUser()->setNickname(newNick);
+    // Apply the change (keeps the nickname index in sync)
+    setUserNick(client->getUser(), newNick);
     checkRegistration(client);
 }
 
-void Server::cmdUser(ClientConnection* client, const Message& msg)
+void Server::cmdUser(ClientConnection* client, const MessageView& msg)
 {
     if (client->isRegistered())
     {
-        sendServerNotice(client, std::string(YELLOW) + "*** You are already registered" + RESET);
+        sendServerNotice(client, IrcLine().paint(YELLOW, "*** You are already registered"));
         return sendError(client, ERR_ALREADYREGISTRED, "");
     }
 
     if (msg.params.size() < 4)
     {
-        sendServerNotice(client, std::string(CYAN) + "*** Syntax: USER <username> 0 * :<realname>" + RESET);
+        sendServerNotice(client, IrcLine().paint(CYAN, "*** Syntax: USER <username> 0 * :<realname>"));
         return sendError(client, ERR_NEEDMOREPARAMS, "USER");
     }
 
     if (!client->hasSentPass())
     {
-        sendServerNotice(client, std::string(YELLOW) + "*** Please authenticate first with: PASS <password>" + RESET);
+        sendServerNotice(client, IrcLine().paint(YELLOW, "*** Please authenticate first with: PASS <password>"));
         return;
     }
 
@@ -200,59 +208,59 @@ void Server::cmdUser(ClientConnection* client, const Message& msg)
     
     // Welcome message
     sendServerNotice(client, "");
-    sendServerNotice(client, std::string(BRIGHT_GREEN) + "╔════════════════════════════════════════════════════════════╗" + RESET);
-    sendServerNotice(client, std::string(BRIGHT_GREEN) + "║                                                            ║" + RESET);
-    sendServerNotice(client, std::string(BRIGHT_GREEN) + "║  ✓  REGISTRATION COMPLETE!                                 ║" + RESET);
-    sendServerNotice(client, std::string(BRIGHT_GREEN) + "║                                                            ║" + RESET);
-    sendServerNotice(client, std::string(BRIGHT_GREEN) + "╚════════════════════════════════════════════════════════════╝" + RESET);
+    sendServerNotice(client, IrcLine().paint(BRIGHT_GREEN, "╔════════════════════════════════════════════════════════════╗"));
+    sendServerNotice(client, IrcLine().paint(BRIGHT_GREEN, "║                                                            ║"));
+    sendServerNotice(client, IrcLine().paint(BRIGHT_GREEN, "║  ✓  REGISTRATION COMPLETE!                                 ║"));
+    sendServerNotice(client, IrcLine().paint(BRIGHT_GREEN, "║                                                            ║"));
+    sendServerNotice(client, IrcLine().paint(BRIGHT_GREEN, "╚════════════════════════════════════════════════════════════╝"));
     sendServerNotice(client, "");
-    sendServerNotice(client, std::string(BRIGHT_CYAN) + "    Welcome to ft_irc, " + BRIGHT_MAGENTA + user->getNickname() + BRIGHT_CYAN + "!" + RESET);
+    sendServerNotice(client, IrcLine().color(BRIGHT_CYAN).add("    Welcome to ft_irc, ").color(BRIGHT_MAGENTA).add(user->getNickname()).paint(BRIGHT_CYAN, "!"));
     sendServerNotice(client, "");
-    sendServerNotice(client, std::string(CYAN) + "    Your identity:" + RESET);
-    sendServerNotice(client, std::string(CYAN) + "      • Nickname : " + BRIGHT_MAGENTA + user->getNickname() + RESET);
-    sendServerNotice(client, std::string(CYAN) + "      • Username : " + YELLOW + user->getUsername() + RESET);
-    sendServerNotice(client, std::string(CYAN) + "      • Realname : " + YELLOW + user->getRealname() + RESET);
+    sendServerNotice(client, IrcLine().paint(CYAN, "    Your identity:"));
+    sendServerNotice(client, IrcLine().color(CYAN).add("      • Nickname : ").paint(BRIGHT_MAGENTA, user->getNickname()));
+    sendServerNotice(client, IrcLine().color(CYAN).add("      • Username : ").paint(YELLOW, user->getUsername()));
+    sendServerNotice(client, IrcLine().color(CYAN).add("      • Realname : ").paint(YELLOW, user->getRealname()));
     sendServerNotice(client, "");
-    sendServerNotice(client, std::string(BRIGHT_YELLOW) + "    ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" + RESET);
+    sendServerNotice(client, IrcLine().paint(BRIGHT_YELLOW, "    ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━"));
     sendServerNotice(client, "");
-    sendServerNotice(client, std::string(BRIGHT_WHITE) + "    Available commands:" + RESET);
+    sendServerNotice(client, IrcLine().paint(BRIGHT_WHITE, "    Available commands:"));
     sendServerNotice(client, "");
-    sendServerNotice(client, std::string(CYAN) + "      📢  JOIN #channel        " + RESET + "→ Join a channel");
-    sendServerNotice(client, std::string(CYAN) + "      💬  PRIVMSG #chan :msg   " + RESET + "→ Send message to channel");
-    sendServerNotice(client, std::string(CYAN) + "      💬  PRIVMSG nick :msg    " + RESET + "→ Send private message");
-    sendServerNotice(client, std::string(CYAN) + "      🚪  PART #channel        " + RESET + "→ Leave a channel");
-    sendServerNotice(client, std::string(CYAN) + "      📝  TOPIC #chan :topic   " + RESET + "→ Change channel topic");
-    sendServerNotice(client, std::string(CYAN) + "      ⚙️   MODE #chan +o nick   " + RESET + "→ Give operator status");
-    sendServerNotice(client, std::string(CYAN) + "      👢  KICK #chan nick      " + RESET + "→ Kick user from channel");
-    sendServerNotice(client, std::string(CYAN) + "      📨  INVITE nick #chan    " + RESET + "→ Invite user to channel");
-    sendServerNotice(client, std::string(CYAN) + "      👋  QUIT :reason         " + RESET + "→ Disconnect from server");
+    sendServerNotice(client, IrcLine().paint(CYAN, "      📢  JOIN #channel        ").add("→ Join a channel"));
+    sendServerNotice(client, IrcLine().paint(CYAN, "      💬  PRIVMSG #chan :msg   ").add("→ Send message to channel"));
+    sendServerNotice(client, IrcLine().paint(CYAN, "      💬  PRIVMSG nick :msg    ").add("→ Send private message"));
+    sendServerNotice(client, IrcLine().paint(CYAN, "      🚪  PART #channel        ").add("→ Leave a channel"));
+    sendServerNotice(client, IrcLine().paint(CYAN, "      📝  TOPIC #chan :topic   ").add("→ Change channel topic"));
+    sendServerNotice(client, IrcLine().paint(CYAN, "      ⚙️   MODE #chan +o nick   ").add("→ Give operator status"));
+    sendServerNotice(client, IrcLine().paint(CYAN, "      👢  KICK #chan nick      ").add("→ Kick user from channel"));
+    sendServerNotice(client, IrcLine().paint(CYAN, "      📨  INVITE nick #chan    ").add("→ Invite user to channel"));
+    sendServerNotice(client, IrcLine().paint(CYAN, "      👋  QUIT :reason         ").add("→ Disconnect from server"));
     sendServerNotice(client, "");
-    sendServerNotice(client, std::string(BRIGHT_YELLOW) + "    ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" + RESET);
+    sendServerNotice(client, IrcLine().paint(BRIGHT_YELLOW, "    ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━"));
     sendServerNotice(client, "");
-    sendServerNotice(client, std::string(BRIGHT_GREEN) + "    Type " + BRIGHT_WHITE + "JOIN #general" + BRIGHT_GREEN + " to get started!" + RESET);
+    sendServerNotice(client, IrcLine().color(BRIGHT_GREEN).add("    Type ").color(BRIGHT_WHITE).add("JOIN #general").paint(BRIGHT_GREEN, " to get started!"));
     sendServerNotice(client, "");
     
     // Server log
-    std::cout << BRIGHT_GREEN << "[REGISTER] ✓ User registered: " 
+    LOG_INFO(BRIGHT_GREEN << "[REGISTER] ✓ User registered: " 
             << BRIGHT_MAGENTA << user->getNickname() 
             << RESET << " (" << user->getUsername() << ")" 
-            << " (fd=" << client->getFd() << ")" << RESET << std::endl;
+            << " (fd=" << client->getFd() << ")" << RESET);
     
     checkRegistration(client);
 }
 
-void Server::cmdQuit(ClientConnection* client, const Message& msg)
+void Server::cmdQuit(ClientConnection* client, const MessageView& msg)
 {
-    std::string reason = (msg.params.empty()) ? "Client Quit" : msg.params[0];
+    std::string reason = (msg.params.empty()) ? "Client Quit" : msg.params[0].str();
     
     // Disconnection and channel cleanup logic is handled in the main loop (Server::run)
     // when detecting that the connection is closed.
-    // Just mark for closing.
-    (void)reason; 
+    // Just mark for closing; the reason goes out with the QUIT broadcast.
+    client->setQuitReason(reason);
     client->closeConnection();
 }
 
-void Server::cmdPing(ClientConnection* client, const Message& msg)
+void Server::cmdPing(ClientConnection* client, const MessageView& msg)
 {
     // PING can have 1 or 2 parameters:
     // PING token1
@@ -267,16 +275,126 @@ void Server::cmdPing(ClientConnection* client, const Message& msg)
     client->queueSend(":ft_irc PONG ft_irc :" + token + "\r\n");
 }
 
-void Server::cmdPong(ClientConnection* client, const Message& msg)
+void Server::cmdPong(ClientConnection* client, const MessageView& msg)
 {
     // PONG is received when the client responds to our PING
     // RFC 1459: Used to keep the connection alive and as a response to PING
     (void)msg;
     
-    // Update activity timestamp to indicate that the client is alive
-    client->updateActivity();
+    // Reading the line already counted as activity, which is what the
+    // keepalive timer checks
     
-    std::cout << GREEN << "[PING/PONG] Client (fd=" << client->getFd() 
-            << ") sent PONG - connection alive" << RESET << std::endl;
+    LOG_DEBUG(GREEN << "[PING/PONG] Client (fd=" << client->getFd() 
+            << ") sent PONG - connection alive" << RESET);
+}
+
+// ============================================================================
+// CAPABILITY NEGOTIATION (IRCv3)
+// ============================================================================
+
+// Only server-time: "@time=" tags on event lines, see TimedLine
+static const char* const SUPPORTED_CAPS = "server-time";
+
+static bool setCapabilities(ClientConnection* client, const std::string& list, bool apply)
+{
+    std::vector<std::string> caps = split(list, ' ');
+    for (size_t i = 0; i < caps.size(); ++i)
+    {
+        bool enable = caps[i][0] != '-';
+        std::string name = enable ? caps[i] : caps[i].substr(1);
+        if (name != SUPPORTED_CAPS)
+            return false;
+        if (apply)
+            client->setCapability(ClientConnection::CAP_SERVER_TIME, enable);
+    }
+    return !caps.empty();
 }
 
+void Server::cmdCap(ClientConnection* client, const MessageView& msg)
+{
+    if (msg.params.empty())
+        return sendError(client, ERR_NEEDMOREPARAMS, "CAP");
+
+    std::string sub = msg.params[0];
+    for (size_t i = 0; i < sub.length(); ++i)
+        sub[i] = std::toupper(static_cast<unsigned char>(sub[i]));
+
+    const std::string& nick = client->getUser()->getNickname();
+    std::string reply = ":ft_irc CAP " + (nick.empty() ? std::string("*") : nick) + " ";
+
+    if (sub == "LS")
+    {
+        // Registration waits for CAP END once the client asked
+        if (!client->isRegistered())
+            client->setNegotiating(true);
+        client->queueSend(reply + "LS :" + SUPPORTED_CAPS + "\r\n");
+    }
+    else if (sub == "LIST")
+    {
+        std::string enabled;
+        if (client->hasCapability(ClientConnection::CAP_SERVER_TIME))
+            enabled = SUPPORTED_CAPS;
+        client->queueSend(reply + "LIST :" + enabled + "\r\n");
+    }
+    else if (sub == "REQ")
+    {
+        if (msg.params.size() < 2)
+            return sendError(client, ERR_NEEDMOREPARAMS, "CAP");
+        if (!client->isRegistered())
+            client->setNegotiating(true);
+
+        // All or nothing: the whole list is rejected if one cap is unknown
+        std::string list = msg.params[1];
+        bool ok = setCapabilities(client, list, false);
+        if (ok)
+            setCapabilities(client, list, true);
+        client->queueSend(reply + (ok ? "ACK :" : "NAK :") + list + "\r\n");
+    }
+    else if (sub == "END")
+    {
+        if (!client->isNegotiating())
+            return;
+        client->setNegotiating(false);
+        checkRegistration(client);
+    }
+    else
+        sendReply(client, ERR_INVALIDCAPCMD, sub + " :Invalid CAP command");
+}
+
+// ============================================================================
+// OPER: server operator status (STATS, extended LUSERS)
+// ============================================================================
+
+// OPER <name> <password>. One shared password (--oper-password), the name
+// is only logged. Without it configured OPER is refused for everyone.
+void Server::cmdOper(ClientConnection* client, const MessageView& msg)
+{
+    if (!client->isRegistered())
+        return sendError(client, ERR_NOTREGISTERED, "");
+    if (msg.params.size() < 2)
+        return sendError(client, ERR_NEEDMOREPARAMS, "OPER");
+    if (config_.operPassword.empty())
+        return sendError(client, ERR_NOOPERHOST, "");
+
+    User* user = client->getUser();
+    if (msg.params[1] != config_.operPassword)
+    {
+        LOG_WARN(RED << "[AUTH] ✗ OPER failed for " << user->getNickname()
+            << " (name " << msg.params[0].str() << ")" << RESET);
+        return sendError(client, ERR_PASSWDMISMATCH, "");
+    }
+
+    if (!user->isOperator())
+    {
+        user->setOperator(true);
+        __sync_fetch_and_add(&stats_.operators, 1UL);
+    }
+    sendReply(client, RPL_YOUREOPER, IrcLine().add(":").paint(BRIGHT_GREEN, "You are now an IRC operator"));
+    IrcLine modeMsg;
+    modeMsg.source(user->getPrefix()).command("MODE").add(' ')
+        .add(user->getNickname()).add(" :").paint(BRIGHT_GREEN, "+o").end();
+    TimedLine modeLine(modeMsg);
+    modeLine.sendTo(client);
+    LOG_INFO(BRIGHT_GREEN << "[AUTH] " << user->getNickname() << " is now an operator (name "
+        << msg.params[0].str() << ")" << RESET);
+}
@@ -16,31 +16,61 @@
 #include "../channel/Channel.hpp"
 #include "CommandHelpers.hpp"
 #include "../irc/NumericReplies.hpp"
+#include "../irc/CaseMapping.hpp"
+#include "../irc/IrcLine.hpp"
 #include "../utils/Colors.hpp"
+#include "../utils/Clock.hpp"
 #include <sstream>
 
 // NOTE: These functions are Server members, but implemented here
 // to organize code by topic.
 
+// RPL_NAMREPLY for one channel ("=" = public), names appended in place
+static void sendNamesReply(ClientConnection* client, const Channel* channel, const std::string& name)
+{
+    IrcLine names;
+    names.add("= ").add(name).add(" :").color(GREEN);
+    channel->appendNamesList(names);
+    sendReply(client, RPL_NAMREPLY, names.reset());
+}
+
+// Channel names are case-insensitive (RFC 1459 casemapping): "#Dev" == "#dev"
 Channel* Server::getChannel(const std::string& name)
 {
-    for (size_t i = 0; i < channels_.size(); ++i)
-    {
-        if (channels_[i]->getName() == name)
-            return channels_[i];
-    }
-    return NULL;
+    const size_t* slot = channel_index_.find(ircCaseFold(name));
+    return slot ? channels_[*slot] : NULL;
 }
 
 Channel* Server::createChannel(const std::string& name)
 {
     Channel* newChan = new Channel(name);
     newChan->setMode('t', true); //-R- Added to ensure topic is protected by default (+t mode)
+    channel_index_.set(ircCaseFold(name), channels_.size());
     channels_.push_back(newChan);
+    __atomic_store_n(&stats_.channels, channels_.size(), __ATOMIC_RELAXED);
     return newChan;
 }
 
-void Server::cmdJoin(ClientConnection* client, const Message& msg)
+// Swap-and-pop: the last channel takes the freed slot, its index entry follows
+void Server::destroyChannel(Channel* channel)
+{
+    std::string key = ircCaseFold(channel->getName());
+    const size_t* found = channel_index_.find(key);
+    if (!found || channels_[*found] != channel)
+        return;
+
+    size_t slot = *found;
+    Channel* last = channels_.back();
+    channels_[slot] = last;
+    channels_.pop_back();
+    channel_index_.erase(key);
+    if (last != channel)
+        channel_index_.set(ircCaseFold(last->getName()), slot);
+    __atomic_store_n(&stats_.channels, channels_.size(), __ATOMIC_RELAXED);
+    delete channel;
+}
+
+void Server::cmdJoin(ClientConnection* client, const MessageView& msg)
 {
     // CRITICAL: Verify user is registered
     if (!client->isRegistered()) {
@@ -77,11 +107,11 @@ void Server::cmdJoin(ClientConnection* client, const Message& msg)
         if (invalidName) continue;
 
         Channel* channel = getChannel(chanName);
+        bool created = false;
         if (!channel)
         {
             channel = createChannel(chanName);
-            // Creator becomes Operator automatically
-            channel->addOperator(client->getUser());
+            created = true;
         }
 
         // If already inside, do nothing
@@ -109,30 +139,30 @@ void Server::cmdJoin(ClientConnection* client, const Message& msg)
         channel->addMember(client->getUser());
         client->getUser()->joinChannel(channel);
 
-        // Get timestamp
-        std::string timestamp = getCurrentTimestamp();
-        
+        // Creator becomes Operator automatically
+        if (created)
+            channel->addOperator(client->getUser());
+
         // Notify everyone in channel (including new user)
-        std::string joinMsg = std::string(BRIGHT_MAGENTA) + "@time=" + timestamp + RESET + " " +
-                                    BRIGHT_CYAN + ":" + client->getUser()->getPrefix() + RESET +
-                                    " " + BRIGHT_YELLOW + "JOIN" + RESET + " " +
-                                    CYAN + chanName + RESET + "\r\n";
-        channel->broadcast(joinMsg, NULL);
+        IrcLine joinMsg;
+        joinMsg.source(client->getUser()->getPrefix()).command("JOIN").add(' ')
+            .paint(CYAN, chanName).end();
+        TimedLine joinLine(joinMsg);
+        channel->broadcast(joinLine, NULL);
 
         // Send Topic
         if (channel->getTopic().empty())
-            sendReply(client, RPL_NOTOPIC, chanName + std::string(" :") + YELLOW + "No topic is set" + RESET);
+            sendReply(client, RPL_NOTOPIC, IrcLine().add(chanName).add(" :").paint(YELLOW, "No topic is set"));
         else
-            sendReply(client, RPL_TOPIC, chanName + std::string(" :") + CYAN + channel->getTopic() + RESET);
+            sendReply(client, RPL_TOPIC, IrcLine().add(chanName).add(" :").paint(CYAN, channel->getTopic()));
 
         // Send Names list (RPL_NAMREPLY)
-        std::string symbol = "="; // Public channel
-        sendReply(client, RPL_NAMREPLY, symbol + " " + chanName + std::string(" :") + GREEN + channel->getNamesList() + RESET);
-        sendReply(client, RPL_ENDOFNAMES, chanName + std::string(" :") + CYAN + "End of /NAMES list" + RESET);
+        sendNamesReply(client, channel, chanName);
+        sendReply(client, RPL_ENDOFNAMES, IrcLine().add(chanName).add(" :").paint(CYAN, "End of /NAMES list"));
     }
 }
 
-void Server::cmdPart(ClientConnection* client, const Message& msg)
+void Server::cmdPart(ClientConnection* client, const MessageView& msg)
 {
     if (!client->isRegistered()) {
         sendError(client, ERR_NOTREGISTERED, "");
@@ -141,7 +171,7 @@ void Server::cmdPart(ClientConnection* client, const Message& msg)
     if (msg.params.empty()) return sendError(client, ERR_NEEDMOREPARAMS, "PART");
 
     std::vector<std::string> targets = split(msg.params[0], ',');
-    std::string reason = (msg.params.size() > 1) ? msg.params[1] : "Leaving";
+    std::string reason = (msg.params.size() > 1) ? msg.params[1].str() : "Leaving";
 
     for (size_t i = 0; i < targets.size(); ++i)
     {
@@ -160,36 +190,22 @@ void Server::cmdPart(ClientConnection* client, const Message& msg)
             continue;
         }
 
-        // Get timestamp
-        std::string timestamp = getCurrentTimestamp();
-
-        std::string partMsg = std::string(BRIGHT_MAGENTA) + "@time=" + timestamp + RESET + " " +
-                                BRIGHT_CYAN + ":" + client->getUser()->getPrefix() + RESET +
-                                " " + BRIGHT_YELLOW + "PART" + RESET + " " +
-                                CYAN + chanName + RESET + " :" + reason + "\r\n";
-        channel->broadcast(partMsg, NULL); // Send to everyone
+        IrcLine partMsg;
+        partMsg.source(client->getUser()->getPrefix()).command("PART").add(' ')
+            .paint(CYAN, chanName).add(" :").add(reason).end();
+        TimedLine partLine(partMsg);
+        channel->broadcast(partLine, NULL); // Send to everyone
 
         channel->removeMember(client->getUser());
         client->getUser()->leaveChannel(channel);
 
         // Delete channel if empty
         if (channel->getUserCount() == 0)
-        {
-            for (std::vector<Channel*>::iterator it = channels_.begin(); it != channels_.end(); )
-            {
-                if (*it == channel)
-                {
-                    delete *it;
-                    it = channels_.erase(it);
-                    break;
-                }
-                else ++it;
-            }
-        }
+            destroyChannel(channel);
     }
 }
 
-void Server::cmdTopic(ClientConnection* client, const Message& msg)
+void Server::cmdTopic(ClientConnection* client, const MessageView& msg)
 {
     if (!client->isRegistered()) {
         sendError(client, ERR_NOTREGISTERED, "");
@@ -204,9 +220,9 @@ void Server::cmdTopic(ClientConnection* client, const Message& msg)
     if (msg.params.size() == 1)
     {
         if (channel->getTopic().empty())
-            sendReply(client, RPL_NOTOPIC, channel->getName() + std::string(" :") + YELLOW + "No topic is set" + RESET);
+            sendReply(client, RPL_NOTOPIC, IrcLine().add(channel->getName()).add(" :").paint(YELLOW, "No topic is set"));
         else
-            sendReply(client, RPL_TOPIC, channel->getName() + std::string(" :") + CYAN + channel->getTopic() + RESET);
+            sendReply(client, RPL_TOPIC, IrcLine().add(channel->getName()).add(" :").paint(CYAN, channel->getTopic()));
         return;
     }
 
@@ -216,19 +232,15 @@ void Server::cmdTopic(ClientConnection* client, const Message& msg)
 
     channel->setTopic(msg.params[1]);
     
-    // Get timestamp
-    std::string timestamp = getCurrentTimestamp();
-
     // Notify change to everyone
-    std::string topicMsg = std::string(BRIGHT_MAGENTA) + "@time=" + timestamp + RESET + " " +
-                            BRIGHT_CYAN + ":" + client->getUser()->getPrefix() + RESET +
-                            " " + BRIGHT_YELLOW + "TOPIC" + RESET + " " +
-                            CYAN + channel->getName() + RESET + " :" +
-                            BRIGHT_GREEN + msg.params[1] + RESET + "\r\n";
-    channel->broadcast(topicMsg, NULL);
+    IrcLine topicMsg;
+    topicMsg.source(client->getUser()->getPrefix()).command("TOPIC").add(' ')
+        .paint(CYAN, channel->getName()).add(" :").paint(BRIGHT_GREEN, msg.params[1]).end();
+    TimedLine topicLine(topicMsg);
+    channel->broadcast(topicLine, NULL);
 }
 
-void Server::cmdNames(ClientConnection* client, const Message& msg)
+void Server::cmdNames(ClientConnection* client, const MessageView& msg)
 {
     // CRITICAL: Verify user is registered
     if (!client->isRegistered()) {
@@ -243,14 +255,10 @@ void Server::cmdNames(ClientConnection* client, const Message& msg)
         for (size_t i = 0; i < channels_.size(); ++i)
         {
             Channel* chan = channels_[i];
-            std::string symbol = "="; // = public, @ secret, * private
-            
-            sendReply(client, RPL_NAMREPLY, 
-                     symbol + " " + chan->getName() + " :" + 
-                     GREEN + chan->getNamesList() + RESET);
+            sendNamesReply(client, chan, chan->getName());
         }
         
-        sendReply(client, RPL_ENDOFNAMES, "* :" + std::string(CYAN) + "End of /NAMES list" + RESET);
+        sendReply(client, RPL_ENDOFNAMES, IrcLine().add("* :").paint(CYAN, "End of /NAMES list"));
         return;
     }
 
@@ -267,16 +275,12 @@ void Server::cmdNames(ClientConnection* client, const Message& msg)
         return sendError(client, ERR_NOSUCHCHANNEL, chanName);
 
     // Send names list (same as in JOIN)
-    std::string symbol = "="; // Public channel
-    sendReply(client, RPL_NAMREPLY, 
-             symbol + " " + chanName + " :" + 
-             GREEN + channel->getNamesList() + RESET);
+    sendNamesReply(client, channel, chanName);
     
-    sendReply(client, RPL_ENDOFNAMES, 
-             chanName + std::string(" :") + CYAN + "End of /NAMES list" + RESET);
+    sendReply(client, RPL_ENDOFNAMES, IrcLine().add(chanName).add(" :").paint(CYAN, "End of /NAMES list"));
 }
 
-void Server::cmdWho(ClientConnection* client, const Message& msg)
+void Server::cmdWho(ClientConnection* client, const MessageView& msg)
 {
     // CRITICAL: Verify user is registered
     if (!client->isRegistered()) {
@@ -288,7 +292,7 @@ void Server::cmdWho(ClientConnection* client, const Message& msg)
     // For simplicity, send only END OF WHO
     if (msg.params.empty())
     {
-        sendReply(client, RPL_ENDOFWHO, "* :" + std::string(CYAN) + "End of /WHO list" + RESET);
+        sendReply(client, RPL_ENDOFWHO, IrcLine().add("* :").paint(CYAN, "End of /WHO list"));
         return;
     }
 
@@ -311,87 +315,73 @@ void Server::cmdWho(ClientConnection* client, const Message& msg)
             
             // Flags: H = here (present), G = gone (away)
             // @ = channel operator, + = voice
-            std::string flags = std::string(GREEN) + "H" + RESET; // Here
-            
-            if (channel->isOperator(member))
-                flags = std::string(BRIGHT_YELLOW) + "H@" + RESET; // Operator
+            bool op = channel->isOperator(member);
             
             // RFC 2812 format with colors:
             // <channel> <username> <host> <server> <nick> <flags> :<hopcount> <realname>
-            std::string whoReply = CYAN + target + RESET + " " +
-                                   BRIGHT_BLUE + member->getUsername() + RESET + " " +
-                                   YELLOW + member->getHostname() + RESET + " " +
-                                   MAGENTA + "ft_irc" + RESET + " " +
-                                   BRIGHT_GREEN + member->getNickname() + RESET + " " +
-                                   flags + " " +
-                                   ":" + BRIGHT_MAGENTA + "0" + RESET + " " +
-                                   BRIGHT_CYAN + member->getRealname() + RESET;
+            IrcLine whoReply;
+            whoReply.paint(CYAN, target).add(' ')
+                    .paint(BRIGHT_BLUE, member->getUsername()).add(' ')
+                    .paint(YELLOW, member->getHostname()).add(' ')
+                    .paint(MAGENTA, "ft_irc").add(' ')
+                    .paint(BRIGHT_GREEN, member->getNickname()).add(' ')
+                    .paint(op ? BRIGHT_YELLOW : GREEN, op ? "H@" : "H").add(' ')
+                    .add(':').paint(BRIGHT_MAGENTA, "0").add(' ')
+                    .paint(BRIGHT_CYAN, member->getRealname());
             
             sendReply(client, RPL_WHOREPLY, whoReply);
         }
         
-        sendReply(client, RPL_ENDOFWHO, target + " :" + std::string(CYAN) + "End of /WHO list" + RESET);
+        sendReply(client, RPL_ENDOFWHO, IrcLine().add(target).add(" :").paint(CYAN, "End of /WHO list"));
         return;
     }
 
     // Is it a specific user? (search by nickname)
-    User* targetUser = NULL;
-    
-    for (size_t i = 0; i < clients_.size(); ++i)
-    {
-        if (clients_[i]->isRegistered() && 
-            clients_[i]->getUser()->getNickname() == target)
-        {
-            targetUser = clients_[i]->getUser();
-            break;
-        }
-    }
+    User* targetUser = findRegisteredUser(target);
     
     if (!targetUser)
         return sendError(client, ERR_NOSUCHNICK, target);
 
     // Send user info with colors
-    std::string flags = std::string(GREEN) + "H" + RESET; // Here
-    
-    // Format: * = no common channel
-    std::string whoReply = std::string(YELLOW) + "*" + RESET + " " +
-                       BRIGHT_BLUE + targetUser->getUsername() + RESET + " " +
-                       YELLOW + targetUser->getHostname() + RESET + " " +
-                       MAGENTA + "ft_irc" + RESET + " " +
-                       BRIGHT_GREEN + targetUser->getNickname() + RESET + " " +
-                       flags + " " +
-                       ":" + BRIGHT_MAGENTA + "0" + RESET + " " +
-                       BRIGHT_CYAN + targetUser->getRealname() + RESET;
+    // Format: * = no common channel, H = here
+    IrcLine whoReply;
+    whoReply.paint(YELLOW, "*").add(' ')
+            .paint(BRIGHT_BLUE, targetUser->getUsername()).add(' ')
+            .paint(YELLOW, targetUser->getHostname()).add(' ')
+            .paint(MAGENTA, "ft_irc").add(' ')
+            .paint(BRIGHT_GREEN, targetUser->getNickname()).add(' ')
+            .paint(GREEN, "H").add(' ')
+            .add(':').paint(BRIGHT_MAGENTA, "0").add(' ')
+            .paint(BRIGHT_CYAN, targetUser->getRealname());
     
     sendReply(client, RPL_WHOREPLY, whoReply);
-    sendReply(client, RPL_ENDOFWHO, target + " :" + std::string(CYAN) + "End of /WHO list" + RESET);
+    sendReply(client, RPL_ENDOFWHO, IrcLine().add(target).add(" :").paint(CYAN, "End of /WHO list"));
 }
 
 std::string Server::getChannelsForUser(User* user) const
 {
     std::string result;
     
-    for (size_t i = 0; i < channels_.size(); ++i)
+    // Only the user's own channels, not every channel on the server
+    const std::vector<Channel*>& joined = user->getChannels();
+    for (size_t i = 0; i < joined.size(); ++i)
     {
-        Channel* chan = channels_[i];
+        Channel* chan = joined[i];
         
-        if (chan->isMember(user))
-        {
-            if (!result.empty())
-                result += " ";
-            
-            // Add @ prefix if channel operator
-            if (chan->isOperator(user))
-                result += "@";
-            
-            result += chan->getName();
-        }
+        if (!result.empty())
+            result += " ";
+        
+        // Add @ prefix if channel operator
+        if (chan->isOperator(user))
+            result += "@";
+        
+        result += chan->getName();
     }
     
     return result;
 }
 
-void Server::cmdWhois(ClientConnection* client, const Message& msg)
+void Server::cmdWhois(ClientConnection* client, const MessageView& msg)
 {
     // CRITICAL: Verify user is registered
     if (!client->isRegistered()) {
@@ -408,17 +398,7 @@ void Server::cmdWhois(ClientConnection* client, const Message& msg)
     std::string targetNick = msg.params[0];
 
     // Search user by nickname
-    User* targetUser = NULL;
-    
-    for (size_t i = 0; i < clients_.size(); ++i)
-    {
-        if (clients_[i]->isRegistered() && 
-            clients_[i]->getUser()->getNickname() == targetNick)
-        {
-            targetUser = clients_[i]->getUser();
-            break;
-        }
-    }
+    User* targetUser = findRegisteredUser(targetNick);
     
     if (!targetUser)
         return sendError(client, ERR_NOSUCHNICK, targetNick);
@@ -426,10 +406,11 @@ void Server::cmdWhois(ClientConnection* client, const Message& msg)
     // ============================================================================
     // RPL_WHOISUSER (311) - Basic user information
     // ============================================================================
-    std::string whoisUser = BRIGHT_GREEN + targetNick + RESET + " " +
-                           BRIGHT_BLUE + targetUser->getUsername() + RESET + " " +
-                           YELLOW + targetUser->getHostname() + RESET + " * :" +
-                           BRIGHT_CYAN + targetUser->getRealname() + RESET;
+    IrcLine whoisUser;
+    whoisUser.paint(BRIGHT_GREEN, targetNick).add(' ')
+             .paint(BRIGHT_BLUE, targetUser->getUsername()).add(' ')
+             .paint(YELLOW, targetUser->getHostname()).add(" * :")
+             .paint(BRIGHT_CYAN, targetUser->getRealname());
     sendReply(client, RPL_WHOISUSER, whoisUser);
 
     // ============================================================================
@@ -437,56 +418,49 @@ void Server::cmdWhois(ClientConnection* client, const Message& msg)
     // ============================================================================
     std::string channels = getChannelsForUser(targetUser);
     if (!channels.empty()) {
-        std::string whoisChannels = BRIGHT_GREEN + targetNick + RESET + " :" + 
-                                   CYAN + channels + RESET;
+        IrcLine whoisChannels;
+        whoisChannels.paint(BRIGHT_GREEN, targetNick).add(" :").paint(CYAN, channels);
         sendReply(client, RPL_WHOISCHANNELS, whoisChannels);
     }
 
     // ============================================================================
     // RPL_WHOISSERVER (312) - Server information
     // ============================================================================
-    std::string whoisServer = BRIGHT_GREEN + targetNick + RESET + " " +
-                             MAGENTA + "ft_irc" + RESET + " :" +
-                             BRIGHT_MAGENTA + "FT IRC Server" + RESET;
+    IrcLine whoisServer;
+    whoisServer.paint(BRIGHT_GREEN, targetNick).add(' ')
+               .paint(MAGENTA, "ft_irc").add(" :").paint(BRIGHT_MAGENTA, "FT IRC Server");
     sendReply(client, RPL_WHOISSERVER, whoisServer);
 
     // ============================================================================
     // RPL_WHOISIDLE (317) - Idle time and connection (optional)
     // ============================================================================
-    // Find ClientConnection of targetUser
-    ClientConnection* targetClient = NULL;
-    for (size_t i = 0; i < clients_.size(); ++i)
-    {
-        if (clients_[i]->isRegistered() && 
-            clients_[i]->getUser() == targetUser)
-        {
-            targetClient = clients_[i];
-            break;
-        }
-    }
+    // ClientConnection of targetUser
+    ClientConnection* targetClient = targetUser->getConnection();
 
     time_t currentTime = time(NULL);
     long idleSeconds = 0;
     long signonTime = (long)currentTime;
 
     if (targetClient) {
-        idleSeconds = (long)(currentTime - targetClient->getLastActivity());
+        unsigned long now = Clock::nowMs();
+        unsigned long last = targetClient->getLastActivity();	// Stamped by its own loop
+        idleSeconds = now > last ? (long)((now - last) / 1000) : 0;
         signonTime = (long)targetClient->getConnectTime();
     }
 
     std::ostringstream idleStream;
     idleStream << idleSeconds << " " << signonTime;
 
-    std::string whoisIdle = BRIGHT_GREEN + targetNick + RESET + " " +
-                        BRIGHT_MAGENTA + idleStream.str() + RESET + " :" +
-                        YELLOW + "seconds idle, signon time" + RESET;
+    IrcLine whoisIdle;
+    whoisIdle.paint(BRIGHT_GREEN, targetNick).add(' ')
+             .paint(BRIGHT_MAGENTA, idleStream.str()).add(" :").paint(YELLOW, "seconds idle, signon time");
     sendReply(client, RPL_WHOISIDLE, whoisIdle);
 
     // ============================================================================
     // RPL_ENDOFWHOIS (318) - End of WHOIS
     // ============================================================================
-    std::string endWhois = BRIGHT_GREEN + targetNick + RESET + " :" +
-                          CYAN + "End of /WHOIS list" + RESET;
+    IrcLine endWhois;
+    endWhois.paint(BRIGHT_GREEN, targetNick).add(" :").paint(CYAN, "End of /WHOIS list");
     sendReply(client, RPL_ENDOFWHOIS, endWhois);
 }
 
@@ -16,9 +16,10 @@
 #include "../channel/Channel.hpp"
 #include "CommandHelpers.hpp"
 #include "../irc/NumericReplies.hpp"
+#include "../irc/IrcLine.hpp"
 #include "../utils/Colors.hpp"
 
-void Server::cmdPrivMsg(ClientConnection* client, const Message& msg)
+void Server::cmdPrivMsg(ClientConnection* client, const MessageView& msg)
 {
     if (!client->isRegistered()) {
         sendError(client, ERR_NOTREGISTERED, "");
@@ -31,108 +32,76 @@ void Server::cmdPrivMsg(ClientConnection* client, const Message& msg)
 
     User* sender = client->getUser();
     std::string target = msg.params[0];
-    std::string text = msg.params[1];
 
-    // Get timestamp
-    std::string timestamp = getCurrentTimestamp();
-    
-    // Build message with colors
-    std::string fullMsg = std::string(BRIGHT_MAGENTA) + "@time=" + timestamp + RESET + " " +
-                          BRIGHT_CYAN + ":" + sender->getPrefix() + RESET +
-                          " " + BRIGHT_YELLOW + "PRIVMSG" + RESET + " " +
-                          CYAN + target + RESET + " :" + text + "\r\n";
-
-    // CASE 1: Message to channel
+    // Resolve the destination first: no line is built for an error
+    Channel* channel = NULL;
+    User* recipient = NULL;
     if (target[0] == '#')
     {
-        Channel* channel = getChannel(target);
-        
+        channel = getChannel(target);
         if (!channel)
             return sendError(client, ERR_NOSUCHCHANNEL, target);
-        
         if (!channel->isMember(sender))
             return sendError(client, ERR_CANNOTSENDTOCHAN, target);
-        
-        // Broadcast to all members except sender
-        channel->broadcast(fullMsg, sender);
-        
-        // Force immediate send for all recipients
-        const std::vector<User*>& members = channel->getMembers();
-        for (std::vector<User*>::const_iterator it = members.begin(); it != members.end(); ++it)
-        {
-            User* member = *it;
-            if (member == sender)
-                continue;
-            
-            ClientConnection* conn = member->getConnection();
-            if (conn && conn->hasPendingSend())
-                sendPendingData(conn);
-        }
     }
-    // CASE 2: Private message
     else
     {
-        // Find user by nickname
-        User* recipient = NULL;
-        for (size_t i = 0; i < clients_.size(); ++i)
-        {
-            if (clients_[i]->isRegistered() && 
-                clients_[i]->getUser()->getNickname() == target)
-            {
-                recipient = clients_[i]->getUser();
-                break;
-            }
-        }
-        
+        recipient = findRegisteredUser(target);
         if (!recipient)
             return sendError(client, ERR_NOSUCHNICK, target);
-        
+    }
+
+    // Formatted once; the time tag is added per kind of recipient
+    IrcLine body;
+    body.source(sender->getPrefix()).command("PRIVMSG").add(' ')
+        .paint(CYAN, target).add(" :").add(msg.params[1]).end();
+    TimedLine line(body);
+
+    // CASE 1: Message to channel
+    if (channel)
+    {
+        // Broadcast to all members except sender (queued, flushed by their loop)
+        channel->broadcast(line, sender);
+    }
+    // CASE 2: Private message
+    else
+    {
         ClientConnection* recipientConn = recipient->getConnection();
         if (recipientConn)
-        {
-            recipientConn->queueSend(fullMsg);
-            sendPendingData(recipientConn);
-        }
+            line.sendTo(recipientConn);
     }
 }
 
-void Server::cmdNotice(ClientConnection* client, const Message& msg)
+void Server::cmdNotice(ClientConnection* client, const MessageView& msg)
 {
     // NOTICE should not send error responses per RFC
     if (!client->isRegistered() || msg.params.size() < 2)
         return;
 
     std::string target = msg.params[0];
-    std::string text = msg.params[1];
-    std::string timestamp = getCurrentTimestamp();
-
-    // CASE 1: NOTICE to channel
+    Channel* channel = NULL;
+    User* recipient = NULL;
     if (target[0] == '#')
     {
-        Channel* channel = getChannel(target);
-        if (channel && channel->isMember(client->getUser()))
-        {
-            std::string fullMsg = std::string(BRIGHT_MAGENTA) + "@time=" + timestamp + RESET + " " +
-                                  BRIGHT_CYAN + ":" + client->getUser()->getPrefix() + RESET +
-                                  " " + BRIGHT_YELLOW + "NOTICE" + RESET + " " +
-                                  CYAN + target + RESET + " :" + text + "\r\n";
-            channel->broadcast(fullMsg, client->getUser());
-        }
+        channel = getChannel(target);
+        if (!channel || !channel->isMember(client->getUser()))
+            return;
     }
-    // CASE 2: Private NOTICE
     else
     {
-        for (size_t i = 0; i < clients_.size(); ++i)
-        {
-            if (clients_[i]->isRegistered() && clients_[i]->getUser()->getNickname() == target)
-            {
-                std::string fullMsg = std::string(BRIGHT_MAGENTA) + "@time=" + timestamp + RESET + " " +
-                                      BRIGHT_CYAN + ":" + client->getUser()->getPrefix() + RESET +
-                                      " " + BRIGHT_YELLOW + "NOTICE" + RESET + " " +
-                                      CYAN + target + RESET + " :" + text + "\r\n";
-                clients_[i]->queueSend(fullMsg);
-                break;
-            }
-        }
+        recipient = findRegisteredUser(target);
+        if (!recipient)
+            return;
     }
+
+    IrcLine body;
+    body.source(client->getUser()->getPrefix()).command("NOTICE").add(' ')
+        .paint(CYAN, target).add(" :").add(msg.params[1]).end();
+    TimedLine line(body);
+
+    // NOTICE never triggers replies: first to go when a reader falls behind
+    if (channel)
+        channel->broadcast(line, client->getUser(), ClientConnection::OUTPUT_LOW);
+    else
+        line.sendTo(recipient->getConnection(), ClientConnection::OUTPUT_LOW);
 }
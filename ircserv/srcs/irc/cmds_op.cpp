@@ -16,12 +16,28 @@
 #include "../channel/Channel.hpp"
 #include "CommandHelpers.hpp"
 #include "../irc/NumericReplies.hpp"
+#include "../irc/IrcLine.hpp"
 #include "../utils/Colors.hpp"
 #include <cstdlib>
 #include <cstdio>
 #include <cctype>
 
-void Server::cmdKick(ClientConnection* client, const Message& msg)
+// MODE change as seen by the whole channel: ":src MODE #chan +o nick"
+static void broadcastChannelMode(Channel* channel, User* source, const std::string& target,
+                                 char action, char mode, const std::string& arg)
+{
+    IrcLine modeMsg;
+    modeMsg.source(source->getPrefix()).command("MODE").add(' ')
+        .paint(CYAN, target).add(' ')
+        .color(BRIGHT_GREEN).add(action).add(mode).reset();
+    if (!arg.empty())
+        modeMsg.add(' ').add(arg);
+    modeMsg.end();
+    TimedLine line(modeMsg);
+    channel->broadcast(line, NULL);
+}
+
+void Server::cmdKick(ClientConnection* client, const MessageView& msg)
 {
     if (!client->isRegistered()) {
         sendError(client, ERR_NOTREGISTERED, "");
@@ -31,7 +47,7 @@ void Server::cmdKick(ClientConnection* client, const Message& msg)
     
     std::string chanName = msg.params[0];
     std::string targetNick = msg.params[1];
-    std::string comment = (msg.params.size() > 2) ? msg.params[2] : "Kicked";
+    std::string comment = (msg.params.size() > 2) ? msg.params[2].str() : "Kicked";
 
     Channel* channel = getChannel(chanName);
     if (!channel) return sendError(client, ERR_NOSUCHCHANNEL, chanName);
@@ -41,28 +57,24 @@ void Server::cmdKick(ClientConnection* client, const Message& msg)
         return sendError(client, ERR_CHANOPRIVSNEEDED, chanName);
 
     // Check if target user is in channel
-    User* targetUser = channel->getMember(targetNick);
+    User* targetUser = findChannelMember(channel, targetNick);
     if (!targetUser) 
         return sendError(client, ERR_USERNOTINCHANNEL, targetNick + " " + chanName);
 
-    // Get timestamp
-    std::string timestamp = getCurrentTimestamp();
-
     // KICK message
-    std::string kickMsg = std::string(BRIGHT_MAGENTA) + "@time=" + timestamp + RESET + " " +
-                            BRIGHT_CYAN + ":" + client->getUser()->getPrefix() + RESET +
-                            " " + BRIGHT_YELLOW + "KICK" + RESET + " " +
-                            CYAN + chanName + RESET + " " +
-                            targetNick + " :" + RED + comment + RESET + "\r\n";
+    IrcLine kickMsg;
+    kickMsg.source(client->getUser()->getPrefix()).command("KICK").add(' ')
+        .paint(CYAN, chanName).add(' ').add(targetNick).add(" :").paint(RED, comment).end();
+    TimedLine kickLine(kickMsg);
 
-    channel->broadcast(kickMsg, NULL);
+    channel->broadcast(kickLine, NULL);
 
     // Actually remove
     channel->removeMember(targetUser);
     targetUser->leaveChannel(channel);
 }
 
-void Server::cmdInvite(ClientConnection* client, const Message& msg)
+void Server::cmdInvite(ClientConnection* client, const MessageView& msg)
 {
     if (!client->isRegistered()) {
         sendError(client, ERR_NOTREGISTERED, "");
@@ -82,36 +94,27 @@ void Server::cmdInvite(ClientConnection* client, const Message& msg)
         if (channel->hasMode('i') && !channel->isOperator(client->getUser()))
              return sendError(client, ERR_CHANOPRIVSNEEDED, chanName);
         
-        if (channel->getMember(targetNick))
+        if (findChannelMember(channel, targetNick))
              return sendError(client, ERR_USERONCHANNEL, targetNick + " " + chanName);
         
         channel->addInvite(targetNick);
     }
 
     // Search target user globally on server
-    User* dest = NULL;
-    for (size_t i = 0; i < clients_.size(); ++i) {
-        if (clients_[i]->isRegistered() && clients_[i]->getUser()->getNickname() == targetNick) {
-            dest = clients_[i]->getUser();
-            break;
-        }
-    }
+    User* dest = findRegisteredUser(targetNick);
     if (!dest) return sendError(client, ERR_NOSUCHNICK, targetNick);
 
-    // Get timestamp
-    std::string timestamp = getCurrentTimestamp();
-
     // INVITE message
-    std::string invMsg = std::string(BRIGHT_MAGENTA) + "@time=" + timestamp + RESET + " " +
-                            BRIGHT_CYAN + ":" + client->getUser()->getPrefix() + RESET +
-                            " " + BRIGHT_YELLOW + "INVITE" + RESET + " " +
-                            targetNick + " " + CYAN + chanName + RESET + "\r\n";
+    IrcLine invMsg;
+    invMsg.source(client->getUser()->getPrefix()).command("INVITE").add(' ')
+        .add(targetNick).add(' ').paint(CYAN, chanName).end();
+    TimedLine invLine(invMsg);
 
-    dest->getConnection()->queueSend(invMsg);
+    invLine.sendTo(dest->getConnection());
     sendReply(client, RPL_INVITING, targetNick + " " + chanName);
 }
 
-void Server::cmdMode(ClientConnection* client, const Message& msg)
+void Server::cmdMode(ClientConnection* client, const MessageView& msg)
 {
     if (!client->isRegistered()) {
         sendError(client, ERR_NOTREGISTERED, "");
@@ -135,6 +138,7 @@ void Server::cmdMode(ClientConnection* client, const Message& msg)
         {
             std::string modes = "+";
             if (client->getUser()->isInvisible()) modes += "i";
+            if (client->getUser()->isOperator()) modes += "o";
             sendReply(client, RPL_UMODEIS, modes);
             return;
         }
@@ -159,17 +163,22 @@ void Server::cmdMode(ClientConnection* client, const Message& msg)
                     appliedModes += 'i';
                 }
             }
+            // Operator status is only granted by OPER, but can be dropped
+            if (modeString[i] == 'o' && action == '-' && client->getUser()->isOperator()) {
+                client->getUser()->setOperator(false);
+                __sync_fetch_and_sub(&stats_.operators, 1UL);
+                if (appliedModes.find(action) == std::string::npos)
+                    appliedModes += action;
+                appliedModes += 'o';
+            }
         }
         if (!appliedModes.empty()) {
-            // Get timestamp
-            std::string timestamp = getCurrentTimestamp();
-
             // MODE message
-            std::string modeMsg = std::string(BRIGHT_MAGENTA) + "@time=" + timestamp + RESET + " " +
-                                    BRIGHT_CYAN + ":" + client->getUser()->getPrefix() + RESET +
-                                    " " + BRIGHT_YELLOW + "MODE" + RESET + " " +
-                                    target + " :" + BRIGHT_GREEN + appliedModes + RESET + "\r\n";
-            client->queueSend(modeMsg);
+            IrcLine modeMsg;
+            modeMsg.source(client->getUser()->getPrefix()).command("MODE").add(' ')
+                .add(target).add(" :").paint(BRIGHT_GREEN, appliedModes).end();
+            TimedLine modeLine(modeMsg);
+            modeLine.sendTo(client);
         }
         return;
     }
@@ -203,24 +212,15 @@ void Server::cmdMode(ClientConnection* client, const Message& msg)
         if (mode == 'o') {
             if (paramIdx >= msg.params.size()) continue;
             std::string targetNick = msg.params[paramIdx++];
-            User* targetUser = channel->getMember(targetNick);
+            User* targetUser = findChannelMember(channel, targetNick);
             
             // If user doesn't exist in channel, ignore silently or could send error
             if (targetUser) {
                 if (action == '+') channel->addOperator(targetUser);
                 else channel->removeOperator(targetUser);
                 
-                // Get timestamp
-                std::string timestamp = getCurrentTimestamp();
-
                 // MODE +o/-o message
-                std::string modeMsg = std::string(BRIGHT_MAGENTA) + "@time=" + timestamp + RESET + " " +
-                                        BRIGHT_CYAN + ":" + client->getUser()->getPrefix() + RESET +
-                                        " " + BRIGHT_YELLOW + "MODE" + RESET + " " +
-                                        CYAN + target + RESET + " " +
-                                        BRIGHT_GREEN + std::string(1, action) + "o" + RESET + " " +
-                                        targetNick + "\r\n";
-                channel->broadcast(modeMsg, NULL);
+                broadcastChannelMode(channel, client->getUser(), target, action, 'o', targetNick);
             } else {
                  sendError(client, ERR_USERNOTINCHANNEL, targetNick + " " + target);
             }
@@ -235,17 +235,8 @@ void Server::cmdMode(ClientConnection* client, const Message& msg)
                 if (key.find(' ') != std::string::npos) continue;
 
                 channel->setKey(key);
-                // Get timestamp
-                std::string timestamp = getCurrentTimestamp();
-
                 // MODE +k message
-                std::string modeMsg = std::string(BRIGHT_MAGENTA) + "@time=" + timestamp + RESET + " " +
-                                        BRIGHT_CYAN + ":" + client->getUser()->getPrefix() + RESET +
-                                        " " + BRIGHT_YELLOW + "MODE" + RESET + " " +
-                                        CYAN + target + RESET + " " +
-                                        BRIGHT_GREEN + std::string(1, action) + "k" + RESET + " " +
-                                        key + "\r\n";
-                channel->broadcast(modeMsg, NULL);
+                broadcastChannelMode(channel, client->getUser(), target, action, 'k', key);
             } else {
                 // [FIX RFC] Permissive mode: allows -k without parameter for OPs
                 std::string keyParam = "";
@@ -259,16 +250,8 @@ void Server::cmdMode(ClientConnection* client, const Message& msg)
                 }
                 
                 channel->setKey("");
-                // Get timestamp
-                std::string timestamp = getCurrentTimestamp();
-
                 // MODE -k message
-                std::string modeMsg = std::string(BRIGHT_MAGENTA) + "@time=" + timestamp + RESET + " " +
-                                        BRIGHT_CYAN + ":" + client->getUser()->getPrefix() + RESET +
-                                        " " + BRIGHT_YELLOW + "MODE" + RESET + " " +
-                                        CYAN + target + RESET + " " +
-                                        BRIGHT_GREEN + "-k" + RESET + " *\r\n";
-                channel->broadcast(modeMsg, NULL);
+                broadcastChannelMode(channel, client->getUser(), target, action, 'k', "*");
             }
         }
         // l: Limit
@@ -299,45 +282,19 @@ void Server::cmdMode(ClientConnection* client, const Message& msg)
                 channel->setLimit(limit);
                 char buff[20];
                 std::sprintf(buff, "%d", limit);
-                // Get timestamp
-                std::string timestamp = getCurrentTimestamp();
-
                 // MODE +l message
-                std::string modeMsg = std::string(BRIGHT_MAGENTA) + "@time=" + timestamp + RESET + " " +
-                                        BRIGHT_CYAN + ":" + client->getUser()->getPrefix() + RESET +
-                                        " " + BRIGHT_YELLOW + "MODE" + RESET + " " +
-                                        CYAN + target + RESET + " " +
-                                        BRIGHT_GREEN + std::string(1, action) + "l" + RESET + " " +
-                                        std::string(buff) + "\r\n";
-                channel->broadcast(modeMsg, NULL);
+                broadcastChannelMode(channel, client->getUser(), target, action, 'l', buff);
             } else {
                 channel->setLimit(0); // 0 means no limit
-                // Get timestamp
-                std::string timestamp = getCurrentTimestamp();
-
                 // MODE -l message
-                std::string modeMsg = std::string(BRIGHT_MAGENTA) + "@time=" + timestamp + RESET + " " +
-                                        BRIGHT_CYAN + ":" + client->getUser()->getPrefix() + RESET +
-                                        " " + BRIGHT_YELLOW + "MODE" + RESET + " " +
-                                        CYAN + target + RESET + " " +
-                                        BRIGHT_GREEN + std::string(1, action) + "l" + RESET + "\r\n";
-                channel->broadcast(modeMsg, NULL);
+                broadcastChannelMode(channel, client->getUser(), target, action, 'l', "");
             }
         }
         // i: Invite Only | t: Topic Restricted
         else if (mode == 'i' || mode == 't') {
             channel->setMode(mode, (action == '+'));
-            // Get timestamp
-            std::string timestamp = getCurrentTimestamp();
-            std::string mStr(1, mode);
-
             // MODE +i/+t message
-            std::string modeMsg = std::string(BRIGHT_MAGENTA) + "@time=" + timestamp + RESET + " " +
-                                    BRIGHT_CYAN + ":" + client->getUser()->getPrefix() + RESET +
-                                    " " + BRIGHT_YELLOW + "MODE" + RESET + " " +
-                                    CYAN + target + RESET + " " +
-                                    BRIGHT_GREEN + std::string(1, action) + mStr + RESET + "\r\n";
-            channel->broadcast(modeMsg, NULL);
+            broadcastChannelMode(channel, client->getUser(), target, action, mode, "");
             
         }
     }
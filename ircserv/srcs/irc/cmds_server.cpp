@@ -0,0 +1,168 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   cmds_server.cpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: carlsanc <carlsanc@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 03:58:40 by carlsanc          #+#    #+#             */
+/*   Updated: 2026/10/18 03:58:40 by carlsanc         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../server/Server.hpp"
+#include "../server/EventLoop.hpp"
+#include "../client/ClientConnection.hpp"
+#include "../client/User.hpp"
+#include "CommandHelpers.hpp"
+#include "../irc/NumericReplies.hpp"
+#include <sstream>
+#include <cstdio>
+
+// Counters come from Server::collectStats(): summed from every loop, no
+// walk over users or channels, so both commands cost the same at any size.
+
+// Up to three lines per command that ran since start or the last reset
+void Server::sendProfile(ClientConnection* client)
+{
+    CommandProfile& profile = stats_profile_;
+    collectProfile(profile);
+    for (size_t id = 0; id < CMD_COUNT; ++id)
+    {
+        if (!profile.parse[id].count())
+            continue;
+        std::string name = commandName(static_cast<CommandId>(id));
+        std::ostringstream line;
+        line << "p :" << name << " parse ";
+        profile.parse[id].print(line);
+        sendReply(client, RPL_STATSDEBUG, line.str());
+        if (!profile.handler[id].count())
+            continue; // Unknown command, or no handler finished yet
+        line.str("");
+        line << "p :" << name << " handler ";
+        profile.handler[id].print(line);
+        sendReply(client, RPL_STATSDEBUG, line.str());
+        line.str("");
+        line << "p :" << name << " output ";
+        profile.output[id].print(line, "B", 1.0);
+        sendReply(client, RPL_STATSDEBUG, line.str());
+    }
+}
+
+// ============================================================================
+// STATS <query> (operators only)
+// ============================================================================
+//  m  per command: 212 <command> <lines received> <lines sent because of it>
+//  u  uptime
+//  t  traffic: connections, bytes, wakeups, send queues, evictions
+//  p  per command: handler time, parse time, bytes queued ("STATS p reset" clears)
+void Server::cmdStats(ClientConnection* client, const MessageView& msg)
+{
+    if (!client->isRegistered())
+        return sendError(client, ERR_NOTREGISTERED, "");
+    if (!client->getUser()->isOperator())
+        return sendError(client, ERR_NOPRIVILEGES, "");
+    if (msg.params.empty() || msg.params[0].empty())
+        return sendError(client, ERR_NEEDMOREPARAMS, "STATS");
+
+    char query = msg.params[0][0];
+    StatsSnapshot stats;
+    collectStats(stats);
+
+    if (query == 'm')
+    {
+        for (size_t id = CMD_UNKNOWN; id < CMD_COUNT; ++id)
+        {
+            if (!stats.commandsIn[id] && !stats.linesOut[id])
+                continue;
+            std::ostringstream line;
+            line << commandName(static_cast<CommandId>(id)) << " "
+                 << stats.commandsIn[id] << " " << stats.linesOut[id];
+            sendReply(client, RPL_STATSCOMMANDS, line.str());
+        }
+    }
+    else if (query == 'u')
+    {
+        char uptime[64];
+        std::snprintf(uptime, sizeof(uptime), ":Server Up %lu days %lu:%02lu:%02lu",
+            stats.uptime / 86400, stats.uptime / 3600 % 24, stats.uptime / 60 % 60, stats.uptime % 60);
+        sendReply(client, RPL_STATSUPTIME, uptime);
+    }
+    else if (query == 't')
+    {
+        std::ostringstream line;
+        line << "t :connections=" << stats.connections << " registered=" << stats.registered
+             << " operators=" << stats.operators << " channels=" << stats.channels;
+        sendReply(client, RPL_STATSDEBUG, line.str());
+
+        line.str("");
+        line << "t :accepted=" << stats.accepted << " ("
+             << (stats.uptime ? stats.accepted / stats.uptime : stats.accepted) << "/s average)"
+             << " wakeups=" << stats.wakeups << " writev=" << stats.writes;
+        sendReply(client, RPL_STATSDEBUG, line.str());
+
+        line.str("");
+        line << "t :bytes in=" << stats.bytesIn << " out=" << stats.bytesOut
+             << " sendq=" << stats.sendqBytes;
+        sendReply(client, RPL_STATSDEBUG, line.str());
+
+        line.str("");
+        line << "t :sendq evictions=" << __atomic_load_n(&stats_.sendqEvictions, __ATOMIC_RELAXED)
+             << " dropped=" << __atomic_load_n(&stats_.sendqDropped, __ATOMIC_RELAXED)
+             << " excess flood=" << __atomic_load_n(&stats_.excessFlood, __ATOMIC_RELAXED)
+             << " ping timeouts=" << __atomic_load_n(&stats_.pingTimeouts, __ATOMIC_RELAXED);
+        sendReply(client, RPL_STATSDEBUG, line.str());
+    }
+    else if (query == 'p' && msg.params.size() > 1 && msg.params[1] == std::string("reset"))
+    {
+        resetProfiles();
+        sendReply(client, RPL_STATSDEBUG, "p :Command profiles reset");
+    }
+    else if (query == 'p')
+        sendProfile(client);
+    sendReply(client, RPL_ENDOFSTATS, std::string(1, query) + " :End of STATS report");
+}
+
+// ============================================================================
+// LUSERS (everyone; operators also get the per-loop breakdown)
+// ============================================================================
+void Server::cmdLusers(ClientConnection* client, const MessageView& msg)
+{
+    (void)msg;
+    if (!client->isRegistered())
+        return sendError(client, ERR_NOTREGISTERED, "");
+
+    StatsSnapshot stats;
+    collectStats(stats);
+    // A connection counts as registered only after its loop saw it register
+    unsigned long unknown = stats.connections > stats.registered ? stats.connections - stats.registered : 0;
+
+    std::ostringstream line;
+    line << ":There are " << stats.registered << " users on 1 server";
+    sendReply(client, RPL_LUSERCLIENT, line.str());
+    line.str("");
+    line << stats.operators << " :operator(s) online";
+    sendReply(client, RPL_LUSEROP, line.str());
+    line.str("");
+    line << unknown << " :unknown connection(s)";
+    sendReply(client, RPL_LUSERUNKNOWN, line.str());
+    line.str("");
+    line << stats.channels << " :channels formed";
+    sendReply(client, RPL_LUSERCHANNELS, line.str());
+    line.str("");
+    line << ":I have " << stats.connections << " clients and 0 servers";
+    sendReply(client, RPL_LUSERME, line.str());
+    line.str("");
+    line << stats.registered << " " << stats.registered << " :Current local users "
+         << stats.registered;
+    sendReply(client, RPL_LOCALUSERS, line.str());
+
+    if (!client->getUser()->isOperator())
+        return;
+    line.str("");
+    line << "L :loops=[";
+    for (size_t i = 0; i < loops_.size(); ++i)
+        line << (i ? " " : "") << loops_[i]->getLoad();
+    line << "] sendq=" << stats.sendqBytes << " wakeups=" << stats.wakeups;
+    sendReply(client, RPL_STATSDEBUG, line.str());
+}
@@ -0,0 +1,164 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   LoadConfig.cpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 05:12:40 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 05:12:40 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "LoadConfig.hpp"
+#include <cstdlib>
+#include <cctype>
+#include <sstream>
+#include <vector>
+
+LoadConfig::LoadConfig() :
+	host("127.0.0.1"), port(6667), password(""),
+	clients(1000), channels(10), joins(1), senders(0), nickPrefix("lg"),
+	rate(10000), window(4), size(64), warmup(2), duration(10), connectBatch(128),
+	interval(1), maxP99(0), useEpoll(true), metricsPort(0)
+{
+}
+
+//* ============================================================================
+//* OPTION PARSING
+//* ============================================================================
+
+namespace
+{
+	struct NumericOption
+	{
+		const char*					key;
+		long						min;
+		long						max;
+		unsigned long LoadConfig::*	field;
+	};
+
+	const NumericOption kNumericOptions[] =
+	{
+		{ "clients",		1,	1000000,	&LoadConfig::clients },
+		{ "channels",		0,	100000,		&LoadConfig::channels },
+		{ "joins",			1,	100,		&LoadConfig::joins },
+		{ "senders",		0,	1000000,	&LoadConfig::senders },
+		{ "rate",			0,	10000000,	&LoadConfig::rate },
+		{ "window",			1,	10000,		&LoadConfig::window },
+		{ "size",			32,	400,		&LoadConfig::size },
+		{ "warmup",			0,	3600,		&LoadConfig::warmup },
+		{ "duration",		1,	86400,		&LoadConfig::duration },
+		{ "connect-batch",	1,	65536,		&LoadConfig::connectBatch },
+		{ "interval",		0,	3600,		&LoadConfig::interval },
+		{ "max-p99",		0,	100000000,	&LoadConfig::maxP99 },
+		{ "metrics-port",	0,	65535,		&LoadConfig::metricsPort }
+	};
+}
+
+bool LoadConfig::parseOption(const std::string& arg, std::string& error)
+{
+	if (arg.compare(0, 2, "--") != 0)
+	{
+		error = "unexpected argument '" + arg + "'";
+		return (false);
+	}
+
+	size_t eq = arg.find('=');
+	std::string key = arg.substr(2, eq == std::string::npos ? std::string::npos : eq - 2);
+	std::string value = (eq == std::string::npos) ? "" : arg.substr(eq + 1);
+
+	if (key == "backend")
+	{
+		if (value != "poll" && value != "epoll")
+		{
+			error = "--backend expects 'poll' or 'epoll'";
+			return (false);
+		}
+		useEpoll = (value == "epoll");
+		return (true);
+	}
+	if (key == "nick-prefix")
+	{
+		if (value.empty() || value.size() > 8 || std::isdigit(value[0]) || value[0] == '-'
+			|| value.find_first_of(" :,#\r\n") != std::string::npos)
+		{
+			error = "--nick-prefix expects 1-8 nickname characters, not starting with a digit";
+			return (false);
+		}
+		nickPrefix = value;
+		return (true);
+	}
+	for (size_t i = 0; i < sizeof(kNumericOptions) / sizeof(kNumericOptions[0]); ++i)
+	{
+		const NumericOption& option = kNumericOptions[i];
+		if (key != option.key)
+			continue;
+		long n;
+		if (!parseNumber(value, option.min, option.max, n))
+		{
+			std::ostringstream reason;
+			reason << "--" << key << " expects a number between " << option.min
+				<< " and " << option.max;
+			error = reason.str();
+			return (false);
+		}
+		this->*option.field = static_cast<unsigned long>(n);
+		return (true);
+	}
+	error = "unknown option '" + arg + "'";
+	return (false);
+}
+
+bool LoadConfig::validate(std::string& error)
+{
+	if (senders == 0 || senders > clients)
+		senders = clients;
+	//* Nicks are <prefix><index> and the server takes at most 9 characters
+	size_t digits = 1;
+	for (unsigned long n = clients - 1; n >= 10; n /= 10)
+		digits++;
+	if (nickPrefix.size() + digits > 9)
+	{
+		error = "--nick-prefix too long for this many --clients (nicks are at most 9 characters)";
+		return (false);
+	}
+	if (channels == 0)
+	{
+		if (clients < 2)
+		{
+			error = "private messages need at least 2 --clients";
+			return (false);
+		}
+		return (true);
+	}
+	if (joins > channels)
+	{
+		error = "--joins cannot exceed --channels";
+		return (false);
+	}
+	//* A channel with a single member would swallow its messages unseen
+	std::vector<unsigned long> members(channels, 0);
+	for (unsigned long i = 0; i < clients; ++i)
+		for (unsigned long k = 0; k < joins; ++k)
+			members[(i + k) % channels]++;
+	for (unsigned long c = 0; c < channels; ++c)
+	{
+		if (members[c] == 1)
+		{
+			error = "a channel would have a single member: raise --clients or --joins, or lower --channels";
+			return (false);
+		}
+	}
+	return (true);
+}
+
+//* Whole string must be a decimal number inside [min, max]
+bool LoadConfig::parseNumber(const std::string& value, long min, long max, long& out)
+{
+	if (value.empty())
+		return (false);
+	char* end = NULL;
+	out = std::strtol(value.c_str(), &end, 10);
+	return (*end == '\0' && out >= min && out <= max);
+}
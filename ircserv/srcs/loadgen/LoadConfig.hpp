@@ -0,0 +1,81 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   LoadConfig.hpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 05:12:40 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 05:12:40 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef LOAD_CONFIG_HPP
+#define LOAD_CONFIG_HPP
+
+#include <string>
+
+/**
+ * LoadConfig: Options of the loadgen tool
+ *
+ * Same shape as ServerConfig: <host> <port> <password> are mandatory,
+ * everything else is an optional "--key=value" with a default.
+ *
+ * Topology:
+ * - channels > 0: client i joins channels i .. i+joins-1 (mod channels)
+ *   and sends to them in turn; every other member receives the line
+ * - channels = 0: client i sends private messages to client i+1
+ * Only the first `senders` clients send, the rest just receive.
+ */
+
+struct LoadConfig
+{
+	std::string		host;
+	int				port;
+	std::string		password;
+
+	//* TOPOLOGY
+	unsigned long	clients;						//* --clients: connections to open
+	unsigned long	channels;						//* --channels: 0 = private messages
+	unsigned long	joins;							//* --joins: channels per client
+	unsigned long	senders;						//* --senders: 0 = every client sends
+	std::string		nickPrefix;						//* --nick-prefix: nicks are <prefix><index>, 9 chars max
+
+	//* TRAFFIC
+	unsigned long	rate;							//* --rate: PRIVMSG per second overall, 0 = window only
+	unsigned long	window;							//* --window: undelivered messages per sender
+	unsigned long	size;							//* --size: PRIVMSG text length
+	unsigned long	warmup;							//* --warmup: seconds sent but not measured
+	unsigned long	duration;						//* --duration: measured seconds
+	unsigned long	connectBatch;					//* --connect-batch: connections in progress at once
+
+	//* REPORTING
+	unsigned long	interval;						//* --interval: seconds between progress lines, 0 = off
+	unsigned long	maxP99;							//* --max-p99: microseconds, exit 3 above it, 0 = off
+	bool			useEpoll;						//* --backend=poll|epoll
+	unsigned long	metricsPort;					//* --metrics-port: server's metrics listener, 0 = off
+
+	LoadConfig();
+
+	/**
+	 * Parse one optional "--key=value" argument
+	 *
+	 * @param arg Raw argv entry
+	 * @param error [OUT] Human-readable reason when the option is rejected
+	 * @return true if the option was recognised and valid
+	 */
+	bool parseOption(const std::string& arg, std::string& error);
+
+	/**
+	 * Cross-option checks, once every option has been parsed
+	 *
+	 * @param error [OUT] Human-readable reason when the combination is invalid
+	 * @return true if the configuration is usable
+	 */
+	bool validate(std::string& error);
+
+	private:
+		static bool parseNumber(const std::string& value, long min, long max, long& out);
+};
+
+#endif
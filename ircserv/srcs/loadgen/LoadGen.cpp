@@ -0,0 +1,745 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   LoadGen.cpp                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 05:40:12 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 05:40:12 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "LoadGen.hpp"
+#include "../net/SocketUtils.hpp"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <climits>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+
+static const unsigned long NS_PER_SEC = 1000000000UL;
+static const unsigned long NS_PER_MS = 1000000UL;
+static const unsigned long CONNECT_STALL_NS = 30 * NS_PER_SEC;	//* No client got ready for this long
+static const unsigned long DRAIN_NS = 5 * NS_PER_SEC;			//* Upper bound for in-flight lines
+static const unsigned long LATE_NS = NS_PER_MS;					//* Timer slack, not counted as latency
+static const size_t RECV_CHUNK = 64 * 1024;
+static const size_t CLOSE_REPORTS = 5;
+static const size_t METRICS_LIMIT = 1024 * 1024;					//* Bytes read from the metrics page
+static const int METRICS_TIMEOUT_SEC = 2;							//* Reasons printed before going quiet
+static const char MARKER[] = " :LG ";
+
+LoadGen::LoadGen(const LoadConfig& config) :
+	config_(config), backend_(NULL), addressLength_(0),
+	phase_(PHASE_CONNECT), stopRequested_(0), phaseEnd_(0), nextDue_(0),
+	interval_(config.rate ? NS_PER_SEC / config.rate : 0), cursor_(0), blocked_(false),
+	nextConnect_(0), connecting_(0), ready_(0), closed_(0),
+	measureStart_(ULONG_MAX), measureEnd_(ULONG_MAX), sent_(0), expected_(0), delivered_(0),
+	linesSent_(0), linesDelivered_(0), progressSent_(0), progressDelivered_(0), nextProgress_(0)
+{
+	std::memset(&address_, 0, sizeof(address_));
+	serverStart_.valid = false;
+	serverEnd_.valid = false;
+}
+
+LoadGen::~LoadGen()
+{
+	for (size_t i = 0; i < clients_.size(); ++i)
+		if (clients_[i].fd >= 0)
+			close(clients_[i].fd);
+	delete backend_;
+}
+
+//* ============================================================================
+//* SETUP
+//* ============================================================================
+
+bool LoadGen::run()
+{
+	//* One descriptor per client plus a few for the backend and stdio
+	struct rlimit limit;
+	rlim_t needed = static_cast<rlim_t>(config_.clients) + 64;
+	if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < needed)
+	{
+		limit.rlim_cur = std::min(needed, limit.rlim_max);
+		setrlimit(RLIMIT_NOFILE, &limit);
+		if (limit.rlim_cur < needed)
+		{
+			std::cerr << "[ERROR] " << config_.clients << " clients need " << needed
+				<< " descriptors, the hard limit is " << limit.rlim_max << " (ulimit -n)\n";
+			return (false);
+		}
+	}
+	if (!resolve())
+		return (false);
+	backend_ = EventBackend::create(config_.useEpoll, false);
+
+	Client blank;
+	blank.fd = -1;
+	blank.state = STATE_IDLE;
+	blank.joinsPending = 0;
+	blank.connectStart = 0;
+	blank.outOffset = 0;
+	blank.wantWrite = false;
+	blank.dirty = false;
+	blank.sent = 0;
+	blank.acked = 0;
+	blank.nextTarget = 0;
+	clients_.assign(config_.clients, blank);
+
+	members_.assign(config_.channels, 0);
+	for (size_t i = 0; i < clients_.size(); ++i)
+		for (unsigned long k = 0; k < config_.joins && config_.channels; ++k)
+			members_[(i + k) % config_.channels]++;
+	padding_.assign(config_.size, 'x');
+
+	std::cout << "[LOADGEN] " << config_.clients << " clients (" << config_.senders
+		<< " sending) -> " << config_.host << ":" << config_.port << ", ";
+	if (config_.channels)
+		std::cout << config_.channels << " channels x " << config_.joins << " joins";
+	else
+		std::cout << "private messages";
+	if (config_.rate)
+		std::cout << ", rate " << config_.rate << "/s";
+	else
+		std::cout << ", no rate limit";
+	std::cout << ", window " << config_.window << ", " << config_.size << "-byte lines, "
+		<< backend_->getName() << std::endl;
+
+	enterPhase(PHASE_CONNECT, LatencyHistogram::now());
+	loop();
+	return (true);
+}
+
+bool LoadGen::resolve()
+{
+	struct addrinfo hints;
+	struct addrinfo* result = NULL;
+	std::memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+
+	char port[16];
+	std::snprintf(port, sizeof(port), "%d", config_.port);
+	int status = getaddrinfo(config_.host.c_str(), port, &hints, &result);
+	if (status != 0 || !result)
+	{
+		std::cerr << "[ERROR] Cannot resolve " << config_.host << ": " << gai_strerror(status) << "\n";
+		return (false);
+	}
+	std::memcpy(&address_, result->ai_addr, result->ai_addrlen);
+	addressLength_ = result->ai_addrlen;
+	freeaddrinfo(result);
+	return (true);
+}
+
+void LoadGen::stop()
+{
+	stopRequested_ = 1;
+}
+
+//* ============================================================================
+//* MAIN LOOP
+//* ============================================================================
+
+void LoadGen::loop()
+{
+	std::vector<IoEvent> ready;
+
+	while (phase_ != PHASE_DONE)
+	{
+		unsigned long now = LatencyHistogram::now();
+
+		//* Ctrl+C: stop sending but still collect what is in flight; twice quits
+		if (stopRequested_)
+		{
+			stopRequested_ = 0;
+			bool sending = (phase_ == PHASE_WARMUP || phase_ == PHASE_MEASURE);
+			enterPhase(sending ? PHASE_DRAIN : PHASE_DONE, now);
+			continue;
+		}
+		if (phase_ == PHASE_CONNECT && ready_ + closed_ == clients_.size())
+			enterPhase(ready_ ? (config_.warmup ? PHASE_WARMUP : PHASE_MEASURE) : PHASE_DONE, now);
+		else if (now >= phaseEnd_)
+		{
+			if (phase_ == PHASE_CONNECT)
+				std::cerr << "[ERROR] No client finished registering for "
+					<< CONNECT_STALL_NS / NS_PER_SEC << " s, giving up\n";
+			enterPhase(phase_ == PHASE_WARMUP ? PHASE_MEASURE
+				: phase_ == PHASE_MEASURE ? PHASE_DRAIN : PHASE_DONE, now);
+		}
+		else if (phase_ == PHASE_DRAIN && delivered_ >= expected_)
+			enterPhase(PHASE_DONE, now);
+		if (phase_ == PHASE_DONE)
+			break;
+
+		if (phase_ == PHASE_CONNECT)
+			startConnections(now);
+		else if (phase_ == PHASE_WARMUP || phase_ == PHASE_MEASURE)
+			sendDue(now);
+		flush();
+		progress(now);
+
+		int count = backend_->wait(ready, waitTimeout(now));
+		if (count < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			std::cerr << "[ERROR] " << backend_->getName() << " wait failed: "
+				<< std::strerror(errno) << "\n";
+			break;
+		}
+		now = LatencyHistogram::now();
+		for (size_t i = 0; i < ready.size(); ++i)
+		{
+			int fd = ready[i].fd;
+			if (fd < 0 || static_cast<size_t>(fd) >= fdToClient_.size() || fdToClient_[fd] < 0)
+				continue;
+			size_t index = static_cast<size_t>(fdToClient_[fd]);
+			short events = ready[i].events;
+			if (clients_[index].state == STATE_CONNECTING)
+			{
+				onConnected(index, now);
+				continue;
+			}
+			if (events & (POLLIN | POLLERR | POLLHUP))
+				onReadable(index, now);
+			if ((events & POLLOUT) && clients_[index].fd >= 0)
+				flushClient(index);
+		}
+	}
+}
+
+void LoadGen::enterPhase(Phase phase, unsigned long now)
+{
+	Phase previous = phase_;
+	phase_ = phase;
+	switch (phase)
+	{
+		case PHASE_CONNECT:
+			phaseEnd_ = now + CONNECT_STALL_NS;
+			break;
+		case PHASE_WARMUP:
+		case PHASE_MEASURE:
+			if (previous == PHASE_CONNECT)
+			{
+				std::cout << "[LOADGEN] " << ready_ << " clients ready";
+				if (closed_)
+					std::cout << " (" << closed_ << " failed)";
+				std::cout << ", registration ";
+				registration_.print(std::cout);
+				std::cout << std::endl;
+				nextDue_ = now;
+				nextProgress_ = now + config_.interval * NS_PER_SEC;
+			}
+			if (phase == PHASE_WARMUP)
+				phaseEnd_ = now + config_.warmup * NS_PER_SEC;
+			else
+			{
+				measureStart_ = now;
+				phaseEnd_ = now + config_.duration * NS_PER_SEC;
+				if (config_.metricsPort)
+					serverStart_ = sampleServer();
+			}
+			//* Without a rate every sender fills its window, then each
+			//* delivery lets its sender put one more line in flight
+			if (previous == PHASE_CONNECT && !interval_)
+				for (size_t i = 0; i < config_.senders; ++i)
+					while (sendOne(i, now))
+						;
+			break;
+		case PHASE_DRAIN:
+			measureEnd_ = std::min(now, measureEnd_);
+			if (measureStart_ == ULONG_MAX)
+				measureStart_ = now;
+			phaseEnd_ = now + DRAIN_NS;
+			break;
+		case PHASE_DONE:
+			if (serverStart_.valid)
+				serverEnd_ = sampleServer();
+			break;
+	}
+}
+
+int LoadGen::waitTimeout(unsigned long now) const
+{
+	unsigned long until = std::min(phaseEnd_, now + NS_PER_SEC);
+	if (phase_ == PHASE_CONNECT)
+		until = std::min(until, now + 100 * NS_PER_MS);
+	if (phase_ == PHASE_WARMUP || phase_ == PHASE_MEASURE)
+	{
+		if (config_.interval)
+			until = std::min(until, nextProgress_);
+		if (interval_ && !blocked_)
+			until = std::min(until, nextDue_);
+	}
+	if (until <= now)
+		return (0);
+	return (static_cast<int>((until - now + NS_PER_MS - 1) / NS_PER_MS));
+}
+
+//* ============================================================================
+//* CONNECTIONS
+//* ============================================================================
+
+void LoadGen::startConnections(unsigned long now)
+{
+	while (connecting_ < config_.connectBatch && nextConnect_ < clients_.size())
+	{
+		size_t index = nextConnect_++;
+		Client& client = clients_[index];
+		client.connectStart = now;
+		client.fd = socket(address_.ss_family, SOCK_STREAM, 0);
+		if (client.fd < 0)
+		{
+			closeClient(index, std::strerror(errno));
+			continue;
+		}
+		if (static_cast<size_t>(client.fd) >= fdToClient_.size())
+			fdToClient_.resize(client.fd + 1, -1);
+		fdToClient_[client.fd] = static_cast<int>(index);
+		client.state = STATE_CONNECTING;
+		connecting_++;
+
+		//* Lines are tiny and latency is the point: no Nagle delay
+		SocketUtils::setNoDelay(client.fd);
+		if (!SocketUtils::setNonBlocking(client.fd))
+		{
+			closeClient(index, "fcntl() failed");
+			continue;
+		}
+		if (connect(client.fd, reinterpret_cast<struct sockaddr*>(&address_), addressLength_) < 0
+			&& errno != EINPROGRESS)
+		{
+			closeClient(index, std::strerror(errno));
+			continue;
+		}
+		if (!backend_->add(client.fd, POLLOUT))
+			closeClient(index, "cannot watch the socket");
+	}
+}
+
+void LoadGen::onConnected(size_t index, unsigned long now)
+{
+	Client& client = clients_[index];
+	int error = 0;
+	socklen_t length = sizeof(error);
+	if (getsockopt(client.fd, SOL_SOCKET, SO_ERROR, &error, &length) < 0)
+		error = errno;
+	if (error)
+	{
+		closeClient(index, std::strerror(error));
+		return;
+	}
+	(void)now;
+	client.state = STATE_REGISTERING;
+	backend_->modify(client.fd, POLLIN);
+	std::string name = nick(index);
+	queue(index, "PASS " + config_.password + "\r\nNICK " + name
+		+ "\r\nUSER " + name + " 0 * :loadgen\r\n");
+}
+
+void LoadGen::closeClient(size_t index, const char* reason)
+{
+	Client& client = clients_[index];
+	if (client.state == STATE_CLOSED)
+		return;
+	if (client.state == STATE_READY)
+		ready_--;
+	else if (client.state != STATE_IDLE)
+		connecting_--;
+	if (client.fd >= 0)
+	{
+		backend_->remove(client.fd);
+		fdToClient_[client.fd] = -1;
+		close(client.fd);
+		client.fd = -1;
+	}
+	client.state = STATE_CLOSED;
+	client.out.clear();
+	client.in.clear();
+	if (closed_++ < CLOSE_REPORTS)
+		std::cerr << "[LOADGEN] " << nick(index) << " lost: " << reason << "\n";
+	else if (closed_ == CLOSE_REPORTS + 1)
+		std::cerr << "[LOADGEN] more connections lost, counting them silently\n";
+}
+
+//* ============================================================================
+//* INPUT
+//* ============================================================================
+
+void LoadGen::onReadable(size_t index, unsigned long now)
+{
+	static char buffer[RECV_CHUNK];
+	Client& client = clients_[index];
+
+	ssize_t n = recv(client.fd, buffer, sizeof(buffer), 0);
+	if (n == 0)
+		return (closeClient(index, "connection closed by the server"));
+	if (n < 0)
+	{
+		if (!SocketUtils::isWouldBlock() && errno != EINTR)
+			closeClient(index, std::strerror(errno));
+		return;
+	}
+
+	client.in.append(buffer, static_cast<size_t>(n));
+	size_t start = 0;
+	size_t end;
+	while ((end = client.in.find('\n', start)) != std::string::npos)
+	{
+		size_t length = end - start;
+		if (length && client.in[end - 1] == '\r')
+			length--;
+		onLine(index, client.in.data() + start, length, now);
+		if (client.state == STATE_CLOSED)
+			return;
+		start = end + 1;
+	}
+	client.in.erase(0, start);
+}
+
+void LoadGen::onLine(size_t index, const char* line, size_t length, unsigned long now)
+{
+	Client& client = clients_[index];
+	const char* last = line + length;
+
+	//* Hot path: a measured PRIVMSG (any prefix or colors before the text)
+	const char* payload = std::search(line, last, MARKER, MARKER + sizeof(MARKER) - 1);
+	if (payload != last)
+		return (onDelivery(payload + sizeof(MARKER) - 1, now));
+
+	if (length > 5 && std::memcmp(line, "PING ", 5) == 0)
+		return (queue(index, "PONG " + std::string(line + 5, length - 5) + "\r\n"));
+	if (length > 6 && std::memcmp(line, "ERROR ", 6) == 0)
+		return (closeClient(index, std::string(line, length).c_str()));
+
+	//* ":server NNN ..." numerics drive registration and joins
+	if (line[0] != ':')
+		return;
+	const char* space = std::find(line, last, ' ');
+	if (last - space < 5 || space[4] != ' ')
+		return;
+	std::string numeric(space + 1, 3);
+	if (numeric == "001" && client.state == STATE_REGISTERING)
+	{
+		registration_.recordOwned(now - client.connectStart);
+		client.state = STATE_JOINING;
+		client.joinsPending = config_.channels ? config_.joins : 0;
+		for (unsigned long k = 0; k < client.joinsPending; ++k)
+			queue(index, "JOIN " + channel((index + k) % config_.channels) + "\r\n");
+	}
+	else if (numeric == "366" && client.state == STATE_JOINING && client.joinsPending)
+		client.joinsPending--;
+	else if (numeric[0] == '4' && client.state != STATE_READY)
+		return (closeClient(index, std::string(line, length).c_str()));
+
+	if (client.state == STATE_JOINING && client.joinsPending == 0)
+	{
+		client.state = STATE_READY;
+		connecting_--;
+		ready_++;
+		phaseEnd_ = now + CONNECT_STALL_NS;
+	}
+}
+
+//* "LG <sender> <seq> <stamp>": acknowledge the sender and time the line
+void LoadGen::onDelivery(const char* payload, unsigned long now)
+{
+	char* end;
+	unsigned long sender = std::strtoul(payload, &end, 10);
+	unsigned long seq = std::strtoul(end, &end, 10);
+	unsigned long stamp = std::strtoul(end, &end, 10);
+	if (sender >= clients_.size())
+		return;
+
+	unsigned long latency = (now > stamp) ? now - stamp : 0;
+	linesDelivered_++;
+	progressLatency_.recordOwned(latency);
+	if (stamp >= measureStart_ && stamp < measureEnd_)
+	{
+		delivered_++;
+		latency_.recordOwned(latency);
+	}
+
+	Client& client = clients_[sender];
+	if (seq <= client.acked)
+		return;
+	client.acked = seq;
+	blocked_ = false;
+	if (!interval_ && (phase_ == PHASE_WARMUP || phase_ == PHASE_MEASURE))
+		while (sendOne(sender, now))
+			;
+}
+
+//* ============================================================================
+//* OUTPUT
+//* ============================================================================
+
+//* Rate mode: hand every due slot to the next sender with room in its window
+void LoadGen::sendDue(unsigned long now)
+{
+	if (!interval_ || blocked_)
+		return;
+	while (nextDue_ <= now)
+	{
+		size_t tried = 0;
+		unsigned long stamp = (nextDue_ + LATE_NS < now) ? nextDue_ : now;
+		while (tried < config_.senders && !sendOne(cursor_, stamp))
+		{
+			cursor_ = (cursor_ + 1) % config_.senders;
+			tried++;
+		}
+		if (tried == config_.senders)
+		{
+			blocked_ = true;						//* Every window full: wait for a delivery
+			return;
+		}
+		if (nextDue_ >= measureStart_)
+			sendLag_.recordOwned(now - nextDue_);
+		cursor_ = (cursor_ + 1) % config_.senders;
+		nextDue_ += interval_;
+	}
+}
+
+bool LoadGen::sendOne(size_t index, unsigned long stamp)
+{
+	Client& client = clients_[index];
+	if (client.state != STATE_READY || client.sent - client.acked >= config_.window)
+		return (false);
+
+	std::string target;
+	unsigned long receivers;
+	if (config_.channels)
+	{
+		size_t slot = (index + client.nextTarget++ % config_.joins) % config_.channels;
+		target = channel(slot);
+		receivers = members_[slot] - 1;
+	}
+	else
+	{
+		target = nick((index + 1) % clients_.size());
+		receivers = 1;
+	}
+
+	char text[64];
+	int length = std::snprintf(text, sizeof(text), "LG %lu %lu %lu ",
+		static_cast<unsigned long>(index), client.sent + 1, stamp);
+	std::string line = "PRIVMSG " + target + " :";
+	line.append(text, length);
+	if (static_cast<size_t>(length) < config_.size)
+		line.append(padding_, 0, config_.size - length);
+	line += "\r\n";
+	queue(index, line);
+
+	client.sent++;
+	linesSent_++;
+	if (stamp >= measureStart_)
+	{
+		sent_++;
+		expected_ += receivers;
+	}
+	return (true);
+}
+
+void LoadGen::queue(size_t index, const std::string& text)
+{
+	Client& client = clients_[index];
+	client.out += text;
+	if (!client.dirty)
+	{
+		client.dirty = true;
+		dirty_.push_back(index);
+	}
+}
+
+//* Once per loop turn: every line queued this turn leaves in one send()
+void LoadGen::flush()
+{
+	for (size_t i = 0; i < dirty_.size(); ++i)
+		flushClient(dirty_[i]);
+	dirty_.clear();
+}
+
+void LoadGen::flushClient(size_t index)
+{
+	Client& client = clients_[index];
+	client.dirty = false;
+	if (client.fd < 0 || client.state == STATE_CONNECTING)
+		return;
+	size_t pending = client.out.size() - client.outOffset;
+	if (pending)
+	{
+		ssize_t n = send(client.fd, client.out.data() + client.outOffset, pending, MSG_NOSIGNAL);
+		if (n < 0 && !SocketUtils::isWouldBlock() && errno != EINTR)
+			return (closeClient(index, std::strerror(errno)));
+		if (n > 0)
+			client.outOffset += static_cast<size_t>(n);
+	}
+	if (client.outOffset == client.out.size())
+	{
+		client.out.clear();
+		client.outOffset = 0;
+		if (client.wantWrite)
+		{
+			client.wantWrite = false;
+			backend_->modify(client.fd, POLLIN);
+		}
+		return;
+	}
+	//* Server not reading fast enough: wait for POLLOUT
+	if (client.outOffset > client.out.size() / 2)
+	{
+		client.out.erase(0, client.outOffset);
+		client.outOffset = 0;
+	}
+	if (!client.wantWrite)
+	{
+		client.wantWrite = true;
+		backend_->modify(client.fd, POLLIN | POLLOUT);
+	}
+}
+
+//* ============================================================================
+//* REPORTING
+//* ============================================================================
+
+void LoadGen::progress(unsigned long now)
+{
+	if (!config_.interval || (phase_ != PHASE_WARMUP && phase_ != PHASE_MEASURE)
+		|| now < nextProgress_)
+		return;
+	double seconds = static_cast<double>(config_.interval);
+	std::cout << "[LOADGEN] " << (phase_ == PHASE_WARMUP ? "warmup " : "measure")
+		<< std::fixed << std::setprecision(0)
+		<< " sent/s=" << (linesSent_ - progressSent_) / seconds
+		<< " delivered/s=" << (linesDelivered_ - progressDelivered_) / seconds
+		<< " ready=" << ready_ << " latency ";
+	progressLatency_.print(std::cout);
+	std::cout << std::endl;
+	progressLatency_.reset();
+	progressSent_ = linesSent_;
+	progressDelivered_ = linesDelivered_;
+	nextProgress_ += config_.interval * NS_PER_SEC;
+}
+
+void LoadGen::report() const
+{
+	if (measureEnd_ == ULONG_MAX || measureStart_ >= measureEnd_)
+	{
+		std::cout << "[RESULT] nothing measured (" << ready_ << " of " << clients_.size()
+			<< " clients ready)" << std::endl;
+		return;
+	}
+	double seconds = static_cast<double>(measureEnd_ - measureStart_) / NS_PER_SEC;
+	std::cout << std::fixed << std::setprecision(1)
+		<< "[RESULT] measured " << seconds << " s: sent " << sent_
+		<< " (" << sent_ / seconds << "/s), delivered " << delivered_ << " of " << expected_
+		<< " (" << delivered_ / seconds << "/s), lost " << expected_ - delivered_
+		<< ", connections lost " << closed_ << "\n";
+	std::cout << "[RESULT] latency ";
+	latency_.print(std::cout);
+	if (interval_)
+	{
+		std::cout << "\n[RESULT] send lag ";
+		sendLag_.print(std::cout);
+	}
+	std::cout << "\n[RESULT] registration ";
+	registration_.print(std::cout);
+	std::cout << std::endl;
+	if (!config_.metricsPort)
+		return;
+	unsigned long lines = serverEnd_.delivered - serverStart_.delivered;
+	if (!serverStart_.valid || !serverEnd_.valid || !lines)
+	{
+		std::cout << "[RESULT] server syscalls: metrics on port " << config_.metricsPort
+			<< " unavailable" << std::endl;
+		return;
+	}
+	unsigned long writes = serverEnd_.writes - serverStart_.writes;
+	unsigned long wakeups = serverEnd_.wakeups - serverStart_.wakeups;
+	std::cout << std::setprecision(3)
+		<< "[RESULT] server syscalls per delivered line: writev " << static_cast<double>(writes) / lines
+		<< ", wakeups " << static_cast<double>(wakeups) / lines
+		<< " (" << writes << " writev, " << wakeups << " wakeups, " << lines << " lines)" << std::endl;
+}
+
+//* Same host as the IRC port. The page is small and this runs twice, so a
+//* blocking socket with a timeout is enough.
+LoadGen::ServerSample LoadGen::sampleServer() const
+{
+	ServerSample sample;
+	sample.valid = false;
+	sample.writes = 0;
+	sample.wakeups = 0;
+	sample.delivered = linesDelivered_;
+
+	struct sockaddr_storage address = address_;
+	if (address.ss_family == AF_INET6)
+		reinterpret_cast<struct sockaddr_in6*>(&address)->sin6_port = htons(config_.metricsPort);
+	else
+		reinterpret_cast<struct sockaddr_in*>(&address)->sin_port = htons(config_.metricsPort);
+	int fd = socket(address.ss_family, SOCK_STREAM, 0);
+	if (fd < 0)
+		return (sample);
+	struct timeval timeout;
+	timeout.tv_sec = METRICS_TIMEOUT_SEC;
+	timeout.tv_usec = 0;
+	setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+	setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+	static const char request[] = "GET /metrics HTTP/1.0\r\n\r\n";
+	std::string page;
+	if (connect(fd, reinterpret_cast<struct sockaddr*>(&address), addressLength_) == 0
+		&& send(fd, request, sizeof(request) - 1, MSG_NOSIGNAL) == static_cast<ssize_t>(sizeof(request) - 1))
+	{
+		char buffer[8192];
+		ssize_t n;
+		while (page.size() < METRICS_LIMIT && (n = recv(fd, buffer, sizeof(buffer), 0)) > 0)
+			page.append(buffer, n);
+	}
+	close(fd);
+
+	size_t writes = page.find("\nircserv_writev_total ");
+	size_t wakeups = page.find("\nircserv_wakeups_total ");
+	if (writes == std::string::npos || wakeups == std::string::npos)
+		return (sample);
+	sample.writes = std::strtoul(page.c_str() + writes + std::strlen("\nircserv_writev_total "), NULL, 10);
+	sample.wakeups = std::strtoul(page.c_str() + wakeups + std::strlen("\nircserv_wakeups_total "), NULL, 10);
+	sample.valid = true;
+	return (sample);
+}
+
+int LoadGen::exitStatus() const
+{
+	if (measureEnd_ == ULONG_MAX || measureStart_ >= measureEnd_)
+		return (1);
+	if (closed_ || delivered_ < expected_)
+		return (2);
+	if (config_.maxP99 && latency_.percentile(99) > config_.maxP99 * 1000UL)
+		return (3);
+	return (0);
+}
+
+std::string LoadGen::nick(size_t index) const
+{
+	char buffer[32];
+	std::snprintf(buffer, sizeof(buffer), "%s%lu", config_.nickPrefix.c_str(),
+		static_cast<unsigned long>(index));
+	return (buffer);
+}
+
+std::string LoadGen::channel(size_t index) const
+{
+	char buffer[32];
+	std::snprintf(buffer, sizeof(buffer), "#%s%lu", config_.nickPrefix.c_str(),
+		static_cast<unsigned long>(index));
+	return (buffer);
+}
@@ -0,0 +1,168 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   LoadGen.hpp                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 05:40:12 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 05:40:12 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef LOAD_GEN_HPP
+#define LOAD_GEN_HPP
+
+#include <string>
+#include <vector>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include "LoadConfig.hpp"
+#include "../net/EventBackend.hpp"
+#include "../utils/LatencyHistogram.hpp"
+
+/**
+ * LoadGen: Closed-loop IRC load generator (one thread, non-blocking)
+ *
+ * Phases:
+ * 1. CONNECT: open --clients connections, at most --connect-batch in
+ *    progress at a time, register each with PASS/NICK/USER and JOIN its
+ *    channels. Time from connect() to 001 goes to the registration
+ *    histogram.
+ * 2. WARMUP, then MEASURE: the senders emit PRIVMSG at --rate overall.
+ *    Every line carries "LG <sender> <seq> <stamp>"; any client that
+ *    receives it records now - stamp. Senders are closed-loop: one with
+ *    --window sequence numbers not yet seen by any receiver waits.
+ * 3. DRAIN: sending stops and in-flight lines get a few seconds to land.
+ *
+ * The stamp is the time the line was *due* by the rate schedule, not the
+ * time it left, so a server that stalls the senders shows up as latency
+ * instead of silently lowering the offered load.
+ *
+ * Only lines due inside the MEASURE phase count towards the results.
+ *
+ * With --metrics-port the server's own counters are read over HTTP when
+ * MEASURE starts and once the drain is over, and the report divides its
+ * writev() calls and loop wakeups by the lines delivered in between.
+ */
+
+class LoadGen
+{
+	public:
+		explicit LoadGen(const LoadConfig& config);
+		~LoadGen();
+
+		bool	run();								//* false if the setup failed
+		void	stop();								//* Async-signal-safe: end the current phase
+		void	report() const;
+		int		exitStatus() const;					//* 0 ok, 2 lost lines/connections, 3 over --max-p99
+
+	private:
+		enum Phase
+		{
+			PHASE_CONNECT,
+			PHASE_WARMUP,
+			PHASE_MEASURE,
+			PHASE_DRAIN,
+			PHASE_DONE
+		};
+
+		enum State
+		{
+			STATE_IDLE,								//* Not connected yet
+			STATE_CONNECTING,						//* connect() in progress
+			STATE_REGISTERING,						//* Waiting for 001
+			STATE_JOINING,							//* Waiting for one 366 per channel
+			STATE_READY,
+			STATE_CLOSED
+		};
+
+		struct ServerSample
+		{
+			bool			valid;
+			unsigned long	writes;					//* ircserv_writev_total
+			unsigned long	wakeups;				//* ircserv_wakeups_total
+			unsigned long	delivered;				//* linesDelivered_ when it was taken
+		};
+
+		struct Client
+		{
+			int				fd;
+			State			state;
+			unsigned long	joinsPending;
+			unsigned long	connectStart;			//* ns, for the registration histogram
+			std::string		in;						//* Partial line from the last recv()
+			std::string		out;					//* Not written yet
+			size_t			outOffset;
+			bool			wantWrite;				//* POLLOUT registered
+			bool			dirty;					//* Already in dirty_
+			unsigned long	sent;					//* Last sequence number sent
+			unsigned long	acked;					//* Highest sequence number any receiver saw
+			unsigned long	nextTarget;				//* Round-robin over the joined channels
+		};
+
+		LoadConfig					config_;
+		EventBackend*				backend_;
+		struct sockaddr_storage		address_;
+		socklen_t					addressLength_;
+		std::vector<Client>			clients_;
+		std::vector<int>			fdToClient_;	//* fd -> index in clients_, -1 if none
+		std::vector<size_t>			dirty_;			//* Clients with output to flush
+		std::vector<unsigned long>	members_;		//* Per channel, for expected deliveries
+		std::string					padding_;		//* Fills each line up to --size
+
+		Phase						phase_;
+		volatile int				stopRequested_;
+		unsigned long				phaseEnd_;		//* ns
+		unsigned long				nextDue_;		//* ns, rate schedule
+		unsigned long				interval_;		//* ns between two lines, 0 = no rate
+		size_t						cursor_;		//* Next sender to try
+		bool						blocked_;		//* Every sender's window full
+		size_t						nextConnect_;
+		size_t						connecting_;
+		size_t						ready_;
+		size_t						closed_;
+
+		//* RESULTS
+		unsigned long				measureStart_;
+		unsigned long				measureEnd_;
+		unsigned long				sent_;			//* Measured lines sent
+		unsigned long				expected_;		//* Their deliveries, one per receiver
+		unsigned long				delivered_;
+		unsigned long				linesSent_;		//* Every phase, for the progress lines
+		unsigned long				linesDelivered_;
+		unsigned long				progressSent_;
+		unsigned long				progressDelivered_;
+		unsigned long				nextProgress_;
+		LatencyHistogram			latency_;
+		LatencyHistogram			progressLatency_;	//* Since the last progress line
+		LatencyHistogram			registration_;
+		LatencyHistogram			sendLag_;		//* Measured lines: how late they left (rate mode)
+		ServerSample				serverStart_;	//* --metrics-port, at MEASURE
+		ServerSample				serverEnd_;		//* --metrics-port, at DONE
+
+		bool	resolve();
+		void	loop();
+		void	enterPhase(Phase phase, unsigned long now);
+		void	startConnections(unsigned long now);
+		void	onConnected(size_t index, unsigned long now);
+		void	onReadable(size_t index, unsigned long now);
+		void	onLine(size_t index, const char* line, size_t length, unsigned long now);
+		void	onDelivery(const char* payload, unsigned long now);
+		void	sendDue(unsigned long now);
+		bool	sendOne(size_t index, unsigned long stamp);
+		void	queue(size_t index, const std::string& text);
+		void	flush();
+		void	flushClient(size_t index);
+		void	closeClient(size_t index, const char* reason);
+		void	progress(unsigned long now);
+		ServerSample	sampleServer() const;		//* Blocking GET of the server's metrics
+		int		waitTimeout(unsigned long now) const;
+		std::string	nick(size_t index) const;
+		std::string	channel(size_t index) const;
+
+		LoadGen(const LoadGen&);
+		LoadGen& operator=(const LoadGen&);
+};
+
+#endif
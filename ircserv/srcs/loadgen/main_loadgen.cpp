@@ -0,0 +1,94 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   main_loadgen.cpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 06:25:31 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 06:25:31 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "LoadGen.hpp"
+#include "LoadConfig.hpp"
+#include "../utils/Log.hpp"
+#include <iostream>
+#include <cstdlib>
+#include <csignal>
+
+// Same pattern as the server: the handler only raises a flag
+LoadGen* g_loadgen = NULL;
+
+void signalHandler(int signum)
+{
+    (void)signum;
+    if (g_loadgen)
+        g_loadgen->stop();
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 4)
+    {
+        std::cerr << "Usage: " << argv[0] << " <host> <port> <password> [options]\n";
+        std::cerr << "Options:\n";
+        std::cerr << "  --clients=N            connections to open (default: 1000)\n";
+        std::cerr << "  --channels=N           channels, 0 = private messages to the next client (default: 10)\n";
+        std::cerr << "  --joins=N              channels each client joins (default: 1)\n";
+        std::cerr << "  --senders=N            clients that send, 0 = all (default: 0)\n";
+        std::cerr << "  --rate=N               PRIVMSG per second overall, 0 = as fast as the window allows (default: 10000)\n";
+        std::cerr << "  --window=N             undelivered lines per sender before it waits (default: 4)\n";
+        std::cerr << "  --size=BYTES           PRIVMSG text length, 32-400 (default: 64)\n";
+        std::cerr << "  --warmup=SECS          unmeasured traffic first (default: 2)\n";
+        std::cerr << "  --duration=SECS        measured traffic (default: 10)\n";
+        std::cerr << "  --connect-batch=N      connections registering at once (default: 128)\n";
+        std::cerr << "  --interval=SECS        progress line period, 0 = off (default: 1)\n";
+        std::cerr << "  --max-p99=MICROS       exit with 3 when p99 latency is above this (default: off)\n";
+        std::cerr << "  --nick-prefix=STR      nicks and channels are <prefix><n> (default: lg)\n";
+        std::cerr << "  --backend=poll|epoll   event notification backend (default: epoll on Linux)\n";
+        std::cerr << "  --metrics-port=PORT    server's --metrics-port: report its syscalls per delivered line (default: off)\n";
+        std::cerr << "Exit status: 0 ok, 1 setup failed, 2 lines or connections lost, 3 p99 over --max-p99\n";
+        return (1);
+    }
+
+    LoadConfig config;
+    config.host = argv[1];
+    config.port = std::atoi(argv[2]);
+    config.password = argv[3];
+    if (config.port <= 0 || config.port > 65535)
+    {
+        std::cerr << "[ERROR] Invalid port number: " << argv[2] << "\n";
+        return (1);
+    }
+    for (int i = 4; i < argc; ++i)
+    {
+        std::string error;
+        if (!config.parseOption(argv[i], error))
+        {
+            std::cerr << "[ERROR] " << error << "\n";
+            return (1);
+        }
+    }
+    std::string error;
+    if (!config.validate(error))
+    {
+        std::cerr << "[ERROR] " << error << "\n";
+        return (1);
+    }
+
+    // Shared socket code only logs failures
+    Log::setLevel(Log::LEVEL_WARN);
+    signal(SIGINT, signalHandler);
+    signal(SIGTERM, signalHandler);
+    signal(SIGPIPE, SIG_IGN);
+
+    LoadGen loadgen(config);
+    g_loadgen = &loadgen;
+    bool started = loadgen.run();
+    g_loadgen = NULL;
+    if (!started)
+        return (1);
+    loadgen.report();
+    return (loadgen.exitStatus());
+}
@@ -11,6 +11,8 @@
 /* ************************************************************************** */
 
 #include "server/Server.hpp"
+#include "server/ServerConfig.hpp"
+#include "utils/Log.hpp"
 #include <iostream>
 #include <cstdlib>
 #include <csignal>
@@ -32,6 +34,15 @@ void signalHandler(int signum)
     }
 }
 
+// SIGUSR1: print live statistics (accept latency, loop load) to stdout.
+// Same rules as above: the server only sets a flag and wakes a loop.
+void statsSignalHandler(int signum)
+{
+    (void)signum;
+    if (g_server)
+        g_server->requestStatsDump();
+}
+
 bool isValidPort(int port)
 {
     return (port > 1024 && port < 65536);
@@ -40,11 +51,32 @@ bool isValidPort(int port)
 int main(int argc, char **argv)
 {
     //* ARGUMENT VALIDATION
-    if (argc != 3) 
+    if (argc < 3) 
     {
-        std::cerr << "Usage: " << argv[0] << " <port> <password>\n";
+        std::cerr << "Usage: " << argv[0] << " <port> <password> [options]\n";
         std::cerr << "  port: 1025-65535\n";
         std::cerr << "  password: connection password\n";
+        std::cerr << "Options:\n";
+        std::cerr << "  --backend=poll|epoll   event notification backend (default: epoll on Linux)\n";
+        std::cerr << "  --edge-triggered       use edge-triggered epoll\n";
+        std::cerr << "  --threads=N            event loop threads, 1-64 (default: 1)\n";
+        std::cerr << "  --acceptor-thread      accept on a dedicated thread, hand off to the loops\n";
+        std::cerr << "  --sendq-low=BYTES      resume reading a client below this (default: 131072)\n";
+        std::cerr << "  --sendq-high=BYTES     stop reading, drop low-priority output (default: 524288)\n";
+        std::cerr << "  --sendq-max=BYTES      disconnect with \"SendQ exceeded\" (default: 4194304)\n";
+        std::cerr << "  --line-budget=N        lines run per client per loop turn (default: 32)\n";
+        std::cerr << "  --flood-rate=N         command tokens per second per client, 0 = off (default: 0)\n";
+        std::cerr << "  --flood-burst=N        token bucket size (default: 10)\n";
+        std::cerr << "  --recvq-max=BYTES      unexecuted input before \"Excess Flood\" (default: 8192)\n";
+        std::cerr << "  --ping-interval=SECS   idle time before the server sends PING (default: 120)\n";
+        std::cerr << "  --ping-timeout=SECS    time to answer it before \"Ping timeout\" (default: 60)\n";
+        std::cerr << "  --registration-timeout=SECS  time to complete PASS/NICK/USER (default: 60)\n";
+        std::cerr << "  --max-unregistered-per-ip=N  unregistered connections per address, 0 = no cap (default: 0)\n";
+        std::cerr << "  --format=color|rfc     ANSI-colored or plain protocol lines (default: color)\n";
+        std::cerr << "  --log-level=LEVEL      error, warn, info or debug (default: info)\n";
+        std::cerr << "  --oper-password=PASS   enable OPER (STATS and extended LUSERS) with this password\n";
+        std::cerr << "  --metrics-port=PORT    Prometheus metrics on 127.0.0.1:PORT\n";
+        std::cerr << "  --metrics-socket=PATH  Prometheus metrics on a Unix socket\n";
         return (1);
     }
     
@@ -59,32 +91,56 @@ int main(int argc, char **argv)
         std::cerr << "[ERROR] Password cannot be empty\n";
         return (1);
     }
+
+    //* OPTIONAL SETTINGS (--key=value)
+    ServerConfig config;
+    config.port = port;
+    config.password = password;
+    for (int i = 3; i < argc; ++i)
+    {
+        std::string error;
+        if (!config.parseOption(argv[i], error)) {
+            std::cerr << "[ERROR] " << error << "\n";
+            return (1);
+        }
+    }
+    std::string error;
+    if (!config.validate(error)) {
+        std::cerr << "[ERROR] " << error << "\n";
+        return (1);
+    }
     
     //* CONFIGURE SIGNALS
     // SIGINT (Ctrl+C) and SIGTERM are standard termination signals
     signal(SIGINT, signalHandler);
     signal(SIGTERM, signalHandler);
+    signal(SIGUSR1, statsSignalHandler);
     
+    //* LOGGING: from here on lines are written by a background thread
+    Log::setLevel(config.logLevel);
+    if (!Log::start())
+        std::cerr << "[WARN] Could not start the log thread, logging synchronously\n";
+
     // SIGPIPE is crucial in network servers. If a client closes the connection
     // while we try to write to it, the OS sends SIGPIPE which crashes the program
     // by default. SIG_IGN makes send() return error (EPIPE) instead.
     signal(SIGPIPE, SIG_IGN);
     
     //* CREATE AND START SERVER
-    g_server = new Server(port, password);
+    g_server = new Server(config);
     
     if (!g_server->start()) {
-        std::cerr << "[FATAL] Could not start server\n";
+        LOG_ERROR("[FATAL] Could not start server");
         delete g_server; // Early cleanup if startup fails
+        Log::stop();
         return (1);
     }
     
-    std::cout << "\n";
-    std::cout << "╔══════════════════════════════════════╗\n";
-    std::cout << "║   IRC SERVER STARTED                 ║\n";
-    std::cout << "║   Port: " << port << "               ║\n";
-    std::cout << "║   Press Ctrl+C to exit               ║\n";
-    std::cout << "╚══════════════════════════════════════╝\n\n";
+    LOG_INFO("\n╔══════════════════════════════════════╗\n"
+             "║   IRC SERVER STARTED                 ║\n"
+             "║   Port: " << port << "               ║\n"
+             "║   Press Ctrl+C to exit               ║\n"
+             "╚══════════════════════════════════════╝\n");
     
     // Program will block here inside the while(running_) loop
     g_server->run(); 
@@ -93,10 +149,11 @@ int main(int argc, char **argv)
     // When g_server->stop() is called (by signal), run() terminates and we reach here.
     // It's safe to do delete and cout here because we're in the main thread,
     // not inside the signal interrupt.
-    std::cout << "\n[MAIN] Stopping server..." << std::endl;
+    LOG_INFO("\n[MAIN] Stopping server...");
     delete g_server;
     g_server = NULL;
     
-    std::cout << "[MAIN] Server stopped cleanly." << std::endl;
+    LOG_INFO("[MAIN] Server stopped cleanly.");
+    Log::stop(); // Every loop is joined: the last lines are written here
     return (0);
 }
\ No newline at end of file
@@ -0,0 +1,160 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   EpollBackend.cpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 10:31:15 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 10:31:15 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifdef __linux__
+
+#include "EpollBackend.hpp"
+#include "../utils/Colors.hpp"
+#include "../utils/Log.hpp"
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+
+//* Upper bound of events fetched per epoll_wait(); the rest stay queued in the kernel
+static const size_t MAX_EVENTS_PER_WAIT = 1024;
+
+EpollBackend::EpollBackend(bool edge_triggered) : epoll_fd_(-1),
+	edge_triggered_(edge_triggered), events_(64), watched_(0)
+{
+	epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+	if (epoll_fd_ < 0)
+		LOG_ERROR(BRIGHT_RED << "[EVENT] epoll_create1() failed: " << strerror(errno) << RESET);
+}
+
+EpollBackend::~EpollBackend()
+{
+	if (epoll_fd_ >= 0)
+		close(epoll_fd_);
+}
+
+bool EpollBackend::isValid() const
+{
+	return (epoll_fd_ >= 0);
+}
+
+const char* EpollBackend::getName() const
+{
+	return (edge_triggered_ ? "epoll (edge-triggered)" : "epoll");
+}
+
+bool EpollBackend::isEdgeTriggered() const
+{
+	return (edge_triggered_);
+}
+
+//* ============================================================================
+//* FLAG TRANSLATION (poll vocabulary <-> epoll)
+//* ============================================================================
+
+uint32_t EpollBackend::toEpoll(short events) const
+{
+	uint32_t ev = 0;
+	if (events & POLLIN)
+		ev |= EPOLLIN;
+	if (events & POLLOUT)
+		ev |= EPOLLOUT;
+	if (edge_triggered_)
+		ev |= EPOLLET;
+	return (ev);									//* EPOLLERR / EPOLLHUP are always reported
+}
+
+short EpollBackend::fromEpoll(uint32_t events)
+{
+	short ev = 0;
+	if (events & EPOLLIN)
+		ev |= POLLIN;
+	if (events & EPOLLOUT)
+		ev |= POLLOUT;
+	if (events & EPOLLERR)
+		ev |= POLLERR;
+	if (events & EPOLLHUP)
+		ev |= POLLHUP;
+	return (ev);
+}
+
+//* ============================================================================
+//* INTEREST MANAGEMENT
+//* ============================================================================
+
+bool EpollBackend::add(int fd, short events)
+{
+	return (insert(fd, toEpoll(events)));
+}
+
+//* Never EPOLLET: accept() errors must not strand the backlog
+bool EpollBackend::addListener(int fd)
+{
+	return (insert(fd, EPOLLIN));
+}
+
+bool EpollBackend::insert(int fd, uint32_t events)
+{
+	struct epoll_event ev;
+	std::memset(&ev, 0, sizeof(ev));
+	ev.events = events;
+	ev.data.fd = fd;
+	if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) < 0)
+	{
+		LOG_ERROR(BRIGHT_RED << "[EVENT] epoll_ctl(ADD, fd=" << fd << ") failed: "
+				  << strerror(errno) << RESET);
+		return (false);
+	}
+	watched_++;
+	return (true);
+}
+
+bool EpollBackend::modify(int fd, short events)
+{
+	struct epoll_event ev;
+	std::memset(&ev, 0, sizeof(ev));
+	ev.events = toEpoll(events);
+	ev.data.fd = fd;
+	return (epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &ev) == 0);
+}
+
+void EpollBackend::remove(int fd)
+{
+	struct epoll_event ev;							//* Non-NULL for pre-2.6.9 kernels
+	std::memset(&ev, 0, sizeof(ev));
+	if (epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, &ev) == 0 && watched_ > 0)
+		watched_--;
+}
+
+//* ============================================================================
+//* WAIT
+//* ============================================================================
+
+int EpollBackend::wait(std::vector<IoEvent>& ready, int timeout_ms)
+{
+	ready.clear();
+
+	//* Grow the scratch array with the number of watched fds (bounded)
+	size_t wanted = watched_ < MAX_EVENTS_PER_WAIT ? watched_ : MAX_EVENTS_PER_WAIT;
+	if (wanted > events_.size())
+		events_.resize(wanted);
+
+	int n = epoll_wait(epoll_fd_, &events_[0], (int)events_.size(), timeout_ms);
+	if (n <= 0)
+		return (n);
+
+	ready.reserve(n);
+	for (int i = 0; i < n; ++i)
+	{
+		IoEvent ev;
+		ev.fd = events_[i].data.fd;
+		ev.events = fromEpoll(events_[i].events);
+		ready.push_back(ev);
+	}
+	return (n);
+}
+
+#endif
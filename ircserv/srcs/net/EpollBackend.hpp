@@ -0,0 +1,62 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   EpollBackend.hpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 10:31:15 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 10:31:15 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef EPOLL_BACKEND_HPP
+#define EPOLL_BACKEND_HPP
+
+#ifdef __linux__
+
+#include "EventBackend.hpp"
+#include <vector>
+#include <sys/epoll.h>
+
+/**
+ * EpollBackend: epoll() implementation of EventBackend (Linux only)
+ *
+ * Interest lives in the kernel, so wait() costs O(ready fds) instead of
+ * O(total fds). With edge_triggered every registration carries EPOLLET
+ * and the server must drain sockets until EAGAIN.
+ */
+
+class EpollBackend : public EventBackend
+{
+	public:
+		explicit EpollBackend(bool edge_triggered);
+		virtual ~EpollBackend();
+
+		bool				isValid() const;
+
+		virtual const char*	getName() const;
+		virtual bool		add(int fd, short events);
+		virtual bool		modify(int fd, short events);
+		virtual void		remove(int fd);
+		virtual bool		addListener(int fd);
+		virtual int			wait(std::vector<IoEvent>& ready, int timeout_ms);
+		virtual bool		isEdgeTriggered() const;
+
+	private:
+		int								epoll_fd_;
+		bool							edge_triggered_;
+		std::vector<struct epoll_event>	events_;	//* Scratch array for epoll_wait()
+		size_t							watched_;	//* Registered fds (sizes events_)
+
+		bool		insert(int fd, uint32_t events);
+		uint32_t	toEpoll(short events) const;
+		static short fromEpoll(uint32_t events);
+
+		EpollBackend(const EpollBackend&);
+		EpollBackend& operator=(const EpollBackend&);
+};
+
+#endif
+
+#endif
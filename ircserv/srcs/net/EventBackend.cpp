@@ -0,0 +1,50 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   EventBackend.cpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 10:20:03 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 10:20:03 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "EventBackend.hpp"
+#include "PollBackend.hpp"
+#include "EpollBackend.hpp"
+#include "../utils/Colors.hpp"
+#include "../utils/Log.hpp"
+
+EventBackend::~EventBackend()
+{
+}
+
+bool EventBackend::addListener(int fd)
+{
+	return (add(fd, POLLIN));
+}
+
+bool EventBackend::isEdgeTriggered() const
+{
+	return (false);
+}
+
+EventBackend* EventBackend::create(bool use_epoll, bool edge_triggered)
+{
+#ifdef __linux__
+	if (use_epoll)
+	{
+		EpollBackend* epoll_backend = new EpollBackend(edge_triggered);
+		if (epoll_backend->isValid())
+			return (epoll_backend);
+		delete epoll_backend;
+		LOG_WARN(YELLOW << "[EVENT] epoll unavailable, falling back to poll()" << RESET);
+	}
+#else
+	if (use_epoll)
+		LOG_WARN(YELLOW << "[EVENT] epoll not supported on this platform, using poll()" << RESET);
+#endif
+	(void)edge_triggered;
+	return (new PollBackend());
+}
@@ -0,0 +1,89 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   EventBackend.hpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 10:20:03 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 10:20:03 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef EVENT_BACKEND_HPP
+#define EVENT_BACKEND_HPP
+
+#include <vector>
+#include <poll.h>
+
+/**
+ * EventBackend: Readiness notification abstraction used by Server::run()
+ *
+ * Interest and readiness are always expressed with the poll() flags
+ * (POLLIN, POLLOUT, POLLERR, POLLHUP, POLLNVAL) so the server code is
+ * the same whichever kernel interface is underneath.
+ *
+ * Implementations:
+ * - PollBackend:  poll(), portable fallback (O(total fds) per wait)
+ * - EpollBackend: epoll(), Linux only, O(ready fds) per wait and
+ *                 optionally edge-triggered
+ */
+
+struct IoEvent
+{
+	int		fd;
+	short	events;									//* Ready flags (POLLIN | POLLOUT | ...)
+};
+
+class EventBackend
+{
+	public:
+		virtual ~EventBackend();
+
+		virtual const char*	getName() const = 0;
+
+		/**
+		 * Register / update / drop interest for a descriptor
+		 *
+		 * @param fd Descriptor to watch
+		 * @param events Interest mask (POLLIN and/or POLLOUT)
+		 * @return true on success, false on error
+		 */
+		virtual bool		add(int fd, short events) = 0;
+		virtual bool		modify(int fd, short events) = 0;
+		virtual void		remove(int fd) = 0;
+
+		/**
+		 * Register a listening socket for POLLIN, level-triggered even on an
+		 * edge-triggered backend: a backlog left behind by a failed accept()
+		 * is reported again on the next wait instead of waiting for a new
+		 * connection to produce an edge
+		 *
+		 * @param fd Listening socket
+		 * @return true on success, false on error
+		 */
+		virtual bool		addListener(int fd);
+
+		/**
+		 * Block until at least one descriptor is ready
+		 *
+		 * @param ready [OUT] Cleared, then filled with the ready descriptors only
+		 * @param timeout_ms Milliseconds to wait, -1 = forever
+		 * @return Number of ready descriptors, -1 on error (check errno)
+		 */
+		virtual int			wait(std::vector<IoEvent>& ready, int timeout_ms) = 0;
+
+		/**
+		 * True when readiness is only reported on transitions, so callers
+		 * must drain recv()/accept() until EAGAIN
+		 */
+		virtual bool		isEdgeTriggered() const;
+
+		/**
+		 * Build the requested backend. Falls back to poll() when epoll is
+		 * not available on this platform or cannot be created.
+		 */
+		static EventBackend* create(bool use_epoll, bool edge_triggered);
+};
+
+#endif
@@ -0,0 +1,95 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   PollBackend.cpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 10:24:37 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 10:24:37 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "PollBackend.hpp"
+#include <cstddef>
+
+PollBackend::PollBackend()
+{
+}
+
+PollBackend::~PollBackend()
+{
+}
+
+const char* PollBackend::getName() const
+{
+	return ("poll");
+}
+
+int PollBackend::find(int fd) const
+{
+	if (fd < 0 || (size_t)fd >= index_.size())
+		return (-1);
+	return (index_[fd]);
+}
+
+bool PollBackend::add(int fd, short events)
+{
+	if (fd < 0 || find(fd) >= 0)
+		return (false);
+	if ((size_t)fd >= index_.size())
+		index_.resize(fd + 1, -1);
+	index_[fd] = (int)poll_fds_.size();
+
+	struct pollfd pfd;
+	pfd.fd = fd;                    //* File descriptor to monitor
+	pfd.events = events;            //* Interest mask (POLLIN / POLLOUT)
+	pfd.revents = 0;                //* Filled by poll()
+	poll_fds_.push_back(pfd);
+	return (true);
+}
+
+bool PollBackend::modify(int fd, short events)
+{
+	int pos = find(fd);
+	if (pos < 0)
+		return (false);
+	poll_fds_[pos].events = events;
+	return (true);
+}
+
+//* Swap-and-pop: the last pollfd takes the freed position
+void PollBackend::remove(int fd)
+{
+	int pos = find(fd);
+	if (pos < 0)
+		return;
+	poll_fds_[pos] = poll_fds_.back();
+	index_[poll_fds_[pos].fd] = pos;
+	poll_fds_.pop_back();
+	index_[fd] = -1;
+}
+
+int PollBackend::wait(std::vector<IoEvent>& ready, int timeout_ms)
+{
+	ready.clear();
+	if (poll_fds_.empty())
+		return (0);
+
+	int poll_count = poll(&poll_fds_[0], poll_fds_.size(), timeout_ms);
+	if (poll_count <= 0)
+		return (poll_count);
+
+	//* Collect only the entries poll() flagged, stop once all are found
+	for (size_t i = 0; i < poll_fds_.size() && (int)ready.size() < poll_count; ++i)
+	{
+		if (poll_fds_[i].revents == 0)
+			continue;
+		IoEvent ev;
+		ev.fd = poll_fds_[i].fd;
+		ev.events = poll_fds_[i].revents;
+		poll_fds_[i].revents = 0;
+		ready.push_back(ev);
+	}
+	return ((int)ready.size());
+}
@@ -0,0 +1,53 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   PollBackend.hpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 10:24:37 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 10:24:37 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef POLL_BACKEND_HPP
+#define POLL_BACKEND_HPP
+
+#include "EventBackend.hpp"
+#include <vector>
+#include <poll.h>
+
+/**
+ * PollBackend: poll() implementation of EventBackend
+ *
+ * Keeps the classic pollfd array. Every wait() hands the whole array to
+ * the kernel and scans it afterwards, so it is O(total fds); only the
+ * ready entries are reported back to the caller.
+ *
+ * An fd -> position index makes modify() and remove() O(1); removal
+ * moves the last pollfd into the freed slot (order is irrelevant).
+ */
+
+class PollBackend : public EventBackend
+{
+	public:
+		PollBackend();
+		virtual ~PollBackend();
+
+		virtual const char*	getName() const;
+		virtual bool		add(int fd, short events);
+		virtual bool		modify(int fd, short events);
+		virtual void		remove(int fd);
+		virtual int			wait(std::vector<IoEvent>& ready, int timeout_ms);
+
+	private:
+		std::vector<struct pollfd> poll_fds_;
+		std::vector<int> index_;					//* fd -> position in poll_fds_, -1 = not watched
+
+		int			find(int fd) const;
+
+		PollBackend(const PollBackend&);
+		PollBackend& operator=(const PollBackend&);
+};
+
+#endif
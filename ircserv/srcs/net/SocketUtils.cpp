@@ -12,13 +12,17 @@
 
 #include "SocketUtils.hpp"
 #include "../utils/Colors.hpp"
-#include <iostream>
+#include "../utils/Log.hpp"
 #include <cerrno>
 #include <unistd.h>
 #include <fcntl.h>
 #include <cstring>
 #include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
+#include <sys/un.h>
+#include <sys/stat.h>
 
 //* ========================================
 //* SOCKET CONFIGURATION
@@ -30,12 +34,12 @@ bool	SocketUtils::setNonBlocking(int fd)
 	int flags = fcntl(fd, F_GETFL, 0); 					//* "fcntl is used to manipulated FDs, in this case in F_GETFL mode is to see the status of FDs"
 	if (flags == -1)
 	{
-		std::cerr << BRIGHT_RED << "[SOCKET] fcntl(F_GETFL) failed: " << strerror(errno) << RESET << std::endl;
+		LOG_ERROR(BRIGHT_RED << "[SOCKET] fcntl(F_GETFL) failed: " << strerror(errno) << RESET);
 		return (false);
 	}
 	if (fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1) 	//* "fcntl is used to manipulated FDs, in this case in F_SETFL mode is too set the status of FDs"
 	{
-		std::cerr << BRIGHT_RED << "[SOCKET] fcntl(F_SETFL, O_NONBLOCK) failed: " << strerror(errno) << RESET << std::endl;
+		LOG_ERROR(BRIGHT_RED << "[SOCKET] fcntl(F_SETFL, O_NONBLOCK) failed: " << strerror(errno) << RESET);
 		return (false);
 	}
 	return (true);
@@ -70,17 +74,61 @@ bool	SocketUtils::setReuseAddr(int fd)
 
 	if (setsockopt(fd, SOL_SOCKET,  SO_REUSEADDR, &opt, sizeof(opt)) == -1)
 	{
-		std::cerr << BRIGHT_RED << "[SOCKET] setsockopt(SO_REUSEADDR) failed: " << strerror(errno) << RESET << std::endl;
+		LOG_ERROR(BRIGHT_RED << "[SOCKET] setsockopt(SO_REUSEADDR) failed: " << strerror(errno) << RESET);
         return (false);
 	}
 	return (true);
 }
 
+//* ========================================
+//* SO_REUSEPORT: One port, several listening sockets
+//* ========================================
+//* Each event loop thread binds its own socket to the same port and the
+//* kernel load-balances new connections between them, so accept() never
+//* becomes a shared bottleneck between threads.
+//* ========================================
+bool	SocketUtils::setReusePort(int fd)
+{
+#ifdef SO_REUSEPORT
+	int opt = 1;
+
+	if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) == -1)
+	{
+		LOG_ERROR(BRIGHT_RED << "[SOCKET] setsockopt(SO_REUSEPORT) failed: " << strerror(errno) << RESET);
+		return (false);
+	}
+	return (true);
+#else
+	(void)fd;
+	LOG_ERROR(BRIGHT_RED << "[SOCKET] SO_REUSEPORT is not supported on this platform" << RESET);
+	return (false);
+#endif
+}
+
+//* ========================================
+//* TCP_NODELAY: No Nagle delay on small writes
+//* ========================================
+//* Output is already batched into one writev() per client per loop turn,
+//* so holding a short line back until the previous segment is ACKed only
+//* adds latency: a quiet reader delays its ACK and gets every line late.
+//* ========================================
+bool	SocketUtils::setNoDelay(int fd)
+{
+	int opt = 1;
+
+	if (setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt)) == -1)
+	{
+		LOG_ERROR(BRIGHT_RED << "[SOCKET] setsockopt(TCP_NODELAY) failed: " << strerror(errno) << RESET);
+		return (false);
+	}
+	return (true);
+}
+
 //* ========================================
 //* SERVER SOCKET CREATION
 //* ========================================
 
-int		SocketUtils::createServerSocket()
+int		SocketUtils::createServerSocket(bool reusePort)
 {
 	//* CREATE A SOCKET -->
 	//* AF_INET = IPv4 (DOMAIN)
@@ -89,21 +137,26 @@ int		SocketUtils::createServerSocket()
 	int fd = socket(AF_INET, SOCK_STREAM, 0);
 	if (fd == -1)
 	{
-		std::cerr << BRIGHT_RED << "[SOCKET] socket() failed: " << strerror(errno) << RESET << std::endl;
+		LOG_ERROR(BRIGHT_RED << "[SOCKET] socket() failed: " << strerror(errno) << RESET);
 		return (-1);	
 	}
-	std::cout << CYAN << "[SOCKET] Socket created (fd=" << fd << ")" << RESET << std::endl;
+	LOG_INFO(CYAN << "[SOCKET] Socket created (fd=" << fd << ")" << RESET);
     if (!setReuseAddr(fd)) //* Configure SO_REUSEADDR
 	{
         close(fd);
         return (-1);
     }
+    if (reusePort && !setReusePort(fd)) //* Configure SO_REUSEPORT (multi-loop)
+	{
+        close(fd);
+        return (-1);
+    }
     if (!setNonBlocking(fd)) //* Configure non-blocking
 	{
         close(fd);
         return (-1);
     }
-    std::cout << GREEN << "[SOCKET] ✓ Socket configured (non-blocking + SO_REUSEADDR)" << RESET << std::endl;
+    LOG_INFO(GREEN << "[SOCKET] ✓ Socket configured (non-blocking + SO_REUSEADDR)" << RESET);
     return (fd);
 }
 
@@ -112,36 +165,85 @@ int		SocketUtils::createServerSocket()
 //* Purpose: Associates the socket with a port number so clients know where to connect
 //* Think of it like: "This socket will listen on port 6667"
 //* ========================================
-bool	SocketUtils::bindSocket(int fd, int port)
+bool	SocketUtils::bindSocket(int fd, int port, bool loopback)
 {
 	//* Prepare address structure for IPv4
 	struct sockaddr_in addr;
 	std::memset(&addr, 0, sizeof(addr));               //* Zero out the structure (good practice)
 
 	addr.sin_family = AF_INET;                         //* Address family: IPv4
-	addr.sin_addr.s_addr = INADDR_ANY;                 //* Bind to all network interfaces (0.0.0.0)
+	addr.sin_addr.s_addr = loopback ? htonl(INADDR_LOOPBACK) : INADDR_ANY;	//* 127.0.0.1, or all interfaces (0.0.0.0)
 	addr.sin_port = htons(port);                       //* Convert port to network byte order (big-endian)
 
 	//* Attach the socket to the port
 	if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) == -1)
 	{
-		std::cerr << BRIGHT_RED << "[SOCKET] bind() failed on port " << port 
-				<< ": " << strerror(errno) << RESET << std::endl;
+		LOG_ERROR(BRIGHT_RED << "[SOCKET] bind() failed on port " << port 
+				<< ": " << strerror(errno) << RESET);
 		return (false);
 	}
-	std::cout << GREEN << "[SOCKET] ✓ Bound to 0.0.0.0:" << port << RESET << std::endl;
+	LOG_INFO(GREEN << "[SOCKET] ✓ Bound to " << (loopback ? "127.0.0.1:" : "0.0.0.0:") << port << RESET);
 	return (true);
 }
 
+//* ========================================
+//* UNIX SOCKET: local-only listener on a filesystem path
+//* ========================================
+int		SocketUtils::createUnixServerSocket(const std::string& path)
+{
+	struct sockaddr_un addr;
+	std::memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (path.size() >= sizeof(addr.sun_path))
+	{
+		LOG_ERROR(BRIGHT_RED << "[SOCKET] Unix socket path too long: " << path << RESET);
+		return (-1);
+	}
+	std::memcpy(addr.sun_path, path.c_str(), path.size());
+
+	//* Left behind by a previous run: bind() would fail with EADDRINUSE
+	struct stat info;
+	if (lstat(path.c_str(), &info) == 0)
+	{
+		if (!S_ISSOCK(info.st_mode))
+		{
+			LOG_ERROR(BRIGHT_RED << "[SOCKET] " << path << " exists and is not a socket" << RESET);
+			return (-1);
+		}
+		unlink(path.c_str());
+	}
+
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd == -1)
+	{
+		LOG_ERROR(BRIGHT_RED << "[SOCKET] socket(AF_UNIX) failed: " << strerror(errno) << RESET);
+		return (-1);
+	}
+	if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) == -1)
+	{
+		LOG_ERROR(BRIGHT_RED << "[SOCKET] bind() failed on " << path << ": " << strerror(errno) << RESET);
+		close(fd);
+		return (-1);
+	}
+	if (!setNonBlocking(fd))
+	{
+		close(fd);
+		unlink(path.c_str());
+		return (-1);
+	}
+	LOG_INFO(GREEN << "[SOCKET] ✓ Bound to " << path << RESET);
+	return (fd);
+}
+
 //* Prepare to accept conections on socket fd (LISTEN MODE)
 bool	SocketUtils::listenSocket(int fd, int backlog)
 {
 	if (listen(fd, backlog) == -1)						//* BACKLOG: is the max size of the queue of pending conections
 	{
-		std::cerr << BRIGHT_RED << "[SOCKET] listen() failed: " << strerror(errno) << RESET << std::endl;
+		LOG_ERROR(BRIGHT_RED << "[SOCKET] listen() failed: " << strerror(errno) << RESET);
 		return (false);
 	}
-	std::cout << GREEN << "[SOCKET] ✓ Listening (backlog=" << backlog << ")" << RESET << std::endl;
+	LOG_INFO(GREEN << "[SOCKET] ✓ Listening (backlog=" << backlog << ")" << RESET);
 	return (true);
 }
 
@@ -158,28 +260,31 @@ int		SocketUtils::acceptClient(int server_fd, std::string& client_ip)
 	struct sockaddr_in cli_addr;                                      //* Structure to store client address information (IPv4)
 	socklen_t cli_len = sizeof(cli_addr);                             //* Size of the client address structure
 
+#ifdef __linux__
+	//* accept4() returns the socket already non-blocking: no extra fcntl() calls per client
+	int client_fd = accept4(server_fd, (struct sockaddr*)&cli_addr, &cli_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
 	int client_fd = accept(server_fd, (struct sockaddr*)&cli_addr, &cli_len); //* Accept incoming connection and get a new fd, the client socket FD exactly
-	if (client_fd == -1) 
-	{
-		if (errno == EAGAIN || errno == EWOULDBLOCK)                  //* Non-blocking socket: no pending connections (not an error)
-			return (-1);
-		std::cerr << BRIGHT_RED << "[SOCKET] accept() failed: " << strerror(errno) << RESET << std::endl; //* Actual real error occurred
+#endif
+	if (client_fd == -1)                                              //* errno tells the caller why (see isTransientAcceptError)
 		return (-1);
-	}
 	
 	char ip_str[INET_ADDRSTRLEN];                                     //* Buffer to hold IP address in string format
 	inet_ntop(AF_INET, &cli_addr.sin_addr, ip_str, sizeof(ip_str));   //* Convert binary IP to dotted-decimal notation (e.g., "192.168.1.1")
 	client_ip = ip_str;                                               //* Store the IP address in output parameter
 	
+#ifndef __linux__
 	if (!setNonBlocking(client_fd))                                   //* Configure client socket to non-blocking mode
 	{
-		std::cerr << BRIGHT_RED << "[SOCKET] Failed to set client socket non-blocking" << RESET << std::endl;
+		LOG_ERROR(BRIGHT_RED << "[SOCKET] Failed to set client socket non-blocking" << RESET);
 		close(client_fd);                                             //* Close socket to prevent resource leak
 		return (-1);
 	}
+#endif
+	setNoDelay(client_fd);                                            //* Not fatal: the client just gets Nagle's batching
 	
-	std::cout << GREEN << "[SOCKET] ✓ Accepted connection from " << client_ip  //* Log successful connection
-			<< " (fd=" << client_fd << ")" << RESET << std::endl;
+	LOG_DEBUG(GREEN << "[SOCKET] ✓ Accepted connection from " << client_ip  //* Log successful connection
+			<< " (fd=" << client_fd << ")" << RESET);
 	
 	return (client_fd);                                               //* Return valid client socket file descriptor
 }
@@ -208,12 +313,12 @@ ssize_t	SocketUtils::receiveData(int fd, char* buffer, size_t size)
 		if (errno == EAGAIN || errno == EWOULDBLOCK) 		//* No data available right now (normal in non-blocking mode)
 			return (-1); 									//* Not an error, just try again later
 
-		std::cerr << BRIGHT_RED << "[SOCKET] recv() failed on fd=" << fd  //* Real error occurred
-				<< ": " << strerror(errno) << RESET << std::endl;
+		LOG_WARN(BRIGHT_RED << "[SOCKET] recv() failed on fd=" << fd  //* Real error occurred
+				<< ": " << strerror(errno) << RESET);
 		return (-1);
 	}
 	if (bytes == 0) 										//* Connection closed cleanly by peer
-		std::cout << YELLOW << "[SOCKET] Connection closed by peer (fd=" << fd << ")" << RESET << std::endl;
+		LOG_DEBUG(YELLOW << "[SOCKET] Connection closed by peer (fd=" << fd << ")" << RESET);
 	
 	return (bytes); 										//* Return number of bytes received
 }
@@ -238,8 +343,8 @@ ssize_t	SocketUtils::sendData(int fd, const char* data, size_t size)
 		if (errno == EAGAIN || errno == EWOULDBLOCK)        //* Send buffer full (normal in non-blocking mode)
 			return (-1);                                    //* Not an error, retry later with POLLOUT
 		
-		std::cerr << BRIGHT_RED << "[SOCKET] send() failed on fd=" << fd  //* Real error occurred
-				<< ": " << strerror(errno) << RESET << std::endl;
+		LOG_WARN(BRIGHT_RED << "[SOCKET] send() failed on fd=" << fd  //* Real error occurred
+				<< ": " << strerror(errno) << RESET);
 		return (-1);
 	}
 	
@@ -257,6 +362,11 @@ bool	SocketUtils::isWouldBlock()
 	return (errno == EAGAIN || errno == EWOULDBLOCK); //*  EWOULDBLOCK IS AN ALIAS OF EGAIN
 }
 
+bool	SocketUtils::isTransientAcceptError()
+{
+	return (errno == ECONNABORTED || errno == EPROTO || errno == EINTR);
+}
+
 std::string	SocketUtils::getLastError()
 {
 	return (std::string(strerror(errno)));     //* Return a string describing the meaning of errno
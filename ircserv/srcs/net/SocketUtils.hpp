@@ -53,6 +53,26 @@ public:
 	 * @return true on success, false on error
 	 */
 	static bool setReuseAddr(int fd);
+
+	/**
+	 * Enable SO_REUSEPORT socket option
+	 * Lets several listening sockets bind the same port; the kernel
+	 * spreads incoming connections across them (one per event loop)
+	 * 
+	 * @param fd File descriptor to configure
+	 * @return true on success, false on error or if unsupported
+	 */
+	static bool setReusePort(int fd);
+
+	/**
+	 * Enable TCP_NODELAY socket option
+	 * Small writes leave at once instead of waiting for the ACK of the
+	 * previous segment (Nagle); output is batched per loop turn already
+	 * 
+	 * @param fd File descriptor to configure
+	 * @return true on success, false on error
+	 */
+	static bool setNoDelay(int fd);
 	
 	//* ========================================
 	//* SERVER SOCKET CREATION
@@ -62,21 +82,34 @@ public:
 	 * Create a TCP server socket
 	 * Automatically configures:
 	 * - SO_REUSEADDR option
+	 * - SO_REUSEPORT option (if reusePort is set)
 	 * - Non-blocking mode
 	 * 
+	 * @param reusePort Share the port with other listeners (multi-loop mode)
 	 * @return socket fd on success, -1 on error
 	 */
-	static int createServerSocket();
+	static int createServerSocket(bool reusePort = false);
 	
 	/**
 	 * Bind server socket to a specific port
-	 * Binds to all interfaces (0.0.0.0)
+	 * Binds to all interfaces (0.0.0.0), or 127.0.0.1 only
 	 * 
 	 * @param fd Socket file descriptor
 	 * @param port Port number (recommended: 1024-65535)
+	 * @param loopback Only accept local connections (metrics listener)
 	 * @return true on success, false on error
 	 */
-	static bool bindSocket(int fd, int port);
+	static bool bindSocket(int fd, int port, bool loopback = false);
+
+	/**
+	 * Create a Unix domain server socket bound to path
+	 * A stale socket left at path by a previous run is removed first;
+	 * any other kind of file there is an error.
+	 * 
+	 * @param path Filesystem path of the socket
+	 * @return socket fd on success (non-blocking), -1 on error
+	 */
+	static int createUnixServerSocket(const std::string& path);
 	
 	/**
 	 * Put socket in listening mode
@@ -93,13 +126,29 @@ public:
 	
 	/**
 	 * Accept a new client connection (non-blocking)
-	 * Automatically sets client socket to non-blocking mode
+	 * Client socket comes back non-blocking (accept4() on Linux, fcntl() elsewhere)
+	 * and with TCP_NODELAY set
+	 * 
+	 * Failures are not logged: the caller tells them apart with errno
+	 * (isWouldBlock(), isTransientAcceptError(), anything else = back off)
 	 * 
 	 * @param server_fd Server socket file descriptor
 	 * @param client_ip [OUT] Client IP address as string (e.g., "192.168.1.100")
 	 * @return client fd on success, -1 if no connection available or error
 	 */
 	static int acceptClient(int server_fd, std::string& client_ip);
+
+	/**
+	 * Check if the last accept() failure only concerns that one connection
+	 * (aborted in the backlog, protocol error, signal): accept the next one
+	 * 
+	 * @return true if errno is ECONNABORTED, EPROTO or EINTR
+	 */
+	static bool isTransientAcceptError();
+
+	//* Listener left alone after EMFILE/ENFILE (or any other hard accept()
+	//* error) so a full descriptor table doesn't turn into a busy loop
+	static const unsigned long ACCEPT_BACKOFF_MS = 100;
 	
 	//* ========================================
 	//* I/O OPERATIONS
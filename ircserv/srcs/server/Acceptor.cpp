@@ -0,0 +1,194 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Acceptor.cpp                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 19:41:50 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 19:41:50 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "Acceptor.hpp"
+#include "EventLoop.hpp"
+#include "ServerConfig.hpp"
+#include "../client/ClientConnection.hpp"
+#include "../client/User.hpp"
+#include "../net/SocketUtils.hpp"
+#include "../utils/LatencyHistogram.hpp"
+#include "../utils/Clock.hpp"
+#include "../utils/Colors.hpp"
+#include "../utils/Log.hpp"
+
+#include <unistd.h>
+#include <poll.h>
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+
+Acceptor::Acceptor(const ServerConfig& config, const std::vector<EventLoop*>& loops)
+	: config_(config), loops_(loops), listen_fd_(-1), running_(0), thread_started_(false)
+{
+	wake_fds_[0] = -1;
+	wake_fds_[1] = -1;
+}
+
+Acceptor::~Acceptor()
+{
+	if (listen_fd_ >= 0)
+		close(listen_fd_);
+	if (wake_fds_[0] >= 0)
+		close(wake_fds_[0]);
+	if (wake_fds_[1] >= 0)
+		close(wake_fds_[1]);
+}
+
+//* ============================================================================
+//* SETUP
+//* ============================================================================
+
+bool Acceptor::open()
+{
+	listen_fd_ = SocketUtils::createServerSocket();
+	if (listen_fd_ < 0)
+		return (false);
+	if (!SocketUtils::bindSocket(listen_fd_, config_.port)
+		|| !SocketUtils::listenSocket(listen_fd_, SOMAXCONN))
+		return (false);
+
+	if (pipe(wake_fds_) == -1)
+	{
+		LOG_ERROR(BRIGHT_RED << "[ACCEPT] pipe() failed: " << strerror(errno) << RESET);
+		return (false);
+	}
+	__atomic_store_n(&running_, 1, __ATOMIC_RELAXED);
+	return (true);
+}
+
+//* ============================================================================
+//* THREAD
+//* ============================================================================
+
+void* Acceptor::threadMain(void* arg)
+{
+	static_cast<Acceptor*>(arg)->run();
+	return (NULL);
+}
+
+bool Acceptor::spawn()
+{
+	if (pthread_create(&thread_, NULL, &Acceptor::threadMain, this) != 0)
+	{
+		LOG_ERROR(BRIGHT_RED << "[ACCEPT] pthread_create() failed" << RESET);
+		return (false);
+	}
+	thread_started_ = true;
+	return (true);
+}
+
+void Acceptor::join()
+{
+	if (thread_started_)
+		pthread_join(thread_, NULL);
+	thread_started_ = false;
+}
+
+//* Called from the signal handler: only a flag and a write(), both safe there
+void Acceptor::stop()
+{
+	__atomic_store_n(&running_, 0, __ATOMIC_RELAXED);
+	if (wake_fds_[1] >= 0)
+	{
+		char byte = 0;
+		ssize_t ignored = write(wake_fds_[1], &byte, 1);
+		(void)ignored;
+	}
+}
+
+//* ============================================================================
+//* ACCEPT LOOP
+//* ============================================================================
+
+//* Only two descriptors, so a plain blocking poll() is all this thread needs.
+//* During an accept() back-off the listener's slot is disabled (negative fd)
+//* and poll() times out when it's due again.
+void Acceptor::run()
+{
+	struct pollfd fds[2];
+	fds[0].fd = listen_fd_;
+	fds[0].events = POLLIN;
+	fds[1].fd = wake_fds_[0];
+	fds[1].events = POLLIN;
+	unsigned long resume_at = 0;
+
+	while (__atomic_load_n(&running_, __ATOMIC_RELAXED))
+	{
+		int timeout = -1;
+		if (fds[0].fd < 0)
+		{
+			unsigned long now = Clock::nowMs();
+			if (now >= resume_at)
+			{
+				fds[0].fd = listen_fd_;
+				continue;
+			}
+			timeout = static_cast<int>(resume_at - now);
+		}
+		if (poll(fds, 2, timeout) < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			LOG_ERROR("[ERROR] acceptor poll() failed: " << strerror(errno));
+			break;
+		}
+		if ((fds[0].revents & POLLIN) && !acceptPending())
+		{
+			LOG_WARN(YELLOW << "[ACCEPT] accept() failed: " << strerror(errno) << ", not accepting for "
+					 << SocketUtils::ACCEPT_BACKOFF_MS << " ms" << RESET);
+			fds[0].fd = -1;
+			resume_at = Clock::nowMs() + SocketUtils::ACCEPT_BACKOFF_MS;
+		}
+	}
+}
+
+//* Same rules as EventLoop::acceptNewConnections()
+bool Acceptor::acceptPending()
+{
+	while (true)
+	{
+		std::string client_ip;
+		int client_fd = SocketUtils::acceptClient(listen_fd_, client_ip);
+		if (client_fd < 0)
+		{
+			if (SocketUtils::isWouldBlock())
+				return (true);
+			if (SocketUtils::isTransientAcceptError())
+				continue;
+			return (false);
+		}
+		unsigned long accepted_at = LatencyHistogram::now();
+
+		//* Initial allocation happens here, off the event loops
+		ClientConnection* connection = new ClientConnection(client_fd);
+		User* user = new User();
+		user->setHostname(client_ip);
+		user->setConnection(connection);
+		connection->setUser(user);
+
+		leastLoaded()->adopt(connection, accepted_at);
+	}
+}
+
+//* Load is counted when a connection is handed over, not when the loop gets
+//* to it, so a burst of accepts spreads out instead of piling on one loop.
+EventLoop* Acceptor::leastLoaded() const
+{
+	EventLoop* best = loops_[0];
+	for (size_t i = 1; i < loops_.size(); ++i)
+	{
+		if (loops_[i]->getLoad() < best->getLoad())
+			best = loops_[i];
+	}
+	return (best);
+}
@@ -0,0 +1,63 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Acceptor.hpp                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 19:41:50 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 19:41:50 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef ACCEPTOR_HPP
+#define ACCEPTOR_HPP
+
+#include <vector>
+#include <pthread.h>
+
+class EventLoop;
+struct ServerConfig;
+
+/**
+ * Acceptor: Dedicated accept thread (--acceptor-thread)
+ *
+ * Owns the only listening socket and blocks in poll() on it. For each
+ * new connection it does the accept4() (socket already non-blocking),
+ * allocates the ClientConnection + User, and hands them to the loop
+ * with the fewest connections. The loops never see the listener, so a
+ * connection storm after a restart costs them one queue pop per client
+ * instead of accept() calls in the middle of message delivery.
+ */
+
+class Acceptor
+{
+	public:
+		Acceptor(const ServerConfig& config, const std::vector<EventLoop*>& loops);
+		~Acceptor();
+
+		bool	open();							//* Listener + wakeup pipe
+		bool	spawn();
+		void	join();
+		void	stop();							//* Async-signal-safe
+
+	private:
+		const ServerConfig&				config_;
+		const std::vector<EventLoop*>&	loops_;
+		int								listen_fd_;
+		int								wake_fds_[2];
+		int								running_;		//* Read/written with __atomic
+		pthread_t						thread_;
+		bool							thread_started_;
+
+		void		run();
+		bool		acceptPending();				//* false: back off (EMFILE/ENFILE...)
+		EventLoop*	leastLoaded() const;
+
+		static void*	threadMain(void* arg);
+
+		Acceptor(const Acceptor&);
+		Acceptor& operator=(const Acceptor&);
+};
+
+#endif
@@ -0,0 +1,1076 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   EventLoop.cpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 18:02:37 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 18:02:37 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "EventLoop.hpp"
+#include "Server.hpp"
+#include "ServerConfig.hpp"
+#include "../client/ClientConnection.hpp"
+#include "../client/User.hpp"
+#include "../net/SocketUtils.hpp"
+#include "../utils/SharedBuffer.hpp"
+#include "../utils/LatencyHistogram.hpp"
+#include "../utils/Clock.hpp"
+#include "../utils/Colors.hpp"
+#include "../utils/Log.hpp"
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <cerrno>
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+//* Loop driving the calling thread, set once run() starts
+static __thread EventLoop* current_loop = NULL;
+
+//* ============================================================================
+//* CONSTRUCTOR Y DESTRUCTOR
+//* ============================================================================
+
+EventLoop::EventLoop(Server& server, const ServerConfig& config, int index)
+	: server_(server), config_(config), index_(index), listen_fd_(-1),
+	running_(0), report_requested_(0), profile_reset_requested_(0), thread_started_(false), wake_pending_(0), load_(0), backend_(NULL),
+	now_(Clock::nowMs()), wall_(0), wall_ms_(0), server_time_ms_(0), timers_(now_ / TIMER_TICK_MS)
+{
+	wake_fds_[0] = -1;
+	wake_fds_[1] = -1;
+	updateClock();
+}
+
+EventLoop::~EventLoop()
+{
+	//* Output still in the inbox goes to its connections, freed with them below
+	drainInbox();
+
+	//* Connections accepted but never picked up
+	Handoff handoff;
+	while (handoff_.pop(handoff))
+	{
+		close(handoff.client->getFd());
+		delete handoff.client->getUser();
+		delete handoff.client;
+	}
+
+	//* CLEANUP CLIENTS
+	for (size_t i = 0; i < clients_.size(); i++)
+	{
+		User* user = clients_[i]->getUser();		//* Get associated User before deleting connection
+
+		close(clients_[i]->getFd());
+		delete clients_[i];							//* Delete ClientConnection
+		if (user)									//* Delete User if exists
+			delete user;
+	}
+	reapClosedClients();
+	reapClosedClients();	//* Both generations
+
+	if (listen_fd_ >= 0)
+		close(listen_fd_);
+	if (wake_fds_[0] >= 0)
+		close(wake_fds_[0]);
+	if (wake_fds_[1] >= 0)
+		close(wake_fds_[1]);
+	delete backend_;
+}
+
+//* ============================================================================
+//* SETUP
+//* ============================================================================
+
+bool EventLoop::open(bool listen, bool reusePort)
+{
+	//* LISTENING SOCKET (one per loop; SO_REUSEPORT lets the kernel balance them)
+	//* Not opened when an Acceptor thread hands connections over instead.
+	if (listen)
+	{
+		listen_fd_ = SocketUtils::createServerSocket(reusePort);
+		if (listen_fd_ < 0)
+			return (false);
+		if (!SocketUtils::bindSocket(listen_fd_, config_.port)
+			|| !SocketUtils::listenSocket(listen_fd_, SOMAXCONN))
+			return (false);
+	}
+
+	//* WAKEUP PIPE (other loops write one byte after posting to our inbox)
+	if (pipe(wake_fds_) == -1)
+	{
+		LOG_ERROR(BRIGHT_RED << "[LOOP " << index_ << "] pipe() failed: "
+				  << strerror(errno) << RESET);
+		return (false);
+	}
+	if (!SocketUtils::setNonBlocking(wake_fds_[0]) || !SocketUtils::setNonBlocking(wake_fds_[1]))
+		return (false);
+
+	//* EVENT BACKEND (epoll on Linux unless --backend=poll, poll() otherwise)
+	backend_ = EventBackend::create(config_.backend == ServerConfig::BACKEND_EPOLL, config_.edgeTriggered);
+	if ((listen && !backend_->addListener(listen_fd_)) || !backend_->add(wake_fds_[0], POLLIN))
+		return (false);
+
+	__atomic_store_n(&running_, 1, __ATOMIC_RELAXED);
+	return (true);
+}
+
+//* ============================================================================
+//* MAIN LOOP - one poll()/epoll_wait() per iteration
+//* ============================================================================
+
+void EventLoop::run()
+{
+	current_loop = this;
+
+	while (__atomic_load_n(&running_, __ATOMIC_RELAXED))
+	{
+		//* WAIT FOR ACTIVITY on any socket (listener + wakeup pipe + own clients)
+		//* Blocks until something happens, a throttled client earns its next
+		//* token or a timer is due. Only the ready descriptors come back, so
+		//* the cost of an iteration follows activity, not clients.
+		int timeout = nextRunTimeout();
+		int timer_timeout = nextTimerTimeout();
+		if (timeout < 0 || (timer_timeout >= 0 && timer_timeout < timeout))
+			timeout = timer_timeout;
+		if (inbox_.pending() || handoff_.pending())
+			timeout = 0;						//* A post was still linking its node: look again
+		int ready_count = backend_->wait(ready_events_, timeout);
+		updateClock();
+		LoopCounters::add(counters_.wakeups);
+
+		//* HANDLE WAIT ERRORS
+		if (ready_count < 0)
+		{
+			if (errno == EINTR)              //* Interrupted by signal (e.g., Ctrl+C) - not fatal
+				continue;                    //* Restart the loop
+			LOG_ERROR("[ERROR] " << backend_->getName() << " wait failed: " << strerror(errno));
+			break;                           //* Fatal error - exit loop
+		}
+
+		//* DISPATCH READY SOCKETS
+		bool accept_pending = false;
+		for (size_t i = 0; i < ready_events_.size(); ++i)
+		{
+			int fd = ready_events_[i].fd;
+
+			// Listening socket: accepted after the clients, so an fd closed during
+			// this batch can't be handed to a new client while a stale event
+			// for it is still waiting further down the list.
+			if (listen_fd_ >= 0 && fd == listen_fd_)
+				accept_pending = true;
+			else if (fd == wake_fds_[0])
+				drainWakeup();
+			else
+				handleClientEvent(fd, ready_events_[i].events);
+		}
+		if (accept_pending)
+			acceptNewConnections();
+		runQueue();
+		runTimers();
+
+		//* Connections from the Acceptor, output posted by other loops, then
+		//* one flush per client that queued something. The flush can still
+		//* disconnect clients, so those are only deleted next iteration.
+		rearmWakeup();
+		drainHandoff();
+		drainInbox();
+		flushPendingOutput();
+		reapClosedClients();
+
+		if (__atomic_exchange_n(&report_requested_, 0, __ATOMIC_RELAXED))
+			reportStats();
+		if (__atomic_exchange_n(&profile_reset_requested_, 0, __ATOMIC_RELAXED))
+			profile_.reset();
+	}
+	current_loop = NULL;
+}
+
+void* EventLoop::threadMain(void* arg)
+{
+	static_cast<EventLoop*>(arg)->run();
+	return (NULL);
+}
+
+bool EventLoop::spawn()
+{
+	if (pthread_create(&thread_, NULL, &EventLoop::threadMain, this) != 0)
+	{
+		LOG_ERROR(BRIGHT_RED << "[LOOP " << index_ << "] pthread_create() failed" << RESET);
+		return (false);
+	}
+	thread_started_ = true;
+	return (true);
+}
+
+void EventLoop::join()
+{
+	if (thread_started_)
+		pthread_join(thread_, NULL);
+	thread_started_ = false;
+}
+
+//* Called from the signal handler: only a flag and a write(), both safe there
+void EventLoop::stop()
+{
+	__atomic_store_n(&running_, 0, __ATOMIC_RELAXED);
+	if (wake_fds_[1] >= 0)
+	{
+		char byte = 0;
+		ssize_t ignored = write(wake_fds_[1], &byte, 1);
+		(void)ignored;
+	}
+}
+
+//* ============================================================================
+//* GETTERS
+//* ============================================================================
+
+size_t EventLoop::getLoad() const
+{
+	return (__atomic_load_n(&load_, __ATOMIC_RELAXED));
+}
+
+int EventLoop::getIndex() const
+{
+	return (index_);
+}
+
+unsigned long EventLoop::now() const
+{
+	return (now_);
+}
+
+const std::string& EventLoop::timestamp() const
+{
+	return (timestamp_);
+}
+
+//* Only clients that negotiated server-time need it, so it is formatted
+//* on first use in an iteration rather than on every wakeup
+const std::string& EventLoop::serverTime()
+{
+	if (server_time_ms_ == wall_ms_ && !server_time_.empty())
+		return (server_time_);
+	server_time_ms_ = wall_ms_;
+	time_t seconds = static_cast<time_t>(wall_ms_ / 1000);
+	struct tm utc;
+	char buffer[32];
+	gmtime_r(&seconds, &utc);
+	size_t length = std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S", &utc);
+	std::snprintf(buffer + length, sizeof(buffer) - length, ".%03luZ", wall_ms_ % 1000);
+	server_time_.assign(buffer);
+	return (server_time_);
+}
+
+//* ============================================================================
+//* COUNTERS
+//* ============================================================================
+
+LoopCounters& EventLoop::getCounters()
+{
+	return (counters_);
+}
+
+const LoopCounters& EventLoop::getCounters() const
+{
+	return (counters_);
+}
+
+//* Charged to the command the calling loop is running (CMD_UNKNOWN between
+//* commands). A post is only counted on arrival, once the receiving loop
+//* admitted it, and charged to the command that posted it (drainInbox()).
+void EventLoop::countLineOut(size_t bytes)
+{
+	EventLoop* loop = current_loop;
+	if (!loop)
+		return;
+	LoopCounters::add(loop->counters_.linesOut[loop->counters_.running]);
+	loop->counters_.bytesQueued += bytes;
+}
+
+CommandProfile& EventLoop::getProfile()
+{
+	return (profile_);
+}
+
+const CommandProfile& EventLoop::getProfile() const
+{
+	return (profile_);
+}
+
+//* Only the owner writes the histograms, so it is also the one to clear them
+void EventLoop::requestProfileReset()
+{
+	__atomic_store_n(&profile_reset_requested_, 1, __ATOMIC_RELAXED);
+	wake();
+}
+
+//* ============================================================================
+//* CROSS-THREAD DELIVERY
+//* ============================================================================
+
+EventLoop* EventLoop::current()
+{
+	return (current_loop);
+}
+
+bool EventLoop::isCurrent() const
+{
+	return (current_loop == this);
+}
+
+//* Hand a line to a connection owned by this loop from any other thread.
+//* The buffer is retained here and released by the owner once queued.
+void EventLoop::post(ClientConnection* client, SharedBuffer* buffer,
+	ClientConnection::OutputPriority priority)
+{
+	Delivery delivery;
+	delivery.client = client;
+	delivery.buffer = buffer;
+	delivery.priority = priority;
+	delivery.command = current_loop ? current_loop->counters_.running : CMD_UNKNOWN;
+	buffer->retain();
+	inbox_.push(delivery);
+	wake();
+}
+
+//* Called by the Acceptor thread. The connection is counted right away so
+//* the next pick already sees it; the loop registers it on its next pass.
+void EventLoop::adopt(ClientConnection* client, unsigned long accepted_at)
+{
+	Handoff handoff;
+	handoff.client = client;
+	handoff.accepted_at = accepted_at;
+	__sync_fetch_and_add(&load_, 1);
+	handoff_.push(handoff);
+	wake();
+}
+
+//* At most one wakeup byte in flight: later posters see the flag and skip
+//* the write() until the owner has consumed it.
+void EventLoop::wake()
+{
+	if (__sync_bool_compare_and_swap(&wake_pending_, 0, 1))
+	{
+		char byte = 0;
+		ssize_t ignored = write(wake_fds_[1], &byte, 1);
+		(void)ignored;
+	}
+}
+
+//* Only a flag and a wakeup, so the SIGUSR1 handler can call it
+void EventLoop::requestReport()
+{
+	__atomic_store_n(&report_requested_, 1, __ATOMIC_RELAXED);
+	wake();
+}
+
+void EventLoop::drainWakeup()
+{
+	char buffer[64];
+	while (read(wake_fds_[0], buffer, sizeof(buffer)) > 0)
+		;
+}
+
+//* Every iteration, right before the queues are drained, and not only when
+//* the pipe was readable: a poster whose node wasn't linked yet when we last
+//* drained can find the flag still set by a later poster whose byte we
+//* already read, skip its write() and leave the loop asleep for good.
+//* Sequentially consistent (not a plain release): the queues must be read
+//* only after the reset is visible to the posters' compare-and-swap.
+void EventLoop::rearmWakeup()
+{
+	if (!__atomic_load_n(&wake_pending_, __ATOMIC_RELAXED))
+		return;
+	__atomic_store_n(&wake_pending_, 0, __ATOMIC_SEQ_CST);	//* Posts after this point write again
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+void EventLoop::drainHandoff()
+{
+	Handoff handoff;
+	while (handoff_.pop(handoff))
+		registerClient(handoff.client, handoff.accepted_at);
+}
+
+//* A connection closed after the post was made can't be reached through the
+//* IRC state anymore, so its entries are simply dropped.
+void EventLoop::drainInbox()
+{
+	Delivery delivery;
+	while (inbox_.pop(delivery))
+	{
+		counters_.running = delivery.command;
+		if (!delivery.client->isClosed())
+			delivery.client->queuePosted(delivery.buffer, delivery.priority);
+		delivery.buffer->release();
+	}
+	counters_.running = CMD_UNKNOWN;
+}
+
+//* ============================================================================
+//* ACCEPT
+//* ============================================================================
+
+//* ACCEPT NEW CONNECTIONS
+//* Core function that handles incoming client connections to the IRC server.
+//* Creates ClientConnection and User objects, links them together, and adds
+//* the new client to both the clients_ vector and the event backend.
+//* Uses non-blocking socket operations to accept multiple pending connections.
+
+void EventLoop::acceptNewConnections()
+{
+	//* ACCEPT ALL PENDING CONNECTIONS in a loop (non-blocking)
+	while (true)
+	{
+		std::string client_ip;                                             //* Will store client's IP address
+		int client_fd = SocketUtils::acceptClient(listen_fd_, client_ip);  //* Accept one connection, get client socket fd and IP
+
+		//* STOP when the backlog is empty, SKIP a connection that died in it,
+		//* BACK OFF on anything else (EMFILE/ENFILE: the backlog would stay
+		//* readable and every wakeup would fail the same way)
+		if (client_fd < 0)
+		{
+			if (SocketUtils::isWouldBlock())
+				break;
+			if (SocketUtils::isTransientAcceptError())
+				continue;
+			pauseAccepting();
+			break;
+		}
+		unsigned long accepted_at = LatencyHistogram::now();
+
+		//* CREATE CLIENT CONNECTION OBJECT (manages socket I/O and buffers)
+		ClientConnection* connection = new ClientConnection(client_fd);
+
+		//* CREATE USER OBJECT (stores IRC user data: nick, username, channels, etc.)
+		//* Not visible to other loops yet, so no state lock is needed here.
+		User* user = new User();
+		user->setHostname(client_ip);                                       //* Store client's IP address in user profile
+		user->setConnection(connection);                                    //* Link User -> ClientConnection (bidirectional relationship)
+		connection->setUser(user);                                          //* Link ClientConnection -> User
+
+		__sync_fetch_and_add(&load_, 1);
+		registerClient(connection, accepted_at);
+	}
+}
+
+//* PAUSE / RESUME ACCEPTING
+//* Closing descriptors is what ends EMFILE, and only disconnects do that, so
+//* the listener simply sits out ACCEPT_BACKOFF_MS and is tried again. One
+//* log line per back-off, whatever the number of connections waiting.
+void EventLoop::pauseAccepting()
+{
+	LOG_WARN(YELLOW << "[LOOP " << index_ << "] accept() failed: " << strerror(errno)
+			 << ", not accepting for " << SocketUtils::ACCEPT_BACKOFF_MS << " ms" << RESET);
+	backend_->remove(listen_fd_);
+	timers_.schedule(&accept_timer_,
+		(now_ + SocketUtils::ACCEPT_BACKOFF_MS + TIMER_TICK_MS - 1) / TIMER_TICK_MS);
+}
+
+//* Level-triggered, so connections that queued up meanwhile show up next wait
+void EventLoop::resumeAccepting()
+{
+	if (!backend_->addListener(listen_fd_))
+		timers_.schedule(&accept_timer_,
+			(now_ + SocketUtils::ACCEPT_BACKOFF_MS + TIMER_TICK_MS - 1) / TIMER_TICK_MS);
+}
+
+//* REGISTER CLIENT
+//* Shared by both accept paths (own listener, Acceptor handoff): takes
+//* ownership of the connection and greets it.
+void EventLoop::registerClient(ClientConnection* connection, unsigned long accepted_at)
+{
+	//* Too many half-open connections from this address: refuse before it costs a slot
+	if (!server_.admitUnregistered(connection->getUser()->getHostname()))
+	{
+		__sync_fetch_and_add(&server_.getStats().unregisteredRejected, 1UL);
+		rejectClient(connection, "Too many unregistered connections from your host");
+		return;
+	}
+
+	//* REGISTER CLIENT in this loop's client list
+	LoopCounters::add(counters_.accepted);
+	connection->setSlot(clients_.size());                                   //* Remember position for O(1) removal
+	clients_.push_back(connection);                                         //* Add to vector for tracking all connected clients
+	indexClient(connection);                                                //* fd -> connection slot for O(1) lookups
+	addClientToPoll(connection);                                            //* Register client's fd in the event backend for I/O monitoring
+	scheduleClient(connection, now_ + config_.registrationTimeout * 1000UL);	//* Must finish PASS/NICK/USER by then
+
+	//* SEND WELCOME MESSAGE with authentication instructions
+	//* Built once by the Server, every new client just references it
+	connection->queueShared(server_.getWelcome());
+
+	server_.getStats().acceptLatency.record(LatencyHistogram::now() - accepted_at);
+
+	LOG_INFO(GREEN << "[SERVER] ✓ New client from " << connection->getUser()->getHostname()
+			  << " (fd=" << connection->getFd() << ", loop=" << index_
+			  << ", total=" << clients_.size() << ")" << RESET);
+}
+
+//* REJECT CLIENT
+//* Never indexed nor polled: one best-effort ERROR line, then gone
+void EventLoop::rejectClient(ClientConnection* connection, const char* reason)
+{
+	std::string error = std::string("ERROR :Closing Link: (") + reason + ")\r\n";
+	ssize_t ignored = send(connection->getFd(), error.c_str(), error.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+	(void)ignored;
+	close(connection->getFd());
+	delete connection->getUser();
+	delete connection;
+	__sync_fetch_and_sub(&load_, 1);
+}
+
+//* ============================================================================
+//* HANDLE CLIENT EVENTS
+//* ============================================================================
+
+//* HANDLE CLIENT EVENT
+//* Core event handler that processes all socket activity for connected clients.
+//* Called by the loop when the backend reports activity on a client socket.
+//* Handles three main scenarios:
+//* 1. Socket errors/disconnections (POLLERR, POLLHUP, POLLNVAL)
+//* 2. Incoming data ready to read (POLLIN)
+//* 3. Socket ready for writing (POLLOUT)
+//* Manages the complete client I/O lifecycle: receive -> buffer -> parse -> respond
+bool EventLoop::handleClientEvent(int fd, short revents)
+{
+    ClientConnection* client = findClientByFd(fd);
+
+    // Stale event: the client was already torn down earlier in this iteration
+    if (!client)
+        return false;
+
+    // 1. ERRORS / DISCONNECTION (POLLERR, POLLHUP, POLLNVAL)
+    if (revents & (POLLERR | POLLHUP | POLLNVAL))
+    {
+        LOG_INFO(YELLOW << "[SERVER] Client fd=" << fd
+                  << " disconnected (poll error)" << RESET);
+        server_.processClientCommands(client); // Process remaining commands (optional)
+        disconnectClient(client);
+        return false; // Return false because we deleted the client
+    }
+
+    // 2. READ (POLLIN)
+    // Level-triggered: one recv() per wakeup, the backend reports us again if
+    // more is pending. Edge-triggered: keep reading until EAGAIN, otherwise the
+    // rest of the data would never be announced.
+    if (revents & POLLIN)
+    {
+        bool drain = backend_->isEdgeTriggered();
+        do
+        {
+            ssize_t bytes = client->readSocket();
+
+            if (bytes > 0)
+            {
+                client->updateActivity(now_);
+                LoopCounters::add(counters_.bytesIn, bytes);
+
+                // Process commands (this executes NICK, JOIN, QUIT, etc.)
+                // At most one budget per iteration: a client already in the
+                // run queue gets its turn there, after everybody else.
+                if (!client->isDeferred())
+                    runClient(client);
+
+                // CRITICAL: Check if client requested disconnection (QUIT)
+                if (client->isClosed())
+                {
+                    disconnectClient(client);
+                    return false; // Client deleted, exit
+                }
+
+                // Still sending while its backlog is full: the receive queue
+                // limit is what bounds a throttled client
+                if (client->getFloodBucket().enabled()
+                    && client->getRecvQueueSize() >= config_.recvqMax)
+                {
+                    __sync_fetch_and_add(&server_.getStats().excessFlood, 1UL);
+                    killClient(client, "Excess Flood");
+                    return false;
+                }
+
+                // Backpressure: it isn't reading its replies, stop reading its
+                // commands. Flush first: if that makes room, keep going, since an
+                // edge-triggered socket left unread would not be reported again.
+                if (client->updateReadPause())
+                {
+                    sendPendingData(client);
+                    if (client->isClosed())
+                    {
+                        disconnectClient(client);
+                        return false;
+                    }
+                    if (client->updateReadPause())
+                        break;
+                }
+            }
+            else if (bytes == 0) // Connection closed by client (EOF)
+            {
+                LOG_DEBUG(YELLOW << "[SERVER] Client fd=" << fd
+                          << " closed connection" << RESET);
+                server_.processClientCommands(client);
+                disconnectClient(client);
+                return false;
+            }
+            else // Error in recv
+            {
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                    break; // Socket drained
+                LOG_WARN(BRIGHT_RED << "[SERVER] recv() error on fd=" << fd
+                          << ": " << strerror(errno) << RESET);
+                disconnectClient(client);
+                return false;
+            }
+        } while (drain);
+        // Replies were only queued: the client is in output_pending_ and is
+        // written once, with everything else it got, at the end of the iteration
+    }
+
+    // 3. WRITE (POLLOUT)
+    // Room again in the socket: the rest goes out with this iteration's flush
+    if ((revents & POLLOUT) && client->hasPendingSend())
+        client->notifyOutput();
+
+    // Keep POLLOUT only while there's still something to send
+    updatePollEvents(client, interestFor(client));
+
+    return true; // Client still alive
+}
+
+//* ============================================================================
+//* DISCONNECT CLIENT
+//* ============================================================================
+
+
+void EventLoop::disconnectClient(ClientConnection* client)
+{
+    // 1. Get basic information before deleting anything
+    int fd = client->getFd();
+
+    LOG_INFO(YELLOW << "[SERVER] Disconnecting client fd=" << fd << RESET);
+
+    // 2. Clean up IRC logic and objects (QUIT, channels, nick, User) under the state lock
+    if (!client->isRegistered() && client->getUser())
+        server_.releaseUnregistered(client->getUser()->getHostname());
+    server_.releaseClient(client);
+
+    // 3. Remove from this loop's client list (and the run queue)
+    if (client->isDeferred())
+    {
+        std::vector<ClientConnection*>::iterator it = std::find(run_queue_.begin(), run_queue_.end(), client);
+        if (it != run_queue_.end())
+            run_queue_.erase(it);	// Keep the round-robin order
+        client->setDeferred(false);
+    }
+    // Swap-and-pop: move the last client into this slot instead of shifting
+    // everything behind it, so a mass disconnect stays linear overall.
+    unindexClient(client);
+    size_t slot = client->getSlot();
+    if (slot < clients_.size() && clients_[slot] == client)
+    {
+        ClientConnection* last = clients_.back();
+        clients_[slot] = last;
+        last->setSlot(slot);
+        clients_.pop_back();
+    }
+    __sync_fetch_and_sub(&load_, 1);
+    if (client->isRegistered())
+        LoopCounters::sub(counters_.registered);
+    timers_.cancel(&client->getTimer());
+
+    // One last try to deliver what is still queued (the ERROR line of a
+    // kill or an eviction, the replies to a rejected PASS...)
+    if (client->hasPendingSend())
+        writePending(client);
+    if (client->isSendQueueExceeded())
+        __sync_fetch_and_add(&server_.getStats().sendqEvictions, 1UL);
+    if (client->getDroppedCount())
+        __sync_fetch_and_add(&server_.getStats().sendqDropped, client->getDroppedCount());
+    countSendQueue(client, 0);
+
+    // 4. Stop monitoring and close the socket
+    backend_->remove(fd);
+    close(fd);
+    client->closeConnection();
+
+    // 5. The connection object itself may still be referenced by output_pending_
+    // or by inbox entries, so it is only deleted later (see reapClosedClients).
+    closed_clients_.push_back(client);
+}
+
+//* Server-side kill: tell the client why, then the usual teardown
+void EventLoop::killClient(ClientConnection* client, const char* reason)
+{
+    client->setQuitReason(reason);
+    client->queueSend(std::string("ERROR :Closing Link: (") + reason + ")\r\n");
+    disconnectClient(client);	// Writes the ERROR line before closing
+}
+
+// Posts made before releaseClient() took the state lock can still be in the
+// inbox, and the flush at the end of an iteration disconnects clients after
+// that iteration's drainInbox(). A connection closed during iteration N is
+// therefore deleted at the end of N + 1, once another drain has run: nothing
+// can post to it after releaseClient(), so no entry is left by then.
+void EventLoop::reapClosedClients()
+{
+    for (size_t i = 0; i < reaped_clients_.size(); ++i)
+        delete reaped_clients_[i];
+    reaped_clients_.clear();
+    reaped_clients_.swap(closed_clients_);
+}
+
+//* ============================================================================
+//* OUTPUT
+//* ============================================================================
+
+void EventLoop::sendPendingData(ClientConnection* client)
+{
+    writePending(client);
+
+    // Drop POLLOUT once everything left, keep it while a tail remains
+    updatePollEvents(client, interestFor(client));
+}
+
+void EventLoop::writePending(ClientConnection* client)
+{
+    // Gather the queued lines (shared broadcast buffers included) into
+    // writev() calls instead of copying them into a contiguous buffer first.
+    // One call covers at most 64 segments, so keep going while the kernel
+    // takes everything offered: with edge-triggered epoll a writable socket
+    // is not reported again, and lines posted by other loops arrive as one
+    // segment each. The socket is non-blocking, so this never waits.
+    while (client->hasPendingSend())
+    {
+        struct iovec iov[64];
+        int iovcnt = client->fillSendIovec(iov, 64);
+        size_t offered = 0;
+        for (int i = 0; i < iovcnt; ++i)
+            offered += iov[i].iov_len;
+        size_t pending = client->getSendQueueSize();
+        ssize_t bytesSent = writev(client->getFd(), iov, iovcnt);
+        LoopCounters::add(counters_.writes);
+
+        if (bytesSent < 0)
+        {
+            // Normal errors in non-blocking
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                break; // Socket full, we'll try again on next POLLOUT
+
+            // Fatal error
+            LOG_WARN("[ERROR] send() failed: " << strerror(errno));
+            client->closeConnection();
+            return;
+        }
+
+        LOG_DEBUG("[DEBUG] Sent " << bytesSent << "/" << pending 
+                  << " bytes to fd=" << client->getFd());
+
+        // Only clear the bytes that were sent
+        client->clearSentData(bytesSent);
+        LoopCounters::add(counters_.bytesOut, bytesSent);
+        if ((size_t)bytesSent < offered)
+            break; // Short write: socket buffer is full
+    }
+}
+
+// The memory still held after a flush is this client's share of the loop's
+// sendq gauge. Every queued line makes the client dirty, so the gauge is
+// brought up to date in the same iteration.
+void EventLoop::countSendQueue(ClientConnection* client, size_t bytes)
+{
+    size_t counted = client->getCountedSendQueue();
+    if (bytes == counted)
+        return;
+    if (bytes > counted)
+        LoopCounters::add(counters_.sendqBytes, bytes - counted);
+    else
+        LoopCounters::sub(counters_.sendqBytes, counted - bytes);
+    client->setCountedSendQueue(bytes);
+}
+
+//* ============================================================================
+//* RUN QUEUE - fair share of command execution
+//* ============================================================================
+
+//* Execute one turn of a client's buffered lines: at most the line budget,
+//* and only what its flood-control bucket allows. Leftovers put the client
+//* at the back of the run queue.
+void EventLoop::runClient(ClientConnection* client)
+{
+	Server::RunResult result = server_.processClientCommands(client, config_.lineBudget);
+	if (result == Server::RUN_IDLE || client->isClosed())
+		return;
+	client->setDeferred(true);
+	run_queue_.push_back(client);
+	if (result == Server::RUN_THROTTLED)
+		__sync_fetch_and_add(&server_.getStats().floodDeferrals, 1UL);
+	else
+		__sync_fetch_and_add(&server_.getStats().budgetYields, 1UL);
+}
+
+//* Round robin: every queued client gets one turn per iteration, in the
+//* order they ran out of budget, so a noisy neighbour can delay a quiet
+//* client by at most one budget per busy connection.
+void EventLoop::runQueue()
+{
+	if (run_queue_.empty())
+		return;
+	std::vector<ClientConnection*> turn;
+	turn.swap(run_queue_);
+	for (size_t i = 0; i < turn.size(); ++i)
+	{
+		ClientConnection* client = turn[i];
+		client->setDeferred(false);
+		if (client->isClosed())		// Disconnected or evicted earlier in this turn
+			continue;
+		bool was_full = client->isRecvBufferFull();
+		Server::RunResult result = server_.processClientCommands(client, config_.lineBudget);
+		if (client->isClosed())
+		{
+			disconnectClient(client);
+			continue;
+		}
+		if (result != Server::RUN_IDLE)
+		{
+			client->setDeferred(true);
+			run_queue_.push_back(client);
+		}
+		// Room again in a full ring: POLLIN comes back (and re-arms edge mode)
+		if (was_full && !client->isRecvBufferFull())
+			updatePollEvents(client, interestFor(client));
+	}
+}
+
+//* Clients out of budget run again right away; throttled ones when their
+//* next token is due. -1 (block) when nobody is waiting.
+int EventLoop::nextRunTimeout() const
+{
+	if (run_queue_.empty())
+		return (-1);
+	unsigned long now = Clock::nowMs();
+	unsigned long soonest = 1000;
+	for (size_t i = 0; i < run_queue_.size() && soonest > 0; ++i)
+		soonest = std::min(soonest, run_queue_[i]->getFloodBucket().delay(now));
+	return (static_cast<int>(soonest));
+}
+
+//* ============================================================================
+//* TIMERS - registration, keepalive PING and ping timeout
+//* ============================================================================
+
+//* Read both clocks once per wakeup. Every message stamped in this
+//* iteration shares the same formatted string; localtime_r() and
+//* strftime() only run when the second changes.
+void EventLoop::updateClock()
+{
+	now_ = Clock::nowMs();
+	struct timespec ts;
+	clock_gettime(CLOCK_REALTIME, &ts);
+	wall_ms_ = static_cast<unsigned long>(ts.tv_sec) * 1000UL
+		+ static_cast<unsigned long>(ts.tv_nsec) / 1000000UL;
+	time_t wall = ts.tv_sec;
+	if (wall == wall_)
+		return;
+	wall_ = wall;
+	struct tm local;
+	char buffer[9];	//* HH:MM:SS\0
+	localtime_r(&wall, &local);
+	std::strftime(buffer, sizeof(buffer), "%H:%M:%S", &local);
+	timestamp_.assign(buffer);
+}
+
+//* Each connection holds exactly one timer, always armed for the next thing
+//* to check. Traffic never touches the wheel: reads only stamp the activity
+//* time, and the timer compares against it when it fires, moving itself
+//* forward if the client wasn't idle after all.
+void EventLoop::runTimers()
+{
+	timers_.advance(now_ / TIMER_TICK_MS, expired_timers_);
+	for (size_t i = 0; i < expired_timers_.size(); ++i)
+	{
+		if (expired_timers_[i] == &accept_timer_)
+		{
+			resumeAccepting();
+			continue;
+		}
+		ClientConnection* client = static_cast<ClientConnection*>(expired_timers_[i]->owner);
+		if (!client->isClosed())
+			onClientTimer(client);
+	}
+	expired_timers_.clear();
+}
+
+void EventLoop::onClientTimer(ClientConnection* client)
+{
+	unsigned long interval = config_.pingInterval * 1000UL;
+	unsigned long last = client->getLastActivity();
+
+	if (!client->isRegistered())
+	{
+		__sync_fetch_and_add(&server_.getStats().registrationTimeouts, 1UL);
+		killClient(client, "Registration timed out");
+		return;
+	}
+	if (client->getPingSentAt())
+	{
+		// Anything read since the PING proves the link is alive
+		if (last >= client->getPingSentAt())
+		{
+			client->clearPingSent();
+			scheduleClient(client, last + interval);
+			return;
+		}
+		std::ostringstream reason;
+		reason << "Ping timeout: " << config_.pingTimeout << " seconds";
+		__sync_fetch_and_add(&server_.getStats().pingTimeouts, 1UL);
+		killClient(client, reason.str().c_str());
+		return;
+	}
+	if (now_ - last < interval)
+	{
+		scheduleClient(client, last + interval);
+		return;
+	}
+	client->queueSend("PING :ft_irc\r\n");
+	client->markPingSent(now_);
+	__sync_fetch_and_add(&server_.getStats().pingsSent, 1UL);
+	scheduleClient(client, now_ + config_.pingTimeout * 1000UL);
+}
+
+//* PASS/NICK/USER done: no longer counts against its address, and the
+//* registration deadline gives way to the idle check
+void EventLoop::onRegistered(ClientConnection* client)
+{
+	LoopCounters::add(counters_.registered);
+	server_.releaseUnregistered(client->getUser()->getHostname());
+	scheduleClient(client, client->getLastActivity() + config_.pingInterval * 1000UL);
+}
+
+//* Rounded up to the next tick so a timer never fires before its deadline
+void EventLoop::scheduleClient(ClientConnection* client, unsigned long at)
+{
+	timers_.schedule(&client->getTimer(), (at + TIMER_TICK_MS - 1) / TIMER_TICK_MS);
+}
+
+int EventLoop::nextTimerTimeout() const
+{
+	long ticks = timers_.next();
+	if (ticks < 0)
+		return (-1);
+	unsigned long ms = static_cast<unsigned long>(ticks) * TIMER_TICK_MS - now_ % TIMER_TICK_MS;
+	return (static_cast<int>(std::min(ms, 60000UL)));
+}
+
+//* ============================================================================
+//* STATISTICS
+//* ============================================================================
+
+//* Send queues belong to this thread, so each loop reports its own; the
+//* walk over clients_ only happens when a dump was asked for.
+void EventLoop::reportStats()
+{
+	size_t queued = 0, deepest = 0, paused = 0;
+	unsigned long dropped = 0;
+	for (size_t i = 0; i < clients_.size(); ++i)
+	{
+		size_t depth = clients_[i]->getSendQueueMemory();
+		queued += depth;
+		deepest = std::max(deepest, depth);
+		if (!(clients_[i]->getPollEvents() & POLLIN))
+			paused++;
+		dropped += clients_[i]->getDroppedCount();
+	}
+	LOG_INFO(CYAN << "[STATS] loop " << index_ << ": clients=" << clients_.size()
+			  << " sendq=" << queued << "B (max " << deepest << "B)"
+			  << " read-paused=" << paused << " dropped=" << dropped
+			  << " writev=" << counters_.writes
+			  << RESET);
+	if (index_ == 0)
+		server_.dumpStats();
+}
+
+//* ============================================================================
+//* UTILITIES
+//* ============================================================================
+
+void EventLoop::addClientToPoll(ClientConnection* client)
+{
+	backend_->add(client->getFd(), POLLIN);     //* Register interest in read events (incoming data)
+	client->setPollEvents(POLLIN);
+	client->setLoop(this);                      //* Other threads post to us instead of touching buffers
+	client->setOutputList(&output_pending_);    //* queueSend() reports here so we can arm POLLOUT
+	client->setSendQueueLimits(config_.sendqLow, config_.sendqHigh, config_.sendqMax);
+	client->getFloodBucket().configure(config_.floodBurst, config_.floodRate, now_);
+}
+
+//* Change the interest registered for a client. Skips the backend call when
+//* nothing changed (with epoll every modify is a syscall).
+void EventLoop::updatePollEvents(ClientConnection* client, short events)
+{
+	if (client->isClosed() || client->getPollEvents() == events)
+		return;
+	if (backend_->modify(client->getFd(), events))
+		client->setPollEvents(events);
+}
+
+//* POLLOUT while output is queued. POLLIN unless backpressure paused reading
+//* or the receive ring is full of lines still waiting for their turn.
+short EventLoop::interestFor(ClientConnection* client)
+{
+	bool paused = client->updateReadPause();
+	short events = (paused || client->isRecvBufferFull()) ? 0 : POLLIN;
+	if (client->hasPendingSend())
+		events |= POLLOUT;
+	return (events);
+}
+
+//* End of the iteration: handlers only queue, so a burst of commands into a
+//* busy channel costs each member one writev() here instead of one per line.
+//* Only the clients that queued output (or got POLLOUT) are walked; POLLOUT
+//* stays armed for the tails the kernel didn't take. Connections closed on
+//* the way (SendQ exceeded while another client was broadcasting) are torn
+//* down here, outside any handler. Teardown can queue QUITs for others,
+//* which join the list and are flushed in the same pass.
+void EventLoop::flushPendingOutput()
+{
+	for (size_t i = 0; i < output_pending_.size(); ++i)
+	{
+		ClientConnection* client = output_pending_[i];
+		client->clearOutputQueued();
+		if (!client->isClosed() && client->hasPendingSend())
+			writePending(client);
+		if (client->isClosed())
+		{
+			if (findClientByFd(client->getFd()) == client)
+				disconnectClient(client);
+			continue;
+		}
+		countSendQueue(client, client->getSendQueueMemory());
+		updatePollEvents(client, interestFor(client));
+	}
+	output_pending_.clear();
+}
+
+ClientConnection* EventLoop::findClientByFd(int fd)
+{
+	return (fd_table_.find(fd));
+}
+
+void EventLoop::indexClient(ClientConnection* client)
+{
+	fd_table_.insert(client->getFd(), client);
+}
+
+void EventLoop::unindexClient(ClientConnection* client)
+{
+	fd_table_.erase(client->getFd(), client);
+}
@@ -0,0 +1,192 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   EventLoop.hpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 18:02:37 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 18:02:37 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef EVENT_LOOP_HPP
+#define EVENT_LOOP_HPP
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <ctime>
+#include <pthread.h>
+#include "../net/EventBackend.hpp"
+#include "../utils/MpscQueue.hpp"
+#include "../utils/TimerWheel.hpp"
+#include "../utils/FdTable.hpp"
+#include "../client/ClientConnection.hpp"
+#include "ServerStats.hpp"
+
+class Server;
+struct ServerConfig;
+class SharedBuffer;
+
+/**
+ * EventLoop: One reactor (one thread, one backend, its own connections)
+ *
+ * Responsibilities:
+ * - Own listening socket (SO_REUSEPORT when there are several loops), or
+ *   connections handed over by the Acceptor thread (adopt())
+ * - Read, frame and write for the connections it owns
+ * - Hand complete lines to the Server, which runs them under its state lock
+ * - Receive output for its connections from other loops (inbox)
+ *
+ * Only the owning thread touches a connection's buffers. Another loop that
+ * wants to send to it calls post(): the line goes through a lock-free MPSC
+ * inbox and the owner is woken through a self-pipe.
+ */
+
+class EventLoop
+{
+	public:
+		EventLoop(Server& server, const ServerConfig& config, int index);
+		~EventLoop();
+
+		bool	open(bool listen, bool reusePort);	//* [Listener] + backend + wakeup pipe
+		void	run();								//* Loop until stop()
+		bool	spawn();							//* run() in a new thread
+		void	join();
+		void	stop();								//* Async-signal-safe
+
+		//* CROSS-THREAD DELIVERY
+		static EventLoop*	current();				//* Loop running on this thread (or NULL)
+		bool	isCurrent() const;
+		void	post(ClientConnection* client, SharedBuffer* buffer,
+					ClientConnection::OutputPriority priority);			//* Any thread
+		void	adopt(ClientConnection* client, unsigned long accepted_at);	//* Any thread (Acceptor)
+		void	wake();								//* Any thread, async-signal-safe
+		void	requestReport();					//* Print stats next iteration, async-signal-safe
+
+		//* COUNTERS (written by the owner thread, read from any)
+		LoopCounters&	getCounters();
+		const LoopCounters&	getCounters() const;
+		static void	countLineOut(size_t bytes);		//* One line admitted to a send queue of the calling loop
+		CommandProfile&	getProfile();
+		const CommandProfile&	getProfile() const;
+		void	requestProfileReset();				//* Cleared by the owner next iteration, any thread
+
+		//* REGISTRATION (owner thread only)
+		void	onRegistered(ClientConnection* client);	//* Free its unregistered slot, start keepalive
+
+		size_t	getLoad() const;					//* Connections owned + being handed over
+		int		getIndex() const;
+		unsigned long	now() const;				//* Clock::nowMs() at the last wakeup (owner thread)
+		const std::string&	timestamp() const;		//* Wall clock "HH:MM:SS" at the last wakeup
+		const std::string&	serverTime();			//* Same instant as IRCv3 server-time (UTC, ms)
+
+	private:
+		struct Delivery
+		{
+			ClientConnection*	client;
+			SharedBuffer*		buffer;		//* Reference owned by the inbox entry
+			ClientConnection::OutputPriority	priority;
+			CommandId			command;	//* Running on the posting loop, for STATS m
+		};
+
+		struct Handoff
+		{
+			ClientConnection*	client;
+			unsigned long		accepted_at;	//* LatencyHistogram::now() at accept4()
+		};
+
+		Server&				server_;
+		const ServerConfig&	config_;
+		int					index_;
+		int					listen_fd_;
+		int					running_;				//* Read/written with __atomic (signal handler)
+		int					report_requested_;		//* Set by requestReport() (__atomic)
+		int					profile_reset_requested_;	//* Set by requestProfileReset() (__atomic)
+
+		//* THREAD + WAKEUP
+		pthread_t			thread_;
+		bool				thread_started_;
+		int					wake_fds_[2];			//* Self-pipe: [0] read end, [1] write end
+		volatile int		wake_pending_;			//* 1 = a wakeup byte is already in flight
+		MpscQueue<Delivery>	inbox_;					//* Output posted by other loops
+		MpscQueue<Handoff>	handoff_;				//* New connections from the Acceptor
+		size_t				load_;					//* Atomic: least-loaded loop selection
+
+		//* EVENT LOOP
+		EventBackend*		backend_;				//* poll() or epoll(), chosen at startup
+		std::vector<IoEvent> ready_events_;			//* Descriptors reported ready by the last wait
+		std::vector<ClientConnection*> output_pending_;	//* Dirty: queued output since the last flush
+		std::vector<ClientConnection*> closed_clients_;	//* Disconnected during this iteration
+		std::vector<ClientConnection*> reaped_clients_;	//* Disconnected last iteration, deleted at its end
+		std::vector<ClientConnection*> run_queue_;	//* Lines left over (line budget or flood control)
+		LoopCounters		counters_;				//* STATS, LUSERS, metrics, SIGUSR1 report
+		CommandProfile		profile_;				//* Per-command histograms (STATS p)
+
+		//* TIMERS (registration, PING, idle)
+		static const unsigned long TIMER_TICK_MS = 100;	//* Wheel resolution
+		unsigned long		now_;					//* Refreshed once per iteration
+		time_t				wall_;					//* Second timestamp_ was formatted for
+		std::string			timestamp_;				//* "HH:MM:SS", reformatted when wall_ changes
+		unsigned long		wall_ms_;				//* Wall clock in ms at the last wakeup
+		unsigned long		server_time_ms_;		//* Instant server_time_ was formatted for
+		std::string			server_time_;			//* "YYYY-MM-DDThh:mm:ss.sssZ", built on demand
+		TimerWheel			timers_;				//* One node per connection, in ticks
+		TimerWheel::Node	accept_timer_;			//* Re-arms the listener after an accept() back-off
+		std::vector<TimerWheel::Node*> expired_timers_;
+
+		//* COLLECTIONS
+		std::vector<ClientConnection*> clients_;	//* Connections owned by this loop
+		FdTable<ClientConnection> fd_table_;		//* fd -> ClientConnection, O(1) lookup
+
+		//* CONNECTION MANAGEMENT
+		void	acceptNewConnections();
+		void	pauseAccepting();					//* Listener out of the backend for a back-off
+		void	resumeAccepting();
+		void	registerClient(ClientConnection* client, unsigned long accepted_at);
+		void	rejectClient(ClientConnection* client, const char* reason);	//* Before it was ever registered
+		bool	handleClientEvent(int fd, short revents);
+		void	disconnectClient(ClientConnection* client);
+		void	killClient(ClientConnection* client, const char* reason);	//* ERROR line + disconnect
+		void	reapClosedClients();
+
+		//* CROSS-THREAD DELIVERY
+		void	drainWakeup();
+		void	rearmWakeup();						//* Reset wake_pending_ before draining
+		void	drainInbox();
+		void	drainHandoff();
+
+		//* UTILITIES
+		void	addClientToPoll(ClientConnection* client);
+		void	updatePollEvents(ClientConnection* client, short events);
+		void	flushPendingOutput();				//* Once per iteration, every dirty client
+		void	sendPendingData(ClientConnection* client);	//* writePending() + interest update
+		void	writePending(ClientConnection* client);	//* writev() until empty or EAGAIN
+		void	countSendQueue(ClientConnection* client, size_t bytes);	//* Move its share of the gauge
+		short	interestFor(ClientConnection* client);
+		void	reportStats();
+
+		//* RUN QUEUE
+		void	runClient(ClientConnection* client);
+		void	runQueue();
+		int		nextRunTimeout() const;				//* ms for the backend wait, -1 = none
+
+		//* TIMERS
+		void	updateClock();						//* now_, and timestamp_ on a new second
+		void	runTimers();
+		void	onClientTimer(ClientConnection* client);
+		void	scheduleClient(ClientConnection* client, unsigned long at);	//* at: ms
+		int		nextTimerTimeout() const;			//* ms until the wheel is due, -1 = none
+		ClientConnection* findClientByFd(int fd);
+		void	indexClient(ClientConnection* client);
+		void	unindexClient(ClientConnection* client);
+
+		static void*	threadMain(void* arg);
+
+		//* NON-COPYABLE
+		EventLoop(const EventLoop&);
+		EventLoop& operator=(const EventLoop&);
+};
+
+#endif
@@ -0,0 +1,235 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   MetricsListener.cpp                                :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 03:40:12 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 03:40:12 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "MetricsListener.hpp"
+#include "Server.hpp"
+#include "ServerConfig.hpp"
+#include "../net/SocketUtils.hpp"
+#include "../utils/Colors.hpp"
+#include "../utils/Log.hpp"
+
+#include <unistd.h>
+#include <poll.h>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <sys/socket.h>
+
+MetricsListener::MetricsListener(Server& server, const ServerConfig& config)
+	: server_(server), config_(config), tcp_fd_(-1), unix_fd_(-1), running_(0),
+	thread_started_(false)
+{
+	wake_fds_[0] = -1;
+	wake_fds_[1] = -1;
+}
+
+MetricsListener::~MetricsListener()
+{
+	if (tcp_fd_ >= 0)
+		close(tcp_fd_);
+	if (unix_fd_ >= 0)
+	{
+		close(unix_fd_);
+		unlink(config_.metricsSocket.c_str());
+	}
+	if (wake_fds_[0] >= 0)
+		close(wake_fds_[0]);
+	if (wake_fds_[1] >= 0)
+		close(wake_fds_[1]);
+}
+
+//* ============================================================================
+//* SETUP
+//* ============================================================================
+
+bool MetricsListener::open()
+{
+	if (config_.metricsPort)
+	{
+		tcp_fd_ = SocketUtils::createServerSocket();
+		if (tcp_fd_ < 0)
+			return (false);
+		if (!SocketUtils::bindSocket(tcp_fd_, config_.metricsPort, true)
+			|| !SocketUtils::listenSocket(tcp_fd_, 16))
+			return (false);
+	}
+	if (!config_.metricsSocket.empty())
+	{
+		unix_fd_ = SocketUtils::createUnixServerSocket(config_.metricsSocket);
+		if (unix_fd_ < 0 || !SocketUtils::listenSocket(unix_fd_, 16))
+			return (false);
+	}
+
+	if (pipe(wake_fds_) == -1)
+	{
+		LOG_ERROR(BRIGHT_RED << "[METRICS] pipe() failed: " << strerror(errno) << RESET);
+		return (false);
+	}
+	__atomic_store_n(&running_, 1, __ATOMIC_RELAXED);
+	return (true);
+}
+
+//* ============================================================================
+//* THREAD
+//* ============================================================================
+
+void* MetricsListener::threadMain(void* arg)
+{
+	static_cast<MetricsListener*>(arg)->run();
+	return (NULL);
+}
+
+bool MetricsListener::spawn()
+{
+	if (pthread_create(&thread_, NULL, &MetricsListener::threadMain, this) != 0)
+	{
+		LOG_ERROR(BRIGHT_RED << "[METRICS] pthread_create() failed" << RESET);
+		return (false);
+	}
+	thread_started_ = true;
+	return (true);
+}
+
+void MetricsListener::join()
+{
+	if (thread_started_)
+		pthread_join(thread_, NULL);
+	thread_started_ = false;
+}
+
+//* Called from the signal handler: only a flag and a write(), both safe there
+void MetricsListener::stop()
+{
+	__atomic_store_n(&running_, 0, __ATOMIC_RELAXED);
+	if (wake_fds_[1] >= 0)
+	{
+		char byte = 0;
+		ssize_t ignored = write(wake_fds_[1], &byte, 1);
+		(void)ignored;
+	}
+}
+
+//* ============================================================================
+//* SERVE LOOP
+//* ============================================================================
+
+void MetricsListener::run()
+{
+	struct pollfd fds[3];
+	nfds_t count = 0;
+	fds[count].fd = wake_fds_[0];
+	fds[count++].events = POLLIN;
+	if (tcp_fd_ >= 0)
+	{
+		fds[count].fd = tcp_fd_;
+		fds[count++].events = POLLIN;
+	}
+	if (unix_fd_ >= 0)
+	{
+		fds[count].fd = unix_fd_;
+		fds[count++].events = POLLIN;
+	}
+
+	while (__atomic_load_n(&running_, __ATOMIC_RELAXED))
+	{
+		if (poll(fds, count, -1) < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			LOG_ERROR("[ERROR] metrics poll() failed: " << strerror(errno));
+			break;
+		}
+		for (nfds_t i = 1; i < count; ++i)
+		{
+			if (fds[i].revents & POLLIN)
+				acceptPending(fds[i].fd);
+		}
+	}
+}
+
+void MetricsListener::acceptPending(int listen_fd)
+{
+	while (true)
+	{
+		int fd = accept(listen_fd, NULL, NULL);
+		if (fd < 0)
+			break;
+		if (SocketUtils::setNonBlocking(fd))
+			serve(fd);
+		close(fd);
+	}
+}
+
+//* One request, one response, then close (HTTP/1.0). Any GET gets the page.
+void MetricsListener::serve(int fd)
+{
+	std::string request;
+	if (!readRequest(fd, request))
+		return;
+
+	std::string body;
+	std::string status = "200 OK";
+	if (request.compare(0, 4, "GET ") == 0)
+		server_.renderMetrics(body);
+	else
+	{
+		status = "405 Method Not Allowed";
+		body = "GET only\n";
+	}
+
+	std::ostringstream response;
+	response << "HTTP/1.0 " << status << "\r\n"
+			 << "Content-Type: text/plain; version=0.0.4\r\n"
+			 << "Content-Length: " << body.size() << "\r\n"
+			 << "Connection: close\r\n\r\n"
+			 << body;
+	std::string data = response.str();
+
+	size_t sent = 0;
+	struct pollfd pfd;
+	pfd.fd = fd;
+	pfd.events = POLLOUT;
+	while (sent < data.size() && poll(&pfd, 1, TIMEOUT_MS) > 0)
+	{
+		ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+		if (n <= 0 && !SocketUtils::isWouldBlock())
+			break;
+		if (n > 0)
+			sent += n;
+	}
+}
+
+//* Up to the blank line ending the headers, within REQUEST_MAX and TIMEOUT_MS
+bool MetricsListener::readRequest(int fd, std::string& request)
+{
+	char buffer[1024];
+	struct pollfd pfd;
+	pfd.fd = fd;
+	pfd.events = POLLIN;
+	while (request.size() < REQUEST_MAX && poll(&pfd, 1, TIMEOUT_MS) > 0)
+	{
+		ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+		if (n == 0)
+			break;
+		if (n < 0)
+		{
+			if (SocketUtils::isWouldBlock() || errno == EINTR)
+				continue;
+			return (false);
+		}
+		request.append(buffer, n);
+		if (request.find("\r\n\r\n") != std::string::npos
+			|| request.find("\n\n") != std::string::npos)
+			break;
+	}
+	return (!request.empty());
+}
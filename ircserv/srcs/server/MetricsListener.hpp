@@ -0,0 +1,67 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   MetricsListener.hpp                                :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 03:40:12 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 03:40:12 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef METRICS_LISTENER_HPP
+#define METRICS_LISTENER_HPP
+
+#include <string>
+#include <pthread.h>
+
+class Server;
+struct ServerConfig;
+
+/**
+ * MetricsListener: Prometheus text endpoint (--metrics-port, --metrics-socket)
+ *
+ * Its own thread, blocked in poll() on a 127.0.0.1 TCP listener and/or a
+ * Unix socket. Each scrape is one short HTTP/1.0 exchange served inline:
+ * the page is rendered from the counters (Server::renderMetrics()), never
+ * from the IRC state, so a scrape neither takes the state lock nor wakes
+ * an event loop.
+ */
+
+class MetricsListener
+{
+	public:
+		MetricsListener(Server& server, const ServerConfig& config);
+		~MetricsListener();
+
+		bool	open();							//* Listener(s) + wakeup pipe
+		bool	spawn();
+		void	join();
+		void	stop();							//* Async-signal-safe
+
+	private:
+		static const size_t REQUEST_MAX = 4096;	//* Longer requests are cut off
+		static const int	TIMEOUT_MS = 1000;	//* Per scrape, so a stuck peer can't hold the thread
+
+		Server&				server_;
+		const ServerConfig&	config_;
+		int					tcp_fd_;
+		int					unix_fd_;
+		int					wake_fds_[2];
+		int					running_;			//* Read/written with __atomic
+		pthread_t			thread_;
+		bool				thread_started_;
+
+		void	run();
+		void	acceptPending(int listen_fd);
+		void	serve(int fd);
+		bool	readRequest(int fd, std::string& request);
+
+		static void*	threadMain(void* arg);
+
+		MetricsListener(const MetricsListener&);
+		MetricsListener& operator=(const MetricsListener&);
+};
+
+#endif
@@ -11,186 +11,173 @@
 /* ************************************************************************** */
 
 #include "Server.hpp"
+#include "EventLoop.hpp"
+#include "Acceptor.hpp"
+#include "MetricsListener.hpp"
 #include "../client/ClientConnection.hpp"
 #include "../client/User.hpp"
 #include "../channel/Channel.hpp"
-#include "../net/SocketUtils.hpp"
 #include "../irc/Parser.hpp"
+#include "../irc/CaseMapping.hpp"
+#include "../irc/IrcLine.hpp"
 #include "../utils/Colors.hpp"
+#include "../utils/Log.hpp"
+#include "../utils/SharedBuffer.hpp"
+#include "../utils/LatencyHistogram.hpp"
+#include "../utils/TokenBucket.hpp"
+#include "../utils/Clock.hpp"
 
 #include <unistd.h>
 #include <cerrno>
 #include <cstring>
 #include <algorithm>
-#include <iostream>
+#include <sstream>
 #include <sys/socket.h>
 #include <ctime>
+#include <csignal>
 
 //* ============================================================================
 //* CONSTRUCTOR Y DESTRUCTOR
 //* ============================================================================
 
-Server::Server(int port, const std::string& password) : port_(port), 
-	password_(password), server_fd_(-1), running_(false)
+Server::Server(const ServerConfig& config) : config_(config), port_(config.port),
+	password_(config.password), threaded_(config.threads > 1), acceptor_(NULL), metrics_(NULL), started_(std::time(NULL))
 {
+	pthread_mutex_init(&state_lock_, NULL);
+	pthread_mutex_init(&unregistered_lock_, NULL);
 	initCommands();
-    std::cout << CYAN << "[SERVER] Initializing on port " << port << RESET << std::endl;	
+	Clock::calibrate();							//* Before any loop thread times a command
+
+	//* Output style for every line built from here on (--format)
+	IrcLine::setStyle(config.format == ServerConfig::FORMAT_RFC
+		? IrcLine::STYLE_RFC : IrcLine::STYLE_COLOR);
+
+	//* Same bytes for every new client: serialized once, shared by pointer
+	IrcLine banner;
+	banner.add(":ft_irc NOTICE * :").paint(BRIGHT_GREEN, "*** Welcome to ft_irc!").end()
+		.add(":ft_irc NOTICE * :").paint(CYAN, "*** To get started, please authenticate:").end()
+		.add(":ft_irc NOTICE * :").paint(CYAN, "***   1. PASS <password>").end()
+		.add(":ft_irc NOTICE * :").paint(CYAN, "***   2. NICK <your_nickname>").end()
+		.add(":ft_irc NOTICE * :").paint(CYAN, "***   3. USER <username> 0 * :<realname>").end();
+	welcome_ = SharedBuffer::create(banner.str());
+    LOG_INFO(CYAN << "[SERVER] Initializing on port " << port_ << RESET);	
 }
 
 Server::~Server()
 {
-    std::cout << YELLOW << "[SERVER] Shutting down..." << RESET << std::endl;
+    LOG_INFO(YELLOW << "[SERVER] Shutting down..." << RESET);
 
-	//* CLOSE SERVER SOCKET
-	if (server_fd_ >= 0)
-		close(server_fd_);
+	//* CLEANUP ACCEPTOR first: it may still hold a connection for a loop
+	delete acceptor_;
+	delete metrics_;
 
-	//* CLEANUP CLIENTS
-	for (size_t i = 0; i < clients_.size(); i++)
-	{
-		if (clients_[i])
-		{
-			User* user = clients_[i]->getUser();		//* Get associated User before deleting connection
-
-			close(clients_[i]->getFd());
-			delete clients_[i];							//* Delete ClientConnection
-			
-			if (user)								    //* Delete User if exists
-				delete user;
-		}
-	}
+	//* CLEANUP LOOPS (sockets, connections and their Users)
+	for (size_t i = 0; i < loops_.size(); ++i)
+		delete loops_[i];
+	welcome_->release();
 
 	//* CLEANUP CHANNELS
 	for (size_t i = 0; i < channels_.size(); ++i)
 		delete channels_[i];
+
+	pthread_mutex_destroy(&unregistered_lock_);
+	pthread_mutex_destroy(&state_lock_);
 }
 
 //* ============================================================================
-//* SETUP - Uses SocketUtils for all socket operations
+//* SETUP - Each EventLoop opens its own listening socket
 //* ============================================================================
 
-bool Server::setupServerSocket()
+bool Server::start()
 {
-	server_fd_ = SocketUtils::createServerSocket();               //* Create a non-blocking TCP socket for the server
-	if (server_fd_ < 0)
-		return (false);
-	
-	if (!SocketUtils::bindSocket(server_fd_, port_))              //* Bind socket to specified port (associates socket with network address)
+	LOG_INFO(CYAN << "[SERVER] Starting..." << RESET);
+
+	//* A stale perfect-hash table fails here rather than on some client's line
+	if (!checkCommandTable())
 	{
-		close(server_fd_);
-		server_fd_ = -1;
+		LOG_ERROR(BRIGHT_RED << "[SERVER] Command table out of date: run tools/gen_command_table.py --write" << RESET);
 		return (false);
 	}
 
-	if (!SocketUtils::listenSocket(server_fd_, SOMAXCONN))        //* Mark socket as passive (ready to accept connections), SOMAXCONN = max queue size
+	//* With several loops every listener binds the same port (SO_REUSEPORT)
+	//* and the kernel spreads new connections between them. With an acceptor
+	//* thread the loops have no listener: it picks the least-loaded one.
+	bool listen = !config_.acceptorThread;
+	for (int i = 0; i < config_.threads; ++i)
 	{
-		close(server_fd_);
-		server_fd_ = 1;
-		return (false);
+		EventLoop* loop = new EventLoop(*this, config_, i);
+		loops_.push_back(loop);
+		if (!loop->open(listen, listen && threaded_))
+			return (false);
+	}
+	if (config_.acceptorThread)
+	{
+		acceptor_ = new Acceptor(config_, loops_);
+		if (!acceptor_->open())
+			return (false);
+	}
+	if (config_.metricsPort || !config_.metricsSocket.empty())
+	{
+		metrics_ = new MetricsListener(*this, config_);
+		if (!metrics_->open())
+			return (false);
 	}
-	return (true);
-}
-
-bool Server::start()
-{
-	std::cout << CYAN << "[SERVER] Starting..." << RESET << std::endl;
 
-	if (!setupServerSocket())
-		return (false);
-	
-	//* ADD SERVER SOCKET TO POLL
-	struct pollfd server_pfd;              //* POSIX structure to monitor file descriptors for I/O events
-	server_pfd.fd = server_fd_;            //* Tell poll() which socket to monitor (server's listening socket)
-	server_pfd.events = POLLIN;            //* Register interest in read events (POLLIN = data available to read = new connection ready)
-	server_pfd.revents = 0;                //* Clear "returned events" field (poll() fills this with actual events that occurred)
-	poll_fds_.push_back(server_pfd);       //* Add to vector so poll() can monitor server socket + all client sockets together (MULTIPLE USERS!)
-	
-	running_ = true;
-	std::cout << GREEN << "[SERVER] ✓ Ready on port " << port_ << RESET << std::endl;
+	LOG_INFO(GREEN << "[SERVER] ✓ Ready on port " << port_
+			  << " (" << ServerConfig::backendName(config_.backend)
+			  << ", " << loops_.size() << " loop" << (loops_.size() > 1 ? "s" : "")
+			  << ", " << ServerConfig::formatName(config_.format) << " output"
+			  << ")" << RESET);
 	return (true);
 }
 
+//* Called from the signal handler: EventLoop::stop() is async-signal-safe
 void Server::stop()
 {
-    running_ = false;
+	if (acceptor_)
+		acceptor_->stop();
+	if (metrics_)
+		metrics_->stop();
+	for (size_t i = 0; i < loops_.size(); ++i)
+		loops_[i]->stop();
 }
 
 //* ============================================================================
-//* MAIN LOOP - SINGLE poll() (required by 42)
+//* MAIN LOOP - loops_[0] here, the others on their own threads
 //* ============================================================================
 
 void Server::run()
 {
-    std::cout << CYAN << "[SERVER] Main loop started" << RESET << std::endl;
-
-    while (running_)
+    LOG_INFO(CYAN << "[SERVER] Main loop started" << RESET);
+
+    //* Worker threads inherit this mask: SIGINT/SIGTERM always land on the
+    //* main thread, whose handler then wakes every loop.
+    sigset_t blocked, previous;
+    sigemptyset(&blocked);
+    sigaddset(&blocked, SIGINT);
+    sigaddset(&blocked, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &blocked, &previous);
+    for (size_t i = 1; i < loops_.size(); ++i)
     {
-        // ------------------------------------------------------------------
-        //  CRITICAL FIX - events weren't being notified correctly, so I made this little fix :D
-        // ------------------------------------------------------------------
-        // We check if any client has pending data to send.
-        // If so, we tell poll() to notify us when we can write (POLLOUT).
-        // If not, we only listen if they send us data (POLLIN).
-        for (size_t i = 0; i < poll_fds_.size(); ++i)
-        {
-            // The server socket only listens for new connections (POLLIN)
-            if (poll_fds_[i].fd == server_fd_) 
-                continue;
-
-            ClientConnection* client = findClientByFd(poll_fds_[i].fd);
-            if (client)
-            {
-                if (client->hasPendingSend())
-                {
-                    // We want to read (if client writes) OR write (if there's pending buffer)
-                    poll_fds_[i].events = POLLIN | POLLOUT;
-                }
-                else
-                {
-                    // We're only interested in reading
-                    poll_fds_[i].events = POLLIN;
-                }
-            }
-        }
-
-        //* WAIT FOR ACTIVITY on any socket (server + all clients)
-        //* poll() with "-1" blocks here until something happens
-        int poll_count = poll(&poll_fds_[0], poll_fds_.size(), -1);
-        
-        //* HANDLE POLL ERRORS
-        if (poll_count < 0)
-        {
-            if (errno == EINTR)              //* Interrupted by signal (e.g., Ctrl+C) - not fatal
-                continue;                    //* Restart poll() loop
-            std::cerr << "[ERROR] poll() failed" << std::endl; //* If it is other error...
-            break;                           //* Fatal error - exit loop
-        }
-        
-        //* CHECK EACH SOCKET for activity
-        // We don't increment 'i' automatically in the for loop.
-        // We only increment if we DON'T delete the current client.
-        for (size_t i = 0; i < poll_fds_.size(); /* empty */)
-        {
-            // Case 1: Server Socket (New connections)
-            if (poll_fds_[i].fd == server_fd_)
-            {
-                if (poll_fds_[i].revents & POLLIN)
-                    acceptNewConnections();
-                i++; // Server socket is never deleted here
-            }
-            // Case 2: Client Socket
-            else
-            {
-                // If it returns false, the client was deleted and 'poll_fds_' was reduced.
-                // We don't increment 'i' because the next client is now at 'i'.
-                if (!handleClientEvent(i))
-                    continue; 
-                
-                i++; // Client still alive, move to next
-            }
-        }
+        if (!loops_[i]->spawn())
+            stop();
     }
-    std::cout << YELLOW << "[SERVER] Main loop ended" << RESET << std::endl;
+    if (acceptor_ && !acceptor_->spawn())
+        stop();
+    if (metrics_ && !metrics_->spawn())
+        stop();
+    pthread_sigmask(SIG_SETMASK, &previous, NULL);
+
+    loops_[0]->run();
+
+    stop();
+    if (acceptor_)
+        acceptor_->join();
+    if (metrics_)
+        metrics_->join();
+    for (size_t i = 1; i < loops_.size(); ++i)
+        loops_[i]->join();
+    LOG_INFO(YELLOW << "[SERVER] Main loop ended" << RESET);
 }
 
 //* ============================================================================
@@ -204,397 +191,502 @@ const std::string& Server::getPassword() const
 
 int Server::getClientCount() const
 {
-	return (clients_.size());
+	size_t count = 0;
+	for (size_t i = 0; i < loops_.size(); ++i)
+		count += loops_[i]->getLoad();
+	return (count);
+}
+
+SharedBuffer* Server::getWelcome() const
+{
+	return (welcome_);
+}
+
+ServerStats& Server::getStats()
+{
+	return (stats_);
 }
 
 //* ============================================================================
-//* ACCEPT - Uses SocketUtils
+//* STATISTICS - SIGUSR1 dump
 //* ============================================================================
 
-//* ACCEPT NEW CONNECTIONS
-//* Core function that handles incoming client connections to the IRC server.
-//* Creates ClientConnection and User objects, links them together, and adds
-//* the new client to both the clients_ vector and poll monitoring system.
-//* Uses non-blocking socket operations to accept multiple pending connections.
+//* Called from the signal handler: every loop reports its own connections
+//* on its next iteration, loops_[0] adds the server-wide figures.
+void Server::requestStatsDump()
+{
+	for (size_t i = 0; i < loops_.size(); ++i)
+		loops_[i]->requestReport();
+}
 
-void Server::acceptNewConnections()
+void Server::dumpStats()
 {
-	//* ACCEPT ALL PENDING CONNECTIONS in a loop (non-blocking)
-	while (true)
+	std::ostringstream loads;
+	for (size_t i = 0; i < loops_.size(); ++i)
+		loads << (i ? " " : "") << loops_[i]->getLoad();
+	std::ostringstream latency;
+	stats_.acceptLatency.print(latency);
+
+	LOG_INFO(CYAN << "[STATS] connections=" << getClientCount() << " loops=[" << loads.str() << "]" << RESET);
+	LOG_INFO(CYAN << "[STATS] accept latency: " << latency.str() << RESET);
+	LOG_INFO(CYAN << "[STATS] sendq evictions=" << __atomic_load_n(&stats_.sendqEvictions, __ATOMIC_RELAXED)
+			  << " dropped (closed clients)=" << __atomic_load_n(&stats_.sendqDropped, __ATOMIC_RELAXED)
+			  << RESET);
+	LOG_INFO(CYAN << "[STATS] flood deferrals=" << __atomic_load_n(&stats_.floodDeferrals, __ATOMIC_RELAXED)
+			  << " excess flood=" << __atomic_load_n(&stats_.excessFlood, __ATOMIC_RELAXED)
+			  << " budget yields=" << __atomic_load_n(&stats_.budgetYields, __ATOMIC_RELAXED)
+			  << RESET);
+	LOG_INFO(CYAN << "[STATS] pings sent=" << __atomic_load_n(&stats_.pingsSent, __ATOMIC_RELAXED)
+			  << " ping timeouts=" << __atomic_load_n(&stats_.pingTimeouts, __ATOMIC_RELAXED)
+			  << " registration timeouts=" << __atomic_load_n(&stats_.registrationTimeouts, __ATOMIC_RELAXED)
+			  << " unregistered rejected=" << __atomic_load_n(&stats_.unregisteredRejected, __ATOMIC_RELAXED)
+			  << RESET);
+
+	//* Per command, only those that ran since start (or the last reset)
+	CommandProfile& profile = report_profile_;
+	collectProfile(profile);
+	for (size_t id = 0; id < CMD_COUNT; ++id)
 	{
-		std::string client_ip;                                             //* Will store client's IP address
-		int client_fd = SocketUtils::acceptClient(server_fd_, client_ip);  //* Accept one connection, get client socket fd and IP
-
-		//* BREAK if no more connections pending (non-blocking would return -1)
-		if (client_fd < 0)
-			break;
-
-		//* CREATE CLIENT CONNECTION OBJECT (manages socket I/O and buffers)
-		ClientConnection* connection = new ClientConnection(client_fd);
-
-		//* CREATE USER OBJECT (stores IRC user data: nick, username, channels, etc.)
-		User* user = new User();
-		user->setHostname(client_ip);                                       //* Store client's IP address in user profile
-		user->setConnection(connection);                                    //* Link User -> ClientConnection (bidirectional relationship)
-		connection->setUser(user);                                          //* Link ClientConnection -> User
-
-		//* REGISTER CLIENT in server's client list
-		clients_.push_back(connection);                                     //* Add to vector for tracking all connected clients
-		addClientToPoll(connection);                                        //* Add client's fd to poll_fds_ for I/O monitoring
-
-		//* SEND WELCOME MESSAGE with authentication instructions
-		std::string welcome = 
-			":ft_irc NOTICE * :" + std::string(BRIGHT_GREEN) + "*** Welcome to ft_irc!" + RESET + "\r\n"
-			":ft_irc NOTICE * :" + std::string(CYAN) + "*** To get started, please authenticate:" + RESET + "\r\n"
-			":ft_irc NOTICE * :" + std::string(CYAN) + "***   1. PASS <password>" + RESET + "\r\n"
-			":ft_irc NOTICE * :" + std::string(CYAN) + "***   2. NICK <your_nickname>" + RESET + "\r\n"
-			":ft_irc NOTICE * :" + std::string(CYAN) + "***   3. USER <username> 0 * :<realname>" + RESET + "\r\n";
-		connection->queueSend(welcome);
-
-		std::cout << GREEN << "[SERVER] ✓ New client from " << client_ip 
-				  << " (fd=" << client_fd << ", total=" << clients_.size() << ")" << RESET << std::endl;
+		if (!profile.parse[id].count())
+			continue;
+		std::ostringstream line;
+		line << commandName(static_cast<CommandId>(id)) << " parse: ";
+		profile.parse[id].print(line);
+		if (profile.handler[id].count())
+		{
+			line << " | handler: ";
+			profile.handler[id].print(line);
+			line << " | output: ";
+			profile.output[id].print(line, "B", 1.0);
+		}
+		LOG_INFO(CYAN << "[STATS] " << line.str() << RESET);
 	}
 }
 
-//* ============================================================================
-//* HANDLE CLIENT EVENTS
-//* ============================================================================
+//* Overwrites profile: callers keep one around instead of zeroing a new one
+void Server::collectProfile(CommandProfile& profile) const
+{
+	profile.reset();
+	for (size_t i = 0; i < loops_.size(); ++i)
+		profile.merge(loops_[i]->getProfile());
+}
 
-//* HANDLE CLIENT EVENT
-//* Core event handler that processes all socket activity for connected clients.
-//* Called by main loop when poll() detects activity on a client socket.
-//* Handles three main scenarios:
-//* 1. Socket errors/disconnections (POLLERR, POLLHUP, POLLNVAL)
-//* 2. Incoming data ready to read (POLLIN)
-//* 3. Socket ready for writing (POLLOUT)
-//* Manages the complete client I/O lifecycle: receive -> buffer -> parse -> respond
+void Server::resetProfiles()
+{
+	for (size_t i = 0; i < loops_.size(); ++i)
+		loops_[i]->requestProfileReset();
+}
 
-bool Server::handleClientEvent(size_t poll_index)
+//* Sums every loop's counters. Only relaxed loads: callable from the metrics
+//* thread and from command handlers alike.
+void Server::collectStats(StatsSnapshot& snapshot) const
 {
-    int fd = poll_fds_[poll_index].fd;
-    short revents = poll_fds_[poll_index].revents;
-    ClientConnection* client = findClientByFd(fd);
+	std::memset(&snapshot, 0, sizeof(snapshot));
+	for (size_t i = 0; i < loops_.size(); ++i)
+	{
+		const LoopCounters& counters = loops_[i]->getCounters();
+		snapshot.connections += loops_[i]->getLoad();
+		snapshot.registered += LoopCounters::read(counters.registered);
+		snapshot.sendqBytes += LoopCounters::read(counters.sendqBytes);
+		snapshot.wakeups += LoopCounters::read(counters.wakeups);
+		snapshot.accepted += LoopCounters::read(counters.accepted);
+		snapshot.bytesIn += LoopCounters::read(counters.bytesIn);
+		snapshot.bytesOut += LoopCounters::read(counters.bytesOut);
+		snapshot.writes += LoopCounters::read(counters.writes);
+		for (size_t id = 0; id < CMD_COUNT; ++id)
+		{
+			snapshot.commandsIn[id] += LoopCounters::read(counters.commandsIn[id]);
+			snapshot.linesOut[id] += LoopCounters::read(counters.linesOut[id]);
+		}
+	}
+	snapshot.operators = __atomic_load_n(&stats_.operators, __ATOMIC_RELAXED);
+	snapshot.channels = __atomic_load_n(&stats_.channels, __ATOMIC_RELAXED);
+	snapshot.uptime = static_cast<unsigned long>(std::time(NULL) - started_);
+}
 
-    // Safety check: if client doesn't exist, clean up orphan fd
-    if (!client)
-    {
-        poll_fds_.erase(poll_fds_.begin() + poll_index);
-        close(fd);
-        return false;
-    }
+//* "# HELP" + "# TYPE" header, then the sample lines are the caller's
+static void metricHeader(std::ostringstream& out, const char* name, const char* type, const char* help)
+{
+	out << "# HELP ircserv_" << name << " " << help << "\n"
+		<< "# TYPE ircserv_" << name << " " << type << "\n";
+}
 
-    // 1. ERRORS / DISCONNECTION (POLLERR, POLLHUP, POLLNVAL)
-    if (revents & (POLLERR | POLLHUP | POLLNVAL))
-    {
-        std::cout << YELLOW << "[SERVER] Client fd=" << fd
-                  << " disconnected (poll error)" << RESET << std::endl;
-        processClientCommands(client); // Process remaining commands (optional)
-        disconnectClient(poll_index);
-        return false; // Return false because we deleted the client
-    }
+static void metric(std::ostringstream& out, const char* name, const char* type, const char* help,
+	unsigned long value)
+{
+	metricHeader(out, name, type, help);
+	out << "ircserv_" << name << " " << value << "\n";
+}
 
-    // 2. READ (POLLIN)
-    if (revents & POLLIN)
-    {
-        char buffer[4096];
-        ssize_t bytes = recv(fd, buffer, sizeof(buffer) - 1, 0);
+//* One summary per command, skipping those never run. scale turns the
+//* recorded unit into the metric's (1e9: ns -> seconds).
+static void commandSummary(std::ostringstream& out, const char* name, const char* help,
+	const LatencyHistogram* histograms, double scale)
+{
+	static const double quantiles[] = { 0.5, 0.99, 0.999 };
+	metricHeader(out, name, "summary", help);
+	for (size_t id = 0; id < CMD_COUNT; ++id)
+	{
+		const LatencyHistogram& histogram = histograms[id];
+		if (!histogram.count())
+			continue;
+		const char* command = commandName(static_cast<CommandId>(id));
+		for (size_t i = 0; i < sizeof(quantiles) / sizeof(quantiles[0]); ++i)
+			out << "ircserv_" << name << "{command=\"" << command << "\",quantile=\"" << quantiles[i]
+				<< "\"} " << histogram.percentile(quantiles[i] * 100) / scale << "\n";
+		out << "ircserv_" << name << "_sum{command=\"" << command << "\"} "
+			<< static_cast<double>(histogram.mean()) * histogram.count() / scale << "\n"
+			<< "ircserv_" << name << "_count{command=\"" << command << "\"} " << histogram.count() << "\n";
+	}
+}
 
-        if (bytes > 0)
-        {
-            buffer[bytes] = '\0';
-            client->appendRecvData(std::string(buffer, bytes));
-            client->updateActivity();
-
-            // Process commands (this executes NICK, JOIN, QUIT, etc.)
-            processClientCommands(client);
-
-            // CRITICAL: Check if client requested disconnection (QUIT)
-            if (client->isClosed())
-            {
-                disconnectClient(poll_index);
-                return false; // Client deleted, exit
-            }
-
-            // Try to send immediately to reduce latency
-            if (client->hasPendingSend())
-            {
-                sendPendingData(client);
-            }
-        }
-        else if (bytes == 0) // Connection closed by client (EOF)
-        {
-            std::cout << YELLOW << "[SERVER] Client fd=" << fd
-                      << " closed connection" << RESET << std::endl;
-            processClientCommands(client);
-            disconnectClient(poll_index);
-            return false;
-        }
-        else // Error in recv
-        {
-            if (errno != EAGAIN && errno != EWOULDBLOCK)
-            {
-                std::cerr << BRIGHT_RED << "[SERVER] recv() error on fd=" << fd
-                          << ": " << strerror(errno) << RESET << std::endl;
-                disconnectClient(poll_index);
-                return false;
-            }
-        }
-    }
+static unsigned long atomicRead(const unsigned long& counter)
+{
+	return (__atomic_load_n(&counter, __ATOMIC_RELAXED));
+}
 
-    // 3. WRITE (POLLOUT)
-    // If socket is ready to receive data and we have something to send
-    if (revents & POLLOUT)
-    {
-        if (client->hasPendingSend())
-        {
-            sendPendingData(client);
-        }
-    }
+void Server::renderMetrics(std::string& page)
+{
+	StatsSnapshot snapshot;
+	collectStats(snapshot);
+	std::ostringstream out;
+
+	metric(out, "uptime_seconds", "gauge", "Seconds since the server started.", snapshot.uptime);
+	metric(out, "connections", "gauge", "Open client connections.", snapshot.connections);
+	metric(out, "registered_users", "gauge", "Connections that completed PASS/NICK/USER.", snapshot.registered);
+	metric(out, "operators", "gauge", "Users that passed OPER.", snapshot.operators);
+	metric(out, "channels", "gauge", "Channels with at least one member.", snapshot.channels);
+	metric(out, "sendq_bytes", "gauge", "Memory held by client send queues (output not written yet).", snapshot.sendqBytes);
+
+	metricHeader(out, "loop_connections", "gauge", "Open client connections per event loop.");
+	for (size_t i = 0; i < loops_.size(); ++i)
+		out << "ircserv_loop_connections{loop=\"" << i << "\"} " << loops_[i]->getLoad() << "\n";
+
+	metric(out, "accepted_total", "counter", "Connections accepted.", snapshot.accepted);
+	metric(out, "wakeups_total", "counter", "Event loop wakeups (poll/epoll_wait returns).", snapshot.wakeups);
+	metric(out, "received_bytes_total", "counter", "Bytes read from clients.", snapshot.bytesIn);
+	metric(out, "sent_bytes_total", "counter", "Bytes written to clients.", snapshot.bytesOut);
+	metric(out, "writev_total", "counter", "writev() calls.", snapshot.writes);
+
+	metricHeader(out, "commands_received_total", "counter", "Lines executed, by command.");
+	for (size_t id = 0; id < CMD_COUNT; ++id)
+		out << "ircserv_commands_received_total{command=\"" << commandName(static_cast<CommandId>(id))
+			<< "\"} " << snapshot.commandsIn[id] << "\n";
+	metricHeader(out, "messages_sent_total", "counter",
+		"Lines queued to clients, by the command that caused them (UNKNOWN: none).");
+	for (size_t id = 0; id < CMD_COUNT; ++id)
+		out << "ircserv_messages_sent_total{command=\"" << commandName(static_cast<CommandId>(id))
+			<< "\"} " << snapshot.linesOut[id] << "\n";
+
+	metric(out, "sendq_evictions_total", "counter", "Clients disconnected with SendQ exceeded.",
+		atomicRead(stats_.sendqEvictions));
+	metric(out, "sendq_dropped_total", "counter", "Low-priority lines dropped for slow readers.",
+		atomicRead(stats_.sendqDropped));
+	metric(out, "flood_deferrals_total", "counter", "Times a client ran out of flood-control tokens.",
+		atomicRead(stats_.floodDeferrals));
+	metric(out, "excess_flood_total", "counter", "Clients disconnected with Excess Flood.",
+		atomicRead(stats_.excessFlood));
+	metric(out, "ping_timeouts_total", "counter", "Clients disconnected with Ping timeout.",
+		atomicRead(stats_.pingTimeouts));
+	metric(out, "registration_timeouts_total", "counter", "Connections reaped before registering.",
+		atomicRead(stats_.registrationTimeouts));
+	metric(out, "unregistered_rejected_total", "counter", "Connections refused by --max-unregistered-per-ip.",
+		atomicRead(stats_.unregisteredRejected));
+
+	//* Quantiles come from the histogram buckets (upper bound), in seconds
+	const LatencyHistogram& latency = stats_.acceptLatency;
+	metricHeader(out, "accept_latency_seconds", "summary", "accept() to registered in an event loop.");
+	static const double quantiles[] = { 0.5, 0.99, 0.999 };
+	for (size_t i = 0; i < sizeof(quantiles) / sizeof(quantiles[0]); ++i)
+		out << "ircserv_accept_latency_seconds{quantile=\"" << quantiles[i] << "\"} "
+			<< latency.percentile(quantiles[i] * 100) / 1e9 << "\n";
+	out << "ircserv_accept_latency_seconds_sum " << latency.mean() * latency.count() / 1e9 << "\n"
+		<< "ircserv_accept_latency_seconds_count " << latency.count() << "\n";
+
+	CommandProfile& profile = metrics_profile_;
+	collectProfile(profile);
+	commandSummary(out, "command_handler_seconds", "Command handler run time.", profile.handler, 1e9);
+	commandSummary(out, "command_parse_seconds", "Parse and lookup time per line.", profile.parse, 1e9);
+	commandSummary(out, "command_output_bytes", "Bytes queued by a command, all recipients.", profile.output, 1.0);
+
+	page = out.str();
+}
 
-    // FINAL FIX: Update events for next poll() call
-    // If there's still something to send, request POLLOUT. If not, just listen (POLLIN).
-    if (client->hasPendingSend())
-    {
-        poll_fds_[poll_index].events = POLLIN | POLLOUT;
-    }
-    else
-    {
-        poll_fds_[poll_index].events = POLLIN;
-    }
-    
-    // Clearing revents is good practice, although poll() overwrites it
-    poll_fds_[poll_index].revents = 0;
+//* ============================================================================
+//* UNREGISTERED CONNECTIONS - per-address cap
+//* ============================================================================
 
-    return true; // Client still alive
+//* Connections that haven't finished PASS/NICK/USER, counted per address
+//* from accept until they register or go away. Own small lock: the accept
+//* path never waits behind command execution.
+bool Server::admitUnregistered(const std::string& ip)
+{
+	if (config_.maxUnregisteredPerIp == 0)
+		return (true);
+	if (threaded_)
+		pthread_mutex_lock(&unregistered_lock_);
+	size_t* count = unregistered_.find(ip);
+	bool admitted = !count || *count < config_.maxUnregisteredPerIp;
+	if (admitted && count)
+		(*count)++;
+	else if (admitted)
+		unregistered_.set(ip, 1);
+	if (threaded_)
+		pthread_mutex_unlock(&unregistered_lock_);
+	return (admitted);
+}
+
+void Server::releaseUnregistered(const std::string& ip)
+{
+	if (config_.maxUnregisteredPerIp == 0)
+		return;
+	if (threaded_)
+		pthread_mutex_lock(&unregistered_lock_);
+	size_t* count = unregistered_.find(ip);
+	if (count && --(*count) == 0)
+		unregistered_.erase(ip);
+	if (threaded_)
+		pthread_mutex_unlock(&unregistered_lock_);
 }
 
 //* ============================================================================
-//* DISCONNECT CLIENT
+//* STATE LOCK
 //* ============================================================================
 
+void Server::lockState()
+{
+	if (threaded_)
+		pthread_mutex_lock(&state_lock_);
+}
 
-void Server::disconnectClient(size_t poll_index)
+void Server::unlockState()
 {
-    // 1. Get basic information before deleting anything
-    int fd = poll_fds_[poll_index].fd;
-    ClientConnection* client = findClientByFd(fd);
+	if (threaded_)
+		pthread_mutex_unlock(&state_lock_);
+}
 
-    std::cout << YELLOW << "[SERVER] Disconnecting client fd=" << fd << RESET << std::endl;
+//* ============================================================================
+//* RELEASE CLIENT - IRC side of a disconnect
+//* ============================================================================
 
-    // 2. If client exists, clean up IRC logic and objects
-    if (client)
+//* The owning loop removes the socket; this drops the User from every
+//* channel (QUIT to the others), frees its nick and deletes it.
+void Server::releaseClient(ClientConnection* client)
+{
+    lockState();
+
+    // Clean up IRC logic and objects
+    User* user = client->getUser();
+    if (user)
     {
-        User* user = client->getUser();
-        if (user)
-        {
-            // A. CHANNEL CLEANUP
-            // Make a COPY of the channels vector because we're going to modify it
-            std::vector<Channel*> userChannels = user->getChannels();
-
-            for (std::vector<Channel*>::iterator it = userChannels.begin(); it != userChannels.end(); ++it)
-            {
-                Channel* channel = *it;
-
-                // 1. Notify others (QUIT message)
-                std::string timestamp = getCurrentTimestamp();
-                std::string quitMsg = std::string(BRIGHT_MAGENTA) + "@time=" + timestamp + RESET + " " +
-                                        BRIGHT_CYAN + ":" + user->getPrefix() + RESET +
-                                        " " + RED + "QUIT" + RESET + " :Connection closed\r\n";
-                channel->broadcast(quitMsg, user);
-
-                // 2. Remove user from channel
-                channel->removeMember(user);
-
-                // 3. Manage empty channels (Avoid memory leaks in channels)
-                if (channel->getUserCount() == 0)
-                {
-                    // Find and delete the channel from the server's global list
-                    for (std::vector<Channel*>::iterator chanIt = channels_.begin(); chanIt != channels_.end(); ++chanIt)
-                    {
-                        if (*chanIt == channel)
-                        {
-                            delete *chanIt;
-                            channels_.erase(chanIt);
-                            break; 
-                        }
-                    }
-                }
-            }
-        }
+        // A. CHANNEL CLEANUP
+        // Make a COPY of the channels vector because we're going to modify it
+        std::vector<Channel*> userChannels = user->getChannels();
 
-        // B. REMOVE FROM SERVER'S CLIENT LIST
-        // (Use manual loop to find and delete the pointer in the vector)
-        for (std::vector<ClientConnection*>::iterator it = clients_.begin(); it != clients_.end(); ++it)
+        // Same QUIT line for every channel the user leaves
+        IrcLine quitMsg;
+        quitMsg.source(user->getPrefix()).add(' ').paint(RED, "QUIT")
+            .add(" :").add(client->getQuitReason()).end();
+        TimedLine quitLine(quitMsg);
+
+        for (std::vector<Channel*>::iterator it = userChannels.begin(); it != userChannels.end(); ++it)
         {
-            if (*it == client)
-            {
-                clients_.erase(it);
-                break;
-            }
-        }
+            Channel* channel = *it;
+
+            // 1. Notify others (QUIT message)
+            channel->broadcast(quitLine, user);
+
+            // 2. Remove user from channel
+            channel->removeMember(user);
 
-        // C. CLOSE SOCKET AND FREE MEMORY
-        close(fd);
-        if (user)
-            delete user; // User must be manually deleted
-        delete client;   // Delete the connection
+            // 3. Manage empty channels (Avoid memory leaks in channels)
+            if (channel->getUserCount() == 0)
+                destroyChannel(channel);
+        }
     }
-    else
+
+    // B. FREE THE USER
+    if (user)
     {
-        // If we don't find the client object, close the fd for safety
-        close(fd);
+        if (user->isOperator())
+            __sync_fetch_and_sub(&stats_.operators, 1UL);
+        unindexUserNick(user); // Nick becomes available again
+        delete user; // User must be manually deleted
     }
+    client->setUser(NULL);
 
-    // 3. UPDATE POLL_FDS
-    // Remove the fd from the monitoring vector.
-    if (poll_index < poll_fds_.size())
-        poll_fds_.erase(poll_fds_.begin() + poll_index);
+    unlockState();
 }
 
 //* ============================================================================
 //* COMMAND PROCESSING
 //* ============================================================================
 
-void Server::processClientCommands(ClientConnection* client)
+//* Runs up to `budget` lines, and only while the client's token bucket
+//* allows it (flood control); the rest stay in its receive buffer for the
+//* loop's run queue. RUN_IDLE once no complete line is left.
+Server::RunResult Server::processClientCommands(ClientConnection* client, size_t budget)
 {
-    client->updateActivity();
+    TokenBucket& bucket = client->getFloodBucket();
+    unsigned long now = client->getLoop()->now();
+    LoopCounters& counters = client->getLoop()->getCounters();
+    CommandProfile& profile = client->getLoop()->getProfile();
+    RunResult result = RUN_IDLE;
+
+    // One state-lock hold for the whole batch of lines just read
+    lockState();
     
     // Process ALL complete lines in the buffer
     // (Important in case several commands arrived together)
-    while (client->hasCompleteLine())
+    const char* line;
+    size_t length;
+    while (true)
     {
-        std::string rawLine = client->popLine();
-        
-        // Optional debug
-        // std::cout << "[DEBUG] < " << rawLine << std::endl;
+        if (budget == 0 || !bucket.ready(now))
+        {
+            if (client->getRecvQueueSize() > 0)
+                result = budget == 0 ? RUN_BUDGET : RUN_THROTTLED;
+            break;
+        }
+        if (!client->nextLine(line, length))
+            break;
+        budget--;
+
+        // Raw input, only formatted with --log-level=debug
+        LOG_DEBUG("[RECV] fd=" << client->getFd() << " < " << std::string(line, length));
 
-        // 1. Parse the line
-        Message msg = Parser::parse(rawLine);
+        // 1. Parse the line (spans into the receive buffer, no copies)
+        unsigned long started = Clock::cycles();
+        MessageView msg;
 
         // 2. If command is empty (blank line or only spaces), ignore
-        if (msg.command.empty())
+        if (!Parser::parse(line, length, msg))
             continue;
 
-        // 3. Search for command in the map
-        std::map<std::string, CommandHandler>::iterator it = _commandMap.find(msg.command);
+        // 3. Resolve the command through the perfect hash table
+        CommandId id = lookupCommand(msg.command.data(), msg.command.size());
+        CommandHandler handler = _commandTable[id];
+        bucket.charge(_commandCost[id]);
+        LoopCounters::add(counters.commandsIn[id]);
+        unsigned long parsed = Clock::cycles();
+        profile.parse[id].recordOwned(Clock::cyclesToNanos(parsed - started));
 
-        if (it != _commandMap.end())
+        if (handler)
         {
             // Found = Execute the associated function
-            (this->*(it->second))(client, msg);
+            // Lines it queues are counted against it (STATS m, metrics),
+            // its run time and output size go to its histograms (STATS p)
+            unsigned long queued = counters.bytesQueued;
+            counters.running = id;
+            (this->*handler)(client, msg);
+            counters.running = CMD_UNKNOWN;
+            profile.handler[id].recordOwned(Clock::cyclesToNanos(Clock::cycles() - parsed));
+            profile.output[id].recordOwned(counters.bytesQueued - queued);
         }
         else
         {
             // COMMAND NOT FOUND
             // Should send ERR_UNKNOWNCOMMAND (421)
             // For now, a simple log:
-            std::cerr << "[SERVER] Unknown command: " << msg.command << std::endl;
+            LOG_DEBUG("[SERVER] Unknown command: " << msg.command.str());
         }
-    }
-}
-
-void Server::sendPendingData(ClientConnection* client)
-{
-    if (!client->hasPendingSend())
-        return;
 
-    const std::string& data = client->getSendBuffer();
-    
-    // Non-blocking send with MSG_DONTWAIT
-    ssize_t bytesSent = send(client->getFd(), data.c_str(), data.length(), MSG_DONTWAIT);
-
-    if (bytesSent > 0)
-    {
-        // Only clear the bytes that were sent
-        client->clearSentData(bytesSent);
-        
-        std::cout << "[DEBUG] Sent " << bytesSent << "/" << data.length() 
-                  << " bytes to fd=" << client->getFd() << std::endl;
-    }
-    else if (bytesSent < 0)
-    {
-        // Normal errors in non-blocking
-        if (errno == EAGAIN || errno == EWOULDBLOCK)
-        {
-            // Socket full, we'll try again on next POLLOUT
-            return;
-        }
-        
-        // Fatal error
-        std::cerr << "[ERROR] send() failed: " << strerror(errno) << std::endl;
-        client->closeConnection();
+        // QUIT, or evicted by its own replies: the rest is never executed
+        if (client->isClosed())
+            break;
     }
+    unlockState();
+    return (result);
 }
+
 //* ============================================================================
-//* UTILITIES
+//* NICKNAME INDEX
 //* ============================================================================
 
-void Server::addClientToPoll(ClientConnection* client)
+//* Any user holding the nick, registered or not (for collision checks)
+User* Server::findUserByNick(const std::string& nick) const
 {
-	struct pollfd pfd;
-	pfd.fd = client->getFd();       //* File descriptor of the client socket to monitor
-	pfd.events = POLLIN;            //* Register interest in read events (incoming data)
-	pfd.revents = 0;                //* Clear returned events field (will be filled by poll())
-	poll_fds_.push_back(pfd);       //* Add to poll array for monitoring
+	User* const* user = nicks_.find(ircCaseFold(nick));
+	return (user ? *user : NULL);
 }
 
-void Server::updatePollEvents(int fd, short events)
+//* Target lookup for messages and queries: only fully registered users
+User* Server::findRegisteredUser(const std::string& nick) const
 {
-	for (size_t i = 0; i < poll_fds_.size(); ++i)
-	{
-		if (poll_fds_[i].fd == fd)
-		{
-			poll_fds_[i].events = events; // Found and updated
-			break;
-		}
-	}
+	User* user = findUserByNick(nick);
+	if (!user || !user->getConnection() || !user->getConnection()->isRegistered())
+		return (NULL);
+	return (user);
 }
 
-ClientConnection* Server::findClientByFd(int fd)
+//* KICK, INVITE, MODE +o/-o target: nick index, then the membership index,
+//* so the channel's size doesn't matter
+User* Server::findChannelMember(Channel* channel, const std::string& nick) const
 {
-	for (size_t i = 0; i < clients_.size(); ++i) //* Just looking in the vector<ClientConnection*> if there is that client.
-	{
-		if (clients_[i] && clients_[i]->getFd() == fd) 
-			return (clients_[i]);
-	}
-	return (NULL);
+	User* user = findUserByNick(nick);
+	if (!user || !channel->isMember(user))
+		return (NULL);
+	return (user);
 }
 
-void Server::initCommands()
+//* Rename a user and move its index entry in one step
+void Server::setUserNick(User* user, const std::string& nick)
 {
-    // Map the command string to the corresponding member function
-    _commandMap["PASS"] = &Server::cmdPass;
-    _commandMap["NICK"] = &Server::cmdNick;
-    _commandMap["USER"] = &Server::cmdUser;
-    _commandMap["PING"] = &Server::cmdPing;
-    _commandMap["PONG"] = &Server::cmdPong;
-    _commandMap["QUIT"] = &Server::cmdQuit;
-    _commandMap["JOIN"] = &Server::cmdJoin;
-    _commandMap["PART"] = &Server::cmdPart;
-    _commandMap["PRIVMSG"] = &Server::cmdPrivMsg;
-    _commandMap["NOTICE"] = &Server::cmdNotice;
-    _commandMap["NAMES"] = &Server::cmdNames;
-    _commandMap["WHO"] = &Server::cmdWho;
-    _commandMap["WHOIS"] = &Server::cmdWhois;
-    _commandMap["KICK"] = &Server::cmdKick;
-    _commandMap["INVITE"] = &Server::cmdInvite;
-    _commandMap["TOPIC"] = &Server::cmdTopic;
-    _commandMap["MODE"] = &Server::cmdMode;
-    
-    // Parser already handles converting command to uppercase
+	unindexUserNick(user);
+	user->setNickname(nick);
+	if (!nick.empty())
+		nicks_.set(ircCaseFold(nick), user);
 }
 
-//* ============================================================================
-//* HELPERS - TIMESTAMP
-//* ============================================================================
+void Server::unindexUserNick(User* user)
+{
+	if (user->getNickname().empty())
+		return;
+	std::string key = ircCaseFold(user->getNickname());
+	User** holder = nicks_.find(key);
+	if (holder && *holder == user)
+		nicks_.erase(key);
+}
 
-std::string Server::getCurrentTimestamp() const
+void Server::initCommands()
 {
-    time_t now = std::time(NULL);
-    struct tm* timeinfo = std::localtime(&now);
-    
-    char buffer[9]; // HH:MM:SS\0
-    std::strftime(buffer, sizeof(buffer), "%H:%M:%S", timeinfo);
-    
-    return std::string(buffer);
-}
\ No newline at end of file
+    for (size_t i = 0; i < CMD_COUNT; ++i)
+        _commandTable[i] = NULL;
+
+    // Map the command id to the corresponding member function
+    _commandTable[CMD_PASS] = &Server::cmdPass;
+    _commandTable[CMD_NICK] = &Server::cmdNick;
+    _commandTable[CMD_USER] = &Server::cmdUser;
+    _commandTable[CMD_PING] = &Server::cmdPing;
+    _commandTable[CMD_PONG] = &Server::cmdPong;
+    _commandTable[CMD_QUIT] = &Server::cmdQuit;
+    _commandTable[CMD_CAP] = &Server::cmdCap;
+    _commandTable[CMD_OPER] = &Server::cmdOper;
+    _commandTable[CMD_STATS] = &Server::cmdStats;
+    _commandTable[CMD_LUSERS] = &Server::cmdLusers;
+    _commandTable[CMD_JOIN] = &Server::cmdJoin;
+    _commandTable[CMD_PART] = &Server::cmdPart;
+    _commandTable[CMD_PRIVMSG] = &Server::cmdPrivMsg;
+    _commandTable[CMD_NOTICE] = &Server::cmdNotice;
+    _commandTable[CMD_NAMES] = &Server::cmdNames;
+    _commandTable[CMD_WHO] = &Server::cmdWho;
+    _commandTable[CMD_WHOIS] = &Server::cmdWhois;
+    _commandTable[CMD_KICK] = &Server::cmdKick;
+    _commandTable[CMD_INVITE] = &Server::cmdInvite;
+    _commandTable[CMD_TOPIC] = &Server::cmdTopic;
+    _commandTable[CMD_MODE] = &Server::cmdMode;
+
+    // lookupCommand() is case-insensitive, no upper-casing needed
+
+    // Flood control costs: one token per line by default, more for commands
+    // that walk a channel or the user table, none for keepalives and QUIT
+    for (size_t i = 0; i < CMD_COUNT; ++i)
+        _commandCost[i] = 1;
+    _commandCost[CMD_PONG] = 0;
+    _commandCost[CMD_QUIT] = 0;
+    _commandCost[CMD_JOIN] = 2;
+    _commandCost[CMD_NAMES] = 3;
+    _commandCost[CMD_WHO] = 3;
+    _commandCost[CMD_WHOIS] = 2;
+    _commandCost[CMD_STATS] = 2;
+}
@@ -17,74 +17,125 @@
 #include <vector>
 #include <poll.h>
 #include <map>
+#include <pthread.h>
+#include <ctime>
 #include "../irc/Message.hpp"
+#include "../irc/CommandTable.hpp"
+#include "../utils/HashMap.hpp"
+#include "ServerConfig.hpp"
+#include "ServerStats.hpp"
 
 class ClientConnection;
 class Channel;
 class User;
+class EventLoop;
+class Acceptor;
+class MetricsListener;
+class SharedBuffer;
 
 /**
  * Server: IRC Server main coordinator
  * * Responsibilities:
- * - Main poll() loop (SINGLE poll as required by 42)
- * - ClientConnection lifecycle management
- * - Event routing to appropriate handlers
+ * - Start one EventLoop per --threads (the first runs on the main thread)
+ * - Shared IRC state: nicknames, channels, users
  * - Channel management
  * - Command execution coordination
  * * Uses:
- * - SocketUtils for low-level socket operations
+ * - EventLoop for sockets, buffers and readiness (one reactor per thread)
  * - ClientConnection for connection + User state
+ * * Threading:
+ * - All IRC state is guarded by one state lock ("big lock"), taken once
+ *   per batch of lines and on disconnect. Socket I/O, framing and parsing
+ *   run outside it, in parallel on every loop. With a single loop the lock
+ *   is skipped entirely.
+ * - Limit: command handlers (and the fan-out they queue) run one at a
+ *   time across all loops, so extra threads scale the socket work, not
+ *   command execution. Per-channel or per-loop ownership of the IRC state
+ *   would be needed to go further.
  */
 
 class Server {
 	public:
-		Server(int port, const std::string& password);
+		Server(const ServerConfig& config);
 		~Server();
 
 		//* MAIN CONTROLLERS
 		bool start(); 								//* Create Socket, bind, listen
-		void run(); 								//* Loop poll()/select()
+		void run(); 								//* Loop poll()/epoll_wait()
 		void stop();
 	
 		//* GETTERS
 		const std::string& getPassword() const;
 		int getClientCount() const;
+
+		//* CALLED BY EVENT LOOPS (owner thread of the connection)
+		enum RunResult
+		{
+			RUN_IDLE,									//* No complete line left
+			RUN_BUDGET,									//* Stopped at the line budget
+			RUN_THROTTLED								//* Stopped by flood control
+		};
+		RunResult processClientCommands(ClientConnection* client,
+			size_t budget = static_cast<size_t>(-1));	//* Lines to run at most
+		void releaseClient(ClientConnection* client);	//* IRC-side teardown on disconnect
+		SharedBuffer* getWelcome() const;				//* Prebuilt banner for new clients
+		ServerStats& getStats();
+
+		//* UNREGISTERED CONNECTIONS (--max-unregistered-per-ip)
+		bool admitUnregistered(const std::string& ip);	//* false = address over the cap
+		void releaseUnregistered(const std::string& ip);	//* Registered or disconnected
+
+		//* STATISTICS (SIGUSR1)
+		void requestStatsDump();						//* Async-signal-safe
+		void dumpStats();								//* Server-wide part, printed by loop 0
+		void collectStats(StatsSnapshot& snapshot) const;	//* Any thread, no state lock
+		void renderMetrics(std::string& out);			//* Prometheus text format, metrics thread
+		void collectProfile(CommandProfile& profile) const;	//* Every loop merged, any thread
+		void resetProfiles();							//* Each loop clears its own next iteration
 		
 	private:
 		//* CONFIGURATION
+		ServerConfig config_;
 		int port_;
 		std::string password_;
-		int server_fd_; 							//* FD OF THE SERVER'S SOCKET
-		bool running_;
+
+		//* EVENT LOOPS
+		std::vector<EventLoop*> loops_;				//* One reactor per thread, loops_[0] on main
+		pthread_mutex_t state_lock_;				//* Guards everything below (big lock)
+		bool threaded_;								//* More than one loop: take state_lock_
+		Acceptor* acceptor_;						//* --acceptor-thread, NULL otherwise
+		MetricsListener* metrics_;					//* --metrics-port/--metrics-socket, NULL otherwise
+		time_t started_;							//* Uptime for STATS u and the metrics
+		SharedBuffer* welcome_;						//* Welcome banner, serialized once
+		ServerStats stats_;
+		pthread_mutex_t unregistered_lock_;			//* Guards unregistered_ (not the state lock)
+		HashMap<std::string, size_t, StringHash> unregistered_;	//* IP -> connections not registered yet
+
+		//* PROFILE SCRATCH (collectProfile() targets, too big for a stack frame)
+		CommandProfile report_profile_;				//* SIGUSR1 report, loop 0 only
+		CommandProfile stats_profile_;				//* STATS p, under the state lock
+		CommandProfile metrics_profile_;			//* Metrics thread only
 
 		//* COLLECTIONS
-		std::vector<ClientConnection*> clients_; 	//* STORAGE THE LIST OF CLIENTS
 		std::vector<Channel*> channels_; 			//* STORAGE THE LIST OF CHANNELS
-		std::vector<struct pollfd> poll_fds_; 		//* POOLS FUCTION
-
-		//* INITIALIZATION
-		bool setupServerSocket();
+		HashMap<std::string, size_t, StringHash> channel_index_;	//* Casefolded name -> slot in channels_
+		HashMap<std::string, User*, StringHash> nicks_;	//* Casefolded nick -> User (RFC 1459)
 
-		//* CONECTION MANAGEMENT
-		void acceptNewConnections();
-    	bool handleClientEvent(size_t poll_index);
-   		void disconnectClient(size_t poll_index);
+		//* STATE LOCK
+		void lockState();
+		void unlockState();
 
-		//* COMMAND PROCESSING (for later)
-		void processClientCommands(ClientConnection* client);
-		void sendPendingData(ClientConnection* client);
-		
-		//* UTILITIES
-		void addClientToPoll(ClientConnection* client);
-		void updatePollEvents(int fd, short events);
-		ClientConnection* findClientByFd(int fd);
-
-		//* TIMESTAMP HELPER
-		std::string getCurrentTimestamp() const;
+        //* NICKNAME INDEX (RFC 1459 casemapping)
+        User* findUserByNick(const std::string& nick) const;
+        User* findRegisteredUser(const std::string& nick) const;
+        User* findChannelMember(Channel* channel, const std::string& nick) const;
+        void setUserNick(User* user, const std::string& nick);
+        void unindexUserNick(User* user);
 
         //* CHANNEL MANAGEMENT HELPER FUNCTIONS (CRÍTICO: FALTABAN ESTOS)
         Channel* getChannel(const std::string& name);
         Channel* createChannel(const std::string& name);
+        void destroyChannel(Channel* channel);
 
 		/*--------------------------------------------------------------------*/
         /* NEW: COMMAND SYSTEM                                                */
@@ -92,12 +143,16 @@ class Server {
         
         // 1. Function type definition for commands
         //    (Receives the client who sent the message and the parsed message)
-        typedef void (Server::*CommandHandler)(ClientConnection*, const Message&);
+        typedef void (Server::*CommandHandler)(ClientConnection*, const MessageView&);
+
+        // 2. Handlers indexed by CommandId ("JOIN" -> CMD_JOIN -> &Server::cmdJoin)
+        //    Names resolve to ids through the perfect hash in CommandTable
+        CommandHandler _commandTable[CMD_COUNT];
 
-        // 2. Map to associate strings ("JOIN") with functions (&Server::cmdJoin)
-        std::map<std::string, CommandHandler> _commandMap;
+        // Flood control: tokens each command takes from the client's bucket
+        unsigned char _commandCost[CMD_COUNT];
 
-        // 3. Function to fill the map at startup
+        // 3. Function to fill the tables at startup
         void initCommands();
 
 		/*--------------------------------------------------------------------*/
@@ -105,29 +160,36 @@ class Server {
         /*--------------------------------------------------------------------*/
         
         // Authentication
-        void cmdPass(ClientConnection* client, const Message& msg);
-        void cmdNick(ClientConnection* client, const Message& msg);
-        void cmdUser(ClientConnection* client, const Message& msg);
-        void cmdPing(ClientConnection* client, const Message& msg);
-        void cmdPong(ClientConnection* client, const Message& msg);
-        void cmdQuit(ClientConnection* client, const Message& msg);
+        void cmdPass(ClientConnection* client, const MessageView& msg);
+        void cmdNick(ClientConnection* client, const MessageView& msg);
+        void cmdUser(ClientConnection* client, const MessageView& msg);
+        void cmdPing(ClientConnection* client, const MessageView& msg);
+        void cmdPong(ClientConnection* client, const MessageView& msg);
+        void cmdQuit(ClientConnection* client, const MessageView& msg);
+        void cmdCap(ClientConnection* client, const MessageView& msg);
+        void cmdOper(ClientConnection* client, const MessageView& msg);
+
+        // Server statistics
+        void cmdStats(ClientConnection* client, const MessageView& msg);
+        void cmdLusers(ClientConnection* client, const MessageView& msg);
+        void sendProfile(ClientConnection* client);
 
         // Channels and Communication
-        void cmdJoin(ClientConnection* client, const Message& msg);
-        void cmdPart(ClientConnection* client, const Message& msg);
-        void cmdPrivMsg(ClientConnection* client, const Message& msg);
-        void cmdNotice(ClientConnection* client, const Message& msg);
-		void cmdNames(ClientConnection* client, const Message& msg);
-		void cmdWho(ClientConnection* client, const Message& msg);
-		void cmdWhois(ClientConnection* client, const Message& msg);
+        void cmdJoin(ClientConnection* client, const MessageView& msg);
+        void cmdPart(ClientConnection* client, const MessageView& msg);
+        void cmdPrivMsg(ClientConnection* client, const MessageView& msg);
+        void cmdNotice(ClientConnection* client, const MessageView& msg);
+		void cmdNames(ClientConnection* client, const MessageView& msg);
+		void cmdWho(ClientConnection* client, const MessageView& msg);
+		void cmdWhois(ClientConnection* client, const MessageView& msg);
 		// Auxiliary function for WHOIS
 		std::string getChannelsForUser(User* user) const;
 
         // Operators
-        void cmdKick(ClientConnection* client, const Message& msg);
-        void cmdInvite(ClientConnection* client, const Message& msg);
-        void cmdTopic(ClientConnection* client, const Message& msg);
-        void cmdMode(ClientConnection* client, const Message& msg);
+        void cmdKick(ClientConnection* client, const MessageView& msg);
+        void cmdInvite(ClientConnection* client, const MessageView& msg);
+        void cmdTopic(ClientConnection* client, const MessageView& msg);
+        void cmdMode(ClientConnection* client, const MessageView& msg);
 	
 		//* NON-COPYABLE
 		Server(const Server&);
@@ -0,0 +1,253 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ServerConfig.cpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 10:12:41 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 10:12:41 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "ServerConfig.hpp"
+#include <cstdlib>
+
+//* ============================================================================
+//* DEFAULTS
+//* ============================================================================
+
+ServerConfig::ServerConfig() : port(0), password(""),
+#ifdef __linux__
+	backend(BACKEND_EPOLL),
+#else
+	backend(BACKEND_POLL),
+#endif
+	edgeTriggered(false), threads(1), acceptorThread(false), format(FORMAT_COLOR),
+	logLevel(Log::LEVEL_INFO),
+	sendqLow(128 * 1024), sendqHigh(512 * 1024), sendqMax(4 * 1024 * 1024),
+	lineBudget(32), floodRate(0), floodBurst(10), recvqMax(8192),
+	pingInterval(120), pingTimeout(60), registrationTimeout(60),
+	maxUnregisteredPerIp(0), operPassword(""), metricsPort(0), metricsSocket("")
+{
+}
+
+//* ============================================================================
+//* OPTION PARSING
+//* ============================================================================
+
+bool ServerConfig::parseOption(const std::string& arg, std::string& error)
+{
+	if (arg.compare(0, 2, "--") != 0)
+	{
+		error = "unexpected argument '" + arg + "'";
+		return (false);
+	}
+
+	size_t eq = arg.find('=');
+	std::string key = arg.substr(2, eq == std::string::npos ? std::string::npos : eq - 2);
+	std::string value = (eq == std::string::npos) ? "" : arg.substr(eq + 1);
+
+	if (key == "backend")
+	{
+		if (value == "poll")
+			backend = BACKEND_POLL;
+		else if (value == "epoll")
+			backend = BACKEND_EPOLL;
+		else
+		{
+			error = "--backend expects 'poll' or 'epoll'";
+			return (false);
+		}
+		return (true);
+	}
+	if (key == "format")
+	{
+		if (value == "color")
+			format = FORMAT_COLOR;
+		else if (value == "rfc")
+			format = FORMAT_RFC;
+		else
+		{
+			error = "--format expects 'color' or 'rfc'";
+			return (false);
+		}
+		return (true);
+	}
+	if (key == "log-level")
+	{
+		if (!Log::parseLevel(value, logLevel))
+		{
+			error = "--log-level expects 'error', 'warn', 'info' or 'debug'";
+			return (false);
+		}
+		return (true);
+	}
+	if (key == "edge-triggered" && eq == std::string::npos)
+	{
+		edgeTriggered = true;
+		return (true);
+	}
+	if (key == "acceptor-thread" && eq == std::string::npos)
+	{
+		acceptorThread = true;
+		return (true);
+	}
+	if (key == "threads")
+	{
+		long n;
+		if (!parseNumber(value, 1, 64, n))
+		{
+			error = "--threads expects a number between 1 and 64";
+			return (false);
+		}
+		threads = static_cast<int>(n);
+		return (true);
+	}
+	if (key == "sendq-low" || key == "sendq-high" || key == "sendq-max")
+	{
+		long n;
+		if (!parseNumber(value, 4096, 1L << 30, n))
+		{
+			error = "--" + key + " expects a byte count between 4096 and 1073741824";
+			return (false);
+		}
+		size_t& field = (key == "sendq-low") ? sendqLow : (key == "sendq-high") ? sendqHigh : sendqMax;
+		field = static_cast<size_t>(n);
+		return (true);
+	}
+	if (key == "line-budget")
+	{
+		long n;
+		if (!parseNumber(value, 1, 100000, n))
+		{
+			error = "--line-budget expects a number of lines between 1 and 100000";
+			return (false);
+		}
+		lineBudget = static_cast<size_t>(n);
+		return (true);
+	}
+	if (key == "flood-rate" || key == "flood-burst")
+	{
+		long n;
+		if (!parseNumber(value, key == "flood-rate" ? 0 : 1, 100000, n))
+		{
+			error = "--" + key + " expects a number of tokens up to 100000";
+			return (false);
+		}
+		(key == "flood-rate" ? floodRate : floodBurst) = static_cast<unsigned long>(n);
+		return (true);
+	}
+	if (key == "recvq-max")
+	{
+		long n;
+		if (!parseNumber(value, 1024, 8192, n))
+		{
+			error = "--recvq-max expects a byte count between 1024 and 8192";
+			return (false);
+		}
+		recvqMax = static_cast<size_t>(n);
+		return (true);
+	}
+	if (key == "ping-interval" || key == "ping-timeout")
+	{
+		long n;
+		if (!parseNumber(value, 1, 86400, n))
+		{
+			error = "--" + key + " expects a number of seconds between 1 and 86400";
+			return (false);
+		}
+		(key == "ping-interval" ? pingInterval : pingTimeout) = static_cast<unsigned long>(n);
+		return (true);
+	}
+	if (key == "registration-timeout")
+	{
+		long n;
+		if (!parseNumber(value, 1, 3600, n))
+		{
+			error = "--registration-timeout expects a number of seconds between 1 and 3600";
+			return (false);
+		}
+		registrationTimeout = static_cast<unsigned long>(n);
+		return (true);
+	}
+	if (key == "max-unregistered-per-ip")
+	{
+		long n;
+		if (!parseNumber(value, 0, 100000, n))
+		{
+			error = "--max-unregistered-per-ip expects a number up to 100000 (0 = no cap)";
+			return (false);
+		}
+		maxUnregisteredPerIp = static_cast<size_t>(n);
+		return (true);
+	}
+	if (key == "oper-password")
+	{
+		if (value.empty() || value.find(' ') != std::string::npos)
+		{
+			error = "--oper-password expects a non-empty password without spaces";
+			return (false);
+		}
+		operPassword = value;
+		return (true);
+	}
+	if (key == "metrics-port")
+	{
+		long n;
+		if (!parseNumber(value, 1, 65535, n))
+		{
+			error = "--metrics-port expects a port between 1 and 65535";
+			return (false);
+		}
+		metricsPort = static_cast<int>(n);
+		return (true);
+	}
+	if (key == "metrics-socket")
+	{
+		if (value.empty() || value.size() >= 108)
+		{
+			error = "--metrics-socket expects a path shorter than 108 characters";
+			return (false);
+		}
+		metricsSocket = value;
+		return (true);
+	}
+	error = "unknown option '" + arg + "'";
+	return (false);
+}
+
+bool ServerConfig::validate(std::string& error) const
+{
+	if (sendqLow > sendqHigh || sendqHigh > sendqMax)
+	{
+		error = "send queue limits must satisfy --sendq-low <= --sendq-high <= --sendq-max";
+		return (false);
+	}
+	if (metricsPort == port)
+	{
+		error = "--metrics-port must differ from the IRC port";
+		return (false);
+	}
+	return (true);
+}
+
+//* Whole string must be a decimal number inside [min, max]
+bool ServerConfig::parseNumber(const std::string& value, long min, long max, long& out)
+{
+	if (value.empty())
+		return (false);
+	char* end = NULL;
+	out = std::strtol(value.c_str(), &end, 10);
+	return (*end == '\0' && out >= min && out <= max);
+}
+
+const char* ServerConfig::backendName(Backend backend)
+{
+	return (backend == BACKEND_EPOLL ? "epoll" : "poll");
+}
+
+const char* ServerConfig::formatName(Format format)
+{
+	return (format == FORMAT_RFC ? "rfc" : "color");
+}
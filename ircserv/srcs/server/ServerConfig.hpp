@@ -0,0 +1,105 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ServerConfig.hpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 10:12:41 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 10:12:41 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef SERVER_CONFIG_HPP
+#define SERVER_CONFIG_HPP
+
+#include <string>
+#include <cstddef>
+#include "../utils/Log.hpp"
+
+/**
+ * ServerConfig: Startup options for the Server
+ *
+ * Filled by main() from the mandatory <port> <password> arguments plus
+ * any optional "--key=value" flags that follow them. Every field has a
+ * sane default so `./ircserv <port> <password>` keeps working as before.
+ */
+
+struct ServerConfig
+{
+	enum Backend
+	{
+		BACKEND_POLL,								//* Portable poll() loop
+		BACKEND_EPOLL								//* Linux epoll(), O(ready) dispatch
+	};
+
+	enum Format
+	{
+		FORMAT_COLOR,								//* ANSI-colored protocol lines
+		FORMAT_RFC									//* Plain RFC 1459/2812 lines
+	};
+
+	int			port;
+	std::string	password;
+
+	//* EVENT LOOP
+	Backend		backend;							//* --backend=poll|epoll
+	bool		edgeTriggered;						//* --edge-triggered (epoll only)
+	int			threads;							//* --threads=N event loops (SO_REUSEPORT)
+	bool		acceptorThread;						//* --acceptor-thread: one accept thread feeds the loops
+
+	//* OUTPUT
+	Format		format;								//* --format=color|rfc
+	Log::Level	logLevel;							//* --log-level=error|warn|info|debug
+
+	//* OUTPUT BACKPRESSURE (bytes queued per connection)
+	size_t		sendqLow;							//* --sendq-low: resume reading below this
+	size_t		sendqHigh;							//* --sendq-high: stop reading, drop low-priority output
+	size_t		sendqMax;							//* --sendq-max: disconnect with "SendQ exceeded"
+
+	//* SCHEDULING
+	size_t		lineBudget;							//* --line-budget: lines per client per loop turn
+
+	//* FLOOD CONTROL (per connection)
+	unsigned long	floodRate;						//* --flood-rate: tokens per second, 0 = off
+	unsigned long	floodBurst;						//* --flood-burst: bucket size in tokens
+	size_t		recvqMax;							//* --recvq-max: unexecuted bytes before "Excess Flood"
+
+	//* KEEPALIVE (seconds)
+	unsigned long	pingInterval;					//* --ping-interval: silence before we send PING
+	unsigned long	pingTimeout;					//* --ping-timeout: wait for any reply to it
+	unsigned long	registrationTimeout;			//* --registration-timeout: time to finish PASS/NICK/USER
+	size_t		maxUnregisteredPerIp;				//* --max-unregistered-per-ip: 0 = no cap
+
+	//* OPERATORS AND STATISTICS
+	std::string	operPassword;						//* --oper-password: OPER disabled when empty
+	int			metricsPort;						//* --metrics-port: 127.0.0.1 only, 0 = off
+	std::string	metricsSocket;						//* --metrics-socket: Unix socket path, empty = off
+
+	ServerConfig();
+
+	/**
+	 * Parse one optional "--key=value" argument
+	 *
+	 * @param arg Raw argv entry
+	 * @param error [OUT] Human-readable reason when the option is rejected
+	 * @return true if the option was recognised and valid
+	 */
+	bool parseOption(const std::string& arg, std::string& error);
+
+	/**
+	 * Cross-option checks, once every option has been parsed
+	 *
+	 * @param error [OUT] Human-readable reason when the combination is invalid
+	 * @return true if the configuration is usable
+	 */
+	bool validate(std::string& error) const;
+
+	static const char* backendName(Backend backend);
+	static const char* formatName(Format format);
+
+	private:
+		static bool parseNumber(const std::string& value, long min, long max, long& out);
+};
+
+#endif
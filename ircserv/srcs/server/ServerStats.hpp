@@ -0,0 +1,170 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ServerStats.hpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 19:41:50 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 19:41:50 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef SERVER_STATS_HPP
+#define SERVER_STATS_HPP
+
+#include <cstring>
+#include "../utils/LatencyHistogram.hpp"
+#include "../irc/CommandTable.hpp"
+
+/**
+ * ServerStats: Counters and histograms shared by every event loop
+ *
+ * Written lock-free from any thread (atomic adds), read when dumping
+ * (SIGUSR1). Kept apart from the IRC state so updating it never needs
+ * the state lock.
+ */
+
+struct ServerStats
+{
+	LatencyHistogram	acceptLatency;		//* accept() -> registered in its event loop
+	unsigned long		sendqEvictions;		//* Disconnected with "SendQ exceeded"
+	unsigned long		sendqDropped;		//* Low-priority lines dropped (closed connections)
+	unsigned long		floodDeferrals;		//* Times a client ran out of tokens
+	unsigned long		excessFlood;		//* Disconnected with "Excess Flood"
+	unsigned long		budgetYields;		//* Times a client used up its line budget
+	unsigned long		pingsSent;			//* Keepalive PINGs to idle clients
+	unsigned long		pingTimeouts;		//* Disconnected with "Ping timeout"
+	unsigned long		registrationTimeouts;	//* Reaped before completing registration
+	unsigned long		unregisteredRejected;	//* Refused: address over --max-unregistered-per-ip
+	unsigned long		channels;			//* Gauge, stored under the state lock
+	unsigned long		operators;			//* Gauge: users that passed OPER
+
+	ServerStats() : sendqEvictions(0), sendqDropped(0), floodDeferrals(0), excessFlood(0),
+		budgetYields(0), pingsSent(0), pingTimeouts(0), registrationTimeouts(0),
+		unregisteredRejected(0), channels(0), operators(0) {}
+
+	private:
+		ServerStats(const ServerStats&);
+		ServerStats& operator=(const ServerStats&);
+};
+
+/**
+ * LoopCounters: Traffic counters of one event loop
+ *
+ * Only the loop's own thread writes them, with a relaxed load + store:
+ * no locked instruction and no cache line bouncing between loops on the
+ * hot path. Any thread may read them (STATS, LUSERS, metrics listener).
+ */
+
+struct LoopCounters
+{
+	unsigned long	wakeups;				//* Backend waits that returned
+	unsigned long	accepted;				//* Connections taken over by this loop
+	unsigned long	bytesIn;				//* recv()'d from clients
+	unsigned long	bytesOut;				//* writev()'d to clients
+	unsigned long	writes;					//* writev() calls
+	unsigned long	registered;				//* Gauge: registered connections
+	unsigned long	sendqBytes;				//* Gauge: bytes queued on its connections
+	unsigned long	bytesQueued;			//* Owner thread only: bytes admitted to its send queues
+	unsigned long	commandsIn[CMD_COUNT];	//* Lines executed (CMD_UNKNOWN: unknown command)
+	unsigned long	linesOut[CMD_COUNT];	//* Lines admitted to a send queue, by the command
+											//* that produced them (posts: on arrival)
+											//* (CMD_UNKNOWN: welcome, PING, QUIT on disconnect...)
+	CommandId		running;				//* Command being executed, owner thread only
+
+	LoopCounters() : wakeups(0), accepted(0), bytesIn(0), bytesOut(0), writes(0),
+		registered(0), sendqBytes(0), bytesQueued(0), running(CMD_UNKNOWN)
+	{
+		std::memset(commandsIn, 0, sizeof(commandsIn));
+		std::memset(linesOut, 0, sizeof(linesOut));
+	}
+
+	//* Owner thread only: a plain increment other threads can read untorn
+	static void	add(unsigned long& counter, unsigned long n = 1)
+	{
+		__atomic_store_n(&counter, __atomic_load_n(&counter, __ATOMIC_RELAXED) + n, __ATOMIC_RELAXED);
+	}
+
+	static void	sub(unsigned long& counter, unsigned long n = 1)
+	{
+		__atomic_store_n(&counter, __atomic_load_n(&counter, __ATOMIC_RELAXED) - n, __ATOMIC_RELAXED);
+	}
+
+	static unsigned long	read(const unsigned long& counter)
+	{
+		return (__atomic_load_n(&counter, __ATOMIC_RELAXED));
+	}
+
+	private:
+		LoopCounters(const LoopCounters&);
+		LoopCounters& operator=(const LoopCounters&);
+};
+
+/**
+ * CommandProfile: What each command costs, per event loop
+ *
+ * Recorded around every dispatch in Server::processClientCommands() with
+ * the cycle counter. Single writer (the loop's thread), so recordOwned();
+ * readers merge every loop's profile (Server::collectProfile()). Reset by
+ * the owner only, on request, so a reset never races a record.
+ */
+
+struct CommandProfile
+{
+	LatencyHistogram	parse[CMD_COUNT];		//* Line -> MessageView + command lookup, ns
+	LatencyHistogram	handler[CMD_COUNT];		//* Handler run time (state lock held), ns
+	LatencyHistogram	output[CMD_COUNT];		//* Bytes the handler got admitted to its own loop's queues
+
+	CommandProfile() {}
+
+	void	reset()
+	{
+		for (size_t id = 0; id < CMD_COUNT; ++id)
+		{
+			parse[id].reset();
+			handler[id].reset();
+			output[id].reset();
+		}
+	}
+
+	void	merge(const CommandProfile& other)
+	{
+		for (size_t id = 0; id < CMD_COUNT; ++id)
+		{
+			parse[id].merge(other.parse[id]);
+			handler[id].merge(other.handler[id]);
+			output[id].merge(other.output[id]);
+		}
+	}
+
+	private:
+		CommandProfile(const CommandProfile&);
+		CommandProfile& operator=(const CommandProfile&);
+};
+
+/**
+ * StatsSnapshot: Every loop's counters summed up, plus the server gauges
+ *
+ * Filled by Server::collectStats() from any thread, without the state
+ * lock. Counters read a few events apart may not add up exactly.
+ */
+
+struct StatsSnapshot
+{
+	unsigned long	connections;
+	unsigned long	registered;
+	unsigned long	operators;
+	unsigned long	channels;
+	unsigned long	sendqBytes;
+	unsigned long	uptime;					//* Seconds
+	unsigned long	wakeups;
+	unsigned long	accepted;
+	unsigned long	bytesIn;
+	unsigned long	bytesOut;
+	unsigned long	writes;
+	unsigned long	commandsIn[CMD_COUNT];
+	unsigned long	linesOut[CMD_COUNT];
+};
+
+#endif
@@ -0,0 +1,37 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Clock.cpp                                          :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 04:31:05 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 04:31:05 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "Clock.hpp"
+
+double Clock::_nanosPerCycle = 1.0;
+
+//* Spin ~10 ms and compare both clocks. Good to a fraction of a percent
+//* on CPUs with an invariant counter, which is all the histograms need.
+void Clock::calibrate()
+{
+#if defined(__x86_64__) || defined(__i386__) || defined(__aarch64__)
+	struct timespec start, now;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	unsigned long first = cycles();
+	unsigned long elapsed;
+	do
+	{
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		elapsed = static_cast<unsigned long>(now.tv_sec - start.tv_sec) * 1000000000UL
+			+ now.tv_nsec - start.tv_nsec;
+	}
+	while (elapsed < 10000000UL);
+	unsigned long ticks = cycles() - first;
+	if (ticks)
+		_nanosPerCycle = static_cast<double>(elapsed) / ticks;
+#endif
+}
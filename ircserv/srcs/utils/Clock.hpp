@@ -0,0 +1,73 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Clock.hpp                                          :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 21:12:03 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 21:12:03 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef CLOCK_HPP
+#define CLOCK_HPP
+
+#include <ctime>
+
+/**
+ * Clock: Monotonic time source for timers, rate limits and idle tracking
+ *
+ * CLOCK_MONOTONIC never jumps with the wall clock (NTP, manual changes),
+ * so deadlines computed from it can't all fire at once or never. Event
+ * loops read it once per iteration and pass that value around.
+ *
+ * cycles() is the CPU's own counter (TSC on x86-64, CNTVCT on arm64) for
+ * timing short sections such as one command: a single instruction instead
+ * of a clock_gettime() call. calibrate() measures it against the
+ * monotonic clock once at startup; elsewhere cycles() falls back to
+ * CLOCK_MONOTONIC nanoseconds.
+ */
+
+class Clock
+{
+	public:
+		static unsigned long nowMs()
+		{
+			struct timespec ts;
+			clock_gettime(CLOCK_MONOTONIC, &ts);
+			return (static_cast<unsigned long>(ts.tv_sec) * 1000UL
+				+ static_cast<unsigned long>(ts.tv_nsec) / 1000000UL);
+		}
+
+		static unsigned long cycles()
+		{
+#if defined(__x86_64__) || defined(__i386__)
+			unsigned int low, high;
+			__asm__ __volatile__ ("rdtsc" : "=a" (low), "=d" (high));
+			return ((static_cast<unsigned long>(high) << 32) | low);
+#elif defined(__aarch64__)
+			unsigned long ticks;
+			__asm__ __volatile__ ("mrs %0, cntvct_el0" : "=r" (ticks));
+			return (ticks);
+#else
+			struct timespec ts;
+			clock_gettime(CLOCK_MONOTONIC, &ts);
+			return (static_cast<unsigned long>(ts.tv_sec) * 1000000000UL
+				+ static_cast<unsigned long>(ts.tv_nsec));
+#endif
+		}
+
+		static void calibrate();					//* Once, before any thread starts
+		static unsigned long cyclesToNanos(unsigned long cycles)
+		{
+			return (static_cast<unsigned long>(cycles * _nanosPerCycle));
+		}
+
+	private:
+		static double	_nanosPerCycle;				//* 1.0 until calibrate()
+
+		Clock();
+};
+
+#endif
@@ -0,0 +1,64 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   FdTable.hpp                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 04:05:12 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 04:05:12 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef FD_TABLE_HPP
+#define FD_TABLE_HPP
+
+#include <vector>
+#include <cstddef>
+
+/**
+ * FdTable: Dense file descriptor -> object index
+ *
+ * The kernel always hands out the lowest free descriptor, so a vector
+ * indexed by fd stays dense: its size follows the highest fd ever used,
+ * and find / insert / erase are one index each, whatever the number of
+ * entries. NULL marks a free descriptor.
+ *
+ * erase() only clears the slot while it still holds the given object,
+ * so a stale removal can't unindex a newer owner of a reused fd.
+ */
+
+template <typename T>
+class FdTable
+{
+	public:
+		FdTable() {}
+
+		T*	find(int fd) const
+		{
+			if (fd < 0 || (size_t)fd >= _slots.size())
+				return (NULL);
+			return (_slots[fd]);
+		}
+
+		void	insert(int fd, T* item)
+		{
+			if ((size_t)fd >= _slots.size())
+				_slots.resize(fd + 1, NULL);
+			_slots[fd] = item;
+		}
+
+		void	erase(int fd, const T* item)
+		{
+			if (fd >= 0 && (size_t)fd < _slots.size() && _slots[fd] == item)
+				_slots[fd] = NULL;
+		}
+
+	private:
+		std::vector<T*>	_slots;
+
+		FdTable(const FdTable&);
+		FdTable& operator=(const FdTable&);
+};
+
+#endif
@@ -0,0 +1,180 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   HashMap.hpp                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 12:02:19 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 12:02:19 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef HASH_MAP_HPP
+#define HASH_MAP_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+/**
+ * HashMap: Minimal separate-chaining hash table (C++98 has no unordered_map)
+ *
+ * - Average O(1) find / insert / erase
+ * - Power-of-two bucket count, grows x2 when size exceeds bucket count
+ * - Pointers returned by find() stay valid until that key is erased
+ *   (nodes never move, only bucket heads are rehashed)
+ *
+ * Keys are compared with operator==, hashed with the Hash functor.
+ */
+
+//* FNV-1a, good enough spread for short identifiers (nicks, channels)
+struct StringHash
+{
+	size_t operator()(const std::string& key) const
+	{
+		size_t h = 2166136261u;
+		for (size_t i = 0; i < key.length(); ++i)
+		{
+			h ^= (unsigned char)key[i];
+			h *= 16777619u;
+		}
+		return (h);
+	}
+};
+
+//* Pointers are aligned, drop the low bits and mix the rest
+struct PointerHash
+{
+	size_t operator()(const void* key) const
+	{
+		size_t h = (size_t)key;
+		h ^= h >> 4;
+		h ^= h >> 16;
+		return (h * 2654435761u);
+	}
+};
+
+template <typename K, typename V, typename Hash>
+class HashMap
+{
+	public:
+		HashMap() : buckets_(16, (Node*)NULL), size_(0)
+		{
+		}
+
+		~HashMap()
+		{
+			clear();
+		}
+
+		size_t	size() const { return (size_); }
+		bool	empty() const { return (size_ == 0); }
+
+		V* find(const K& key)
+		{
+			for (Node* n = buckets_[bucketOf(key)]; n; n = n->next)
+			{
+				if (n->key == key)
+					return (&n->value);
+			}
+			return (NULL);
+		}
+
+		const V* find(const K& key) const
+		{
+			return (const_cast<HashMap*>(this)->find(key));
+		}
+
+		//* Insert or overwrite
+		void set(const K& key, const V& value)
+		{
+			V* existing = find(key);
+			if (existing)
+			{
+				*existing = value;
+				return;
+			}
+			if (size_ >= buckets_.size())
+				rehash(buckets_.size() * 2);
+			size_t b = bucketOf(key);
+			buckets_[b] = new Node(key, value, buckets_[b]);
+			size_++;
+		}
+
+		bool erase(const K& key)
+		{
+			Node** link = &buckets_[bucketOf(key)];
+			while (*link)
+			{
+				if ((*link)->key == key)
+				{
+					Node* dead = *link;
+					*link = dead->next;
+					delete dead;
+					size_--;
+					return (true);
+				}
+				link = &(*link)->next;
+			}
+			return (false);
+		}
+
+		void clear()
+		{
+			for (size_t i = 0; i < buckets_.size(); ++i)
+			{
+				Node* n = buckets_[i];
+				while (n)
+				{
+					Node* next = n->next;
+					delete n;
+					n = next;
+				}
+				buckets_[i] = NULL;
+			}
+			size_ = 0;
+		}
+
+	private:
+		struct Node
+		{
+			K		key;
+			V		value;
+			Node*	next;
+
+			Node(const K& k, const V& v, Node* n) : key(k), value(v), next(n) {}
+		};
+
+		std::vector<Node*>	buckets_;
+		size_t				size_;
+		Hash				hash_;
+
+		size_t bucketOf(const K& key) const
+		{
+			return (hash_(key) & (buckets_.size() - 1));
+		}
+
+		void rehash(size_t count)
+		{
+			std::vector<Node*> old(count, (Node*)NULL);
+			old.swap(buckets_);
+			for (size_t i = 0; i < old.size(); ++i)
+			{
+				Node* n = old[i];
+				while (n)
+				{
+					Node* next = n->next;
+					size_t b = bucketOf(n->key);
+					n->next = buckets_[b];
+					buckets_[b] = n;
+					n = next;
+				}
+			}
+		}
+
+		HashMap(const HashMap&);
+		HashMap& operator=(const HashMap&);
+};
+
+#endif
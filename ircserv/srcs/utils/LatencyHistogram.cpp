@@ -0,0 +1,176 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   LatencyHistogram.cpp                               :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 19:20:14 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 19:20:14 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "LatencyHistogram.hpp"
+#include <ctime>
+#include <iomanip>
+
+LatencyHistogram::LatencyHistogram()
+{
+	reset();
+}
+
+// ========================================================================
+// 							   Bucketing
+// ========================================================================
+
+// 0..7 exact, then 4 sub-buckets per power of two: [4,5,6,7] << (msb - 2)
+size_t LatencyHistogram::bucketFor(unsigned long value)
+{
+	if (value < 8)
+		return (value);
+	size_t msb = 0;
+	for (unsigned long v = value; v > 1; v >>= 1)
+		msb++;
+	size_t index = 8 + (msb - 3) * 4 + ((value >> (msb - 2)) & 3);
+	return (index < BUCKETS ? index : BUCKETS - 1);
+}
+
+unsigned long LatencyHistogram::bucketUpper(size_t index)
+{
+	if (index < 8)
+		return (index);
+	size_t msb = 3 + (index - 8) / 4;
+	unsigned long sub = (index - 8) % 4;
+	unsigned long width = 1UL << (msb - 2);
+	return ((4 + sub) * width + width - 1);
+}
+
+// ========================================================================
+// 							   Recording
+// ========================================================================
+
+void LatencyHistogram::record(unsigned long nanos)
+{
+	__sync_fetch_and_add(&_buckets[bucketFor(nanos)], 1UL);
+	__sync_fetch_and_add(&_count, 1UL);
+	__sync_fetch_and_add(&_sum, nanos);
+
+	unsigned long seen = __atomic_load_n(&_max, __ATOMIC_RELAXED);
+	while (nanos > seen && !__sync_bool_compare_and_swap(&_max, seen, nanos))
+		seen = __atomic_load_n(&_max, __ATOMIC_RELAXED);
+}
+
+// No other writer: plain increments, published with relaxed stores so
+// readers on other threads still see whole values
+static inline void bump(unsigned long& counter, unsigned long n)
+{
+	__atomic_store_n(&counter, __atomic_load_n(&counter, __ATOMIC_RELAXED) + n, __ATOMIC_RELAXED);
+}
+
+void LatencyHistogram::recordOwned(unsigned long value)
+{
+	bump(_buckets[bucketFor(value)], 1);
+	bump(_count, 1);
+	bump(_sum, value);
+	if (value > __atomic_load_n(&_max, __ATOMIC_RELAXED))
+		__atomic_store_n(&_max, value, __ATOMIC_RELAXED);
+}
+
+void LatencyHistogram::reset()
+{
+	for (size_t i = 0; i < BUCKETS; ++i)
+		__atomic_store_n(&_buckets[i], 0UL, __ATOMIC_RELAXED);
+	__atomic_store_n(&_count, 0UL, __ATOMIC_RELAXED);
+	__atomic_store_n(&_sum, 0UL, __ATOMIC_RELAXED);
+	__atomic_store_n(&_max, 0UL, __ATOMIC_RELAXED);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other)
+{
+	for (size_t i = 0; i < BUCKETS; ++i)
+		__sync_fetch_and_add(&_buckets[i], __atomic_load_n(&other._buckets[i], __ATOMIC_RELAXED));
+	__sync_fetch_and_add(&_count, other.count());
+	__sync_fetch_and_add(&_sum, __atomic_load_n(&other._sum, __ATOMIC_RELAXED));
+
+	unsigned long top = other.max();
+	unsigned long seen = __atomic_load_n(&_max, __ATOMIC_RELAXED);
+	while (top > seen && !__sync_bool_compare_and_swap(&_max, seen, top))
+		seen = __atomic_load_n(&_max, __ATOMIC_RELAXED);
+}
+
+// ========================================================================
+// 							   Reading
+// ========================================================================
+
+unsigned long LatencyHistogram::count() const
+{
+	return (__atomic_load_n(&_count, __ATOMIC_RELAXED));
+}
+
+unsigned long LatencyHistogram::max() const
+{
+	return (__atomic_load_n(&_max, __ATOMIC_RELAXED));
+}
+
+unsigned long LatencyHistogram::mean() const
+{
+	unsigned long n = count();
+	return (n ? __atomic_load_n(&_sum, __ATOMIC_RELAXED) / n : 0);
+}
+
+unsigned long LatencyHistogram::percentile(double p) const
+{
+	unsigned long total = 0;
+	unsigned long counts[BUCKETS];
+	for (size_t i = 0; i < BUCKETS; ++i)
+	{
+		counts[i] = __atomic_load_n(&_buckets[i], __ATOMIC_RELAXED);
+		total += counts[i];
+	}
+	if (total == 0)
+		return (0);
+
+	unsigned long rank = static_cast<unsigned long>(p / 100.0 * total + 0.5);
+	if (rank == 0)
+		rank = 1;
+	unsigned long seen = 0;
+	for (size_t i = 0; i < BUCKETS; ++i)
+	{
+		seen += counts[i];
+		if (seen >= rank)
+		{
+			unsigned long upper = bucketUpper(i);
+			unsigned long top = max();
+			return (upper < top ? upper : top);
+		}
+	}
+	return (max());
+}
+
+void LatencyHistogram::print(std::ostream& out) const
+{
+	print(out, "us", 1000.0);
+}
+
+void LatencyHistogram::print(std::ostream& out, const char* unit, double scale) const
+{
+	std::ios::fmtflags flags = out.flags();
+	std::streamsize precision = out.precision();
+
+	out << std::fixed << std::setprecision(1)
+		<< "count=" << count()
+		<< " mean=" << mean() / scale << unit
+		<< " p50=" << percentile(50) / scale << unit
+		<< " p99=" << percentile(99) / scale << unit
+		<< " p999=" << percentile(99.9) / scale << unit
+		<< " max=" << max() / scale << unit;
+	out.flags(flags);
+	out.precision(precision);
+}
+
+unsigned long LatencyHistogram::now()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (static_cast<unsigned long>(ts.tv_sec) * 1000000000UL + ts.tv_nsec);
+}
@@ -0,0 +1,73 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   LatencyHistogram.hpp                               :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 19:20:14 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 19:20:14 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef LATENCY_HISTOGRAM_HPP
+#define LATENCY_HISTOGRAM_HPP
+
+#include <cstddef>
+#include <ostream>
+
+/**
+ * LatencyHistogram: Fixed-memory, log-linear histogram of durations (ns)
+ *
+ * HDR-style bucketing: values below 8 get a bucket each, above that every
+ * power of two is split into 4 linear sub-buckets, so any recorded value
+ * is reported within 25% of its true size from 1 ns up to days, in 192
+ * counters. record() is a handful of integer ops plus atomic adds, so any
+ * event loop thread can call it on the hot path without a lock.
+ *
+ * recordOwned() is the same without locked instructions, for histograms
+ * only one thread ever writes (per event loop). Values need not be
+ * durations: print() takes the unit (bytes per command, for instance).
+ *
+ * Percentiles are read from the counters (upper bound of the bucket).
+ * Readers see a snapshot that may be a few samples behind the writers.
+ */
+
+class LatencyHistogram
+{
+	public:
+		static const size_t BUCKETS = 192;
+
+		LatencyHistogram();
+
+		void			record(unsigned long nanos);
+		void			recordOwned(unsigned long value);	//* Single writer thread only
+		void			reset();
+		void			merge(const LatencyHistogram& other);	//* Add other's samples (reader side)
+
+		unsigned long	count() const;
+		unsigned long	max() const;
+		unsigned long	mean() const;
+		unsigned long	percentile(double p) const;	//* p in [0, 100]
+
+		//* "count=.. p50=.. p99=.. p999=.. max=.." in microseconds
+		void			print(std::ostream& out) const;
+		//* Same, values divided by scale and suffixed with unit
+		void			print(std::ostream& out, const char* unit, double scale) const;
+
+		static unsigned long	now();				//* CLOCK_MONOTONIC in ns
+
+	private:
+		unsigned long	_buckets[BUCKETS];
+		unsigned long	_count;
+		unsigned long	_sum;
+		unsigned long	_max;
+
+		static size_t			bucketFor(unsigned long value);
+		static unsigned long	bucketUpper(size_t index);
+
+		LatencyHistogram(const LatencyHistogram&);
+		LatencyHistogram& operator=(const LatencyHistogram&);
+};
+
+#endif
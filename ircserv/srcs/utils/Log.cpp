@@ -0,0 +1,301 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Log.cpp                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 02:45:12 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 02:45:12 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "Log.hpp"
+
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <csignal>
+
+//* ============================================================================
+//* STATE
+//* ============================================================================
+
+Log::Level		Log::_level = Log::LEVEL_INFO;
+Log::Slot		Log::_ring[Log::RING_SIZE];
+unsigned long	Log::_head = 0;
+unsigned long	Log::_tail = 0;
+unsigned long	Log::_dropped = 0;
+int				Log::_running = 0;
+int				Log::_waiting = 0;
+pthread_t		Log::_thread;
+pthread_mutex_t	Log::_lock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t	Log::_wakeup = PTHREAD_COND_INITIALIZER;
+bool			Log::_plain[3] = { false, !isatty(1), !isatty(2) };
+
+static const size_t	DRAIN_BATCH = 256;		//* Lines gathered per write()
+
+//* Errors and warnings on stderr, the rest on stdout
+static int fdFor(int level)
+{
+	return (level <= Log::LEVEL_WARN ? 2 : 1);
+}
+
+//* ============================================================================
+//* LEVELS
+//* ============================================================================
+
+void Log::setLevel(Level level)
+{
+	_level = level;
+}
+
+bool Log::enabled(Level level)
+{
+	return (level <= _level);
+}
+
+bool Log::parseLevel(const std::string& name, Level& level)
+{
+	if (name == "error")
+		level = LEVEL_ERROR;
+	else if (name == "warn")
+		level = LEVEL_WARN;
+	else if (name == "info")
+		level = LEVEL_INFO;
+	else if (name == "debug")
+		level = LEVEL_DEBUG;
+	else
+		return (false);
+	return (true);
+}
+
+const char* Log::levelName(Level level)
+{
+	static const char* const names[] = { "none", "error", "warn", "info", "debug" };
+	return (names[level]);
+}
+
+//* ============================================================================
+//* WRITER THREAD
+//* ============================================================================
+
+//* The thread blocks every signal: SIGINT/SIGTERM/SIGUSR1 must keep
+//* landing on the main thread, like with the event loop threads.
+bool Log::start()
+{
+	for (size_t i = 0; i < RING_SIZE; ++i)
+		_ring[i].seq = i;
+	_head = 0;
+	_tail = 0;
+
+	sigset_t all, previous;
+	sigfillset(&all);
+	pthread_sigmask(SIG_BLOCK, &all, &previous);
+	__atomic_store_n(&_running, 1, __ATOMIC_RELEASE);
+	int result = pthread_create(&_thread, NULL, &Log::threadMain, NULL);
+	pthread_sigmask(SIG_SETMASK, &previous, NULL);
+	if (result != 0)
+	{
+		__atomic_store_n(&_running, 0, __ATOMIC_RELEASE);
+		return (false);
+	}
+	return (true);
+}
+
+//* Called once the event loops are joined: nothing is logging anymore, so
+//* the last drain sees every line.
+void Log::stop()
+{
+	if (!__atomic_exchange_n(&_running, 0, __ATOMIC_ACQ_REL))
+		return;
+	pthread_mutex_lock(&_lock);
+	pthread_cond_signal(&_wakeup);
+	pthread_mutex_unlock(&_lock);
+	pthread_join(_thread, NULL);
+}
+
+void* Log::threadMain(void* arg)
+{
+	(void)arg;
+	std::string out;
+	std::string err;
+	for (;;)
+	{
+		bool running = __atomic_load_n(&_running, __ATOMIC_ACQUIRE);
+		if (drain(out, err))
+			continue;
+		if (!running)
+			break;
+		waitForLines();
+	}
+	return (NULL);
+}
+
+//* A published line at the tail, or a drop still to be reported
+bool Log::pending()
+{
+	return (__atomic_load_n(&_ring[_tail & (RING_SIZE - 1)].seq, __ATOMIC_ACQUIRE) == _tail + 1
+		|| __atomic_load_n(&_dropped, __ATOMIC_RELAXED) != 0);
+}
+
+//* Announce the sleep first, then look at the ring once more: a producer
+//* either sees _waiting and signals (it can only get the mutex once we are
+//* in pthread_cond_wait()), or published before our look and we see it.
+void Log::waitForLines()
+{
+	pthread_mutex_lock(&_lock);
+	__atomic_store_n(&_waiting, 1, __ATOMIC_SEQ_CST);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	while (__atomic_load_n(&_running, __ATOMIC_ACQUIRE) && !pending())
+		pthread_cond_wait(&_wakeup, &_lock);
+	__atomic_store_n(&_waiting, 0, __ATOMIC_RELAXED);
+	pthread_mutex_unlock(&_lock);
+}
+
+//* Producer side, after publishing: one fence and a load while the writer
+//* is busy, the mutex only when it actually sleeps
+void Log::wakeWriter()
+{
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if (!__atomic_load_n(&_waiting, __ATOMIC_RELAXED))
+		return;
+	pthread_mutex_lock(&_lock);
+	pthread_cond_signal(&_wakeup);
+	pthread_mutex_unlock(&_lock);
+}
+
+//* Take up to one batch of published lines, in order, and write each
+//* stream with a single write(). False when the ring was empty.
+bool Log::drain(std::string& out, std::string& err)
+{
+	size_t taken = 0;
+	while (taken < DRAIN_BATCH)
+	{
+		Slot& slot = _ring[_tail & (RING_SIZE - 1)];
+		if (__atomic_load_n(&slot.seq, __ATOMIC_ACQUIRE) != _tail + 1)
+			break;									//* Empty, or claimed but not written yet
+		int fd = fdFor(slot.level);
+		append(fd == 2 ? err : out, fd, slot.text, slot.length);
+		__atomic_store_n(&slot.seq, _tail + RING_SIZE, __ATOMIC_RELEASE);	//* Free for lap + 1
+		++_tail;
+		++taken;
+	}
+
+	unsigned long dropped = __atomic_exchange_n(&_dropped, 0UL, __ATOMIC_RELAXED);
+	if (dropped)
+	{
+		std::ostringstream note;
+		note << "[LOG] " << dropped << " lines dropped (ring full)";
+		append(err, 2, note.str().data(), note.str().size());
+	}
+	flush(1, out);
+	flush(2, err);
+	return (taken > 0);
+}
+
+//* ============================================================================
+//* PRODUCERS
+//* ============================================================================
+
+//* Bounded MPMC ring (Vyukov): claim a slot by advancing _head when its
+//* sequence says it's free, fill it, then publish it with seq = pos + 1.
+//* Never waits: a full ring drops the line.
+void Log::write(Level level, const std::string& text)
+{
+	if (!__atomic_load_n(&_running, __ATOMIC_ACQUIRE))
+	{
+		std::string line;
+		int fd = fdFor(level);
+		append(line, fd, text.data(), text.size());
+		flush(fd, line);
+		return;
+	}
+
+	unsigned long pos = __atomic_load_n(&_head, __ATOMIC_RELAXED);
+	Slot* slot;
+	for (;;)
+	{
+		slot = &_ring[pos & (RING_SIZE - 1)];
+		long diff = static_cast<long>(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) - pos);
+		if (diff == 0)
+		{
+			if (__atomic_compare_exchange_n(&_head, &pos, pos + 1, true,
+					__ATOMIC_RELAXED, __ATOMIC_RELAXED))
+				break;								//* pos reloaded on failure
+		}
+		else if (diff < 0)
+		{
+			__atomic_fetch_add(&_dropped, 1UL, __ATOMIC_RELAXED);
+			wakeWriter();
+			return;
+		}
+		else
+			pos = __atomic_load_n(&_head, __ATOMIC_RELAXED);
+	}
+
+	size_t length = text.size() < SLOT_TEXT ? text.size() : SLOT_TEXT;
+	std::memcpy(slot->text, text.data(), length);
+	slot->length = static_cast<unsigned short>(length);
+	slot->level = static_cast<unsigned char>(level);
+	__atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+	wakeWriter();
+}
+
+Log::Line::Line(Level level) : _level(level)
+{
+}
+
+Log::Line::~Line()
+{
+	Log::write(_level, _stream.str());
+}
+
+std::ostringstream& Log::Line::stream()
+{
+	return (_stream);
+}
+
+//* ============================================================================
+//* OUTPUT
+//* ============================================================================
+
+//* One line plus its newline. Colors ("\033[...m") are skipped when the
+//* stream goes to a file or a pipe.
+void Log::append(std::string& out, int fd, const char* text, size_t length)
+{
+	if (!_plain[fd])
+		out.append(text, length);
+	else
+	{
+		for (size_t i = 0; i < length; ++i)
+		{
+			if (text[i] == '\033' && i + 1 < length && text[i + 1] == '[')
+			{
+				i += 2;
+				while (i < length && text[i] != 'm')
+					++i;
+				continue;
+			}
+			out += text[i];
+		}
+	}
+	out += '\n';
+}
+
+void Log::flush(int fd, std::string& buffer)
+{
+	size_t offset = 0;
+	while (offset < buffer.size())
+	{
+		ssize_t written = ::write(fd, buffer.data() + offset, buffer.size() - offset);
+		if (written < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			break;										//* Nowhere left to report it
+		}
+		offset += static_cast<size_t>(written);
+	}
+	buffer.clear();
+}
@@ -0,0 +1,134 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Log.hpp                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 02:45:12 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 02:45:12 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef LOG_HPP
+#define LOG_HPP
+
+#include <string>
+#include <sstream>
+#include <cstddef>
+#include <pthread.h>
+
+/**
+ * Log: Leveled, asynchronous server log
+ *
+ * A call formats its line into a slot of a fixed ring (lock-free, any
+ * thread) and returns; a background thread drains the ring and writes the
+ * lines in batches, so no event loop ever blocks on the terminal or the
+ * journal. When the ring is full the line is dropped and counted instead.
+ * An idle writer sleeps on a condition variable; producers only take its
+ * mutex to wake it up, when it is actually waiting.
+ *
+ * Two filters, both before anything is formatted:
+ * - compile time: levels above LOG_LEVEL_MAX compile to nothing
+ *   (make LOG_LEVEL_MAX=3 removes every LOG_DEBUG)
+ * - run time: --log-level, checked with one comparison
+ *
+ * ERROR and WARN go to stderr, INFO and DEBUG to stdout. ANSI colors are
+ * stripped (by the writer thread) when the stream isn't a terminal.
+ * Before start() and after stop() lines are written synchronously.
+ *
+ * Usage:
+ *   LOG_INFO(GREEN << "[SERVER] New client fd=" << fd << RESET);
+ */
+
+#ifndef LOG_LEVEL_MAX
+# define LOG_LEVEL_MAX 4						//* 1 error, 2 warn, 3 info, 4 debug
+#endif
+
+class Log
+{
+	public:
+		enum Level
+		{
+			LEVEL_ERROR = 1,
+			LEVEL_WARN,
+			LEVEL_INFO,
+			LEVEL_DEBUG
+		};
+
+		static void		setLevel(Level level);		//* At startup, before the loops run
+		static bool		enabled(Level level);
+		static bool		parseLevel(const std::string& name, Level& level);
+		static const char*	levelName(Level level);
+
+		static bool		start();					//* Spawn the writer thread
+		static void		stop();						//* Drain everything, join the thread
+
+		static void		write(Level level, const std::string& text);	//* Any thread
+
+		//* One formatted line, committed to the ring when it goes out of scope
+		class Line
+		{
+			public:
+				explicit Line(Level level);
+				~Line();
+				std::ostringstream&	stream();
+
+			private:
+				Level				_level;
+				std::ostringstream	_stream;
+
+				Line(const Line&);
+				Line& operator=(const Line&);
+		};
+
+	private:
+		static const size_t	RING_SIZE = 4096;		//* Slots, power of two
+		static const size_t	SLOT_TEXT = 496;		//* Longer lines are truncated
+
+		struct Slot
+		{
+			unsigned long	seq;					//* Vyukov sequence (__atomic)
+			unsigned short	length;
+			unsigned char	level;
+			char			text[SLOT_TEXT];
+		};
+
+		static Level			_level;
+		static Slot				_ring[RING_SIZE];
+		static unsigned long	_head;				//* Next slot to claim (__atomic, producers)
+		static unsigned long	_tail;				//* Next slot to drain (writer thread only)
+		static unsigned long	_dropped;			//* Lines lost to a full ring (__atomic)
+		static int				_running;			//* Writer thread alive (__atomic)
+		static int				_waiting;			//* Writer asleep on _wakeup (__atomic)
+		static pthread_t		_thread;
+		static pthread_mutex_t	_lock;				//* Only around the writer's sleep
+		static pthread_cond_t	_wakeup;
+		static bool				_plain[3];			//* Per fd: strip colors (not a tty)
+
+		static void*	threadMain(void* arg);
+		static bool		pending();
+		static void		waitForLines();
+		static void		wakeWriter();
+		static bool		drain(std::string& out, std::string& err);
+		static void		append(std::string& out, int fd, const char* text, size_t length);
+		static void		flush(int fd, std::string& buffer);
+
+		Log();
+};
+
+#define LOG_AT(level, expr) \
+	do { \
+		if ((level) <= LOG_LEVEL_MAX && Log::enabled(level)) \
+		{ \
+			Log::Line log_line_(level); \
+			log_line_.stream() << expr; \
+		} \
+	} while (0)
+
+#define LOG_ERROR(expr)	LOG_AT(Log::LEVEL_ERROR, expr)
+#define LOG_WARN(expr)	LOG_AT(Log::LEVEL_WARN, expr)
+#define LOG_INFO(expr)	LOG_AT(Log::LEVEL_INFO, expr)
+#define LOG_DEBUG(expr)	LOG_AT(Log::LEVEL_DEBUG, expr)
+
+#endif
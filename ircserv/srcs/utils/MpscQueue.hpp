@@ -0,0 +1,95 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   MpscQueue.hpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 17:48:20 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 17:48:20 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef MPSC_QUEUE_HPP
+#define MPSC_QUEUE_HPP
+
+#include <cstddef>
+
+/**
+ * MpscQueue: Lock-free multi-producer / single-consumer FIFO
+ *
+ * Any thread may push(); only the owning thread may pop(). Producers
+ * swap themselves in as the new head with one atomic exchange, so they
+ * never wait on each other or on the consumer (Vyukov's node-based
+ * queue with a dummy node). Between that exchange and linking the
+ * previous node there is a short window where the consumer sees the
+ * queue as empty, which pending() reports so the consumer can look again
+ * instead of going to sleep on a wakeup that was already spent.
+ *
+ * Usage:
+ *   queue.push(item);				// any thread
+ *   while (queue.pop(item)) ...	// owner thread only
+ */
+
+template <typename T>
+class MpscQueue
+{
+	public:
+		MpscQueue()
+		{
+			Node* dummy = new Node();
+			_head = dummy;
+			_tail = dummy;
+		}
+
+		~MpscQueue()
+		{
+			T dummy;
+			while (pop(dummy))
+				;
+			delete _tail;
+		}
+
+		void push(const T& value)
+		{
+			Node* node = new Node();
+			node->value = value;
+			Node* prev = __atomic_exchange_n(&_head, node, __ATOMIC_ACQ_REL);
+			__atomic_store_n(&prev->next, node, __ATOMIC_RELEASE);	//* Publishes value too
+		}
+
+		bool pop(T& out)
+		{
+			Node* tail = _tail;
+			Node* next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+			if (next == NULL)
+				return (false);
+			out = next->value;
+			_tail = next;									//* 'next' becomes the new dummy
+			delete tail;
+			return (true);
+		}
+
+		//* Owner thread: pushed items pop() hasn't returned, linked or not yet
+		bool pending() const
+		{
+			return (__atomic_load_n(&_head, __ATOMIC_ACQUIRE) != _tail);
+		}
+
+	private:
+		struct Node
+		{
+			Node*			next;		//* Accessed with __atomic builtins
+			T				value;
+
+			Node() : next(NULL), value() {}
+		};
+
+		Node*			_head;		//* Producers: last pushed node (atomic exchange)
+		Node*			_tail;		//* Consumer: dummy node before the oldest item
+
+		MpscQueue(const MpscQueue&);
+		MpscQueue& operator=(const MpscQueue&);
+};
+
+#endif
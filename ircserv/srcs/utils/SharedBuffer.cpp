@@ -0,0 +1,49 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   SharedBuffer.cpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 14:05:33 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 14:05:33 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "SharedBuffer.hpp"
+
+SharedBuffer::SharedBuffer(const std::string& data) : _data(data), _refs(1)
+{
+}
+
+SharedBuffer::~SharedBuffer()
+{
+}
+
+SharedBuffer* SharedBuffer::create(const std::string& data)
+{
+	return (new SharedBuffer(data));
+}
+
+//* Atomic: a broadcast buffer can be queued to connections of several
+//* event loops, each releasing it from its own thread.
+void SharedBuffer::retain()
+{
+	__sync_fetch_and_add(&_refs, 1);
+}
+
+void SharedBuffer::release()
+{
+	if (__sync_sub_and_fetch(&_refs, 1) == 0)
+		delete this;
+}
+
+const char* SharedBuffer::data() const
+{
+	return (_data.data());
+}
+
+size_t SharedBuffer::size() const
+{
+	return (_data.size());
+}
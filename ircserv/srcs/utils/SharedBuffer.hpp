@@ -0,0 +1,55 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   SharedBuffer.hpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 14:05:33 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 14:05:33 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef SHARED_BUFFER_HPP
+#define SHARED_BUFFER_HPP
+
+#include <string>
+#include <cstddef>
+
+/**
+ * SharedBuffer: Immutable, reference-counted block of outgoing bytes
+ *
+ * A line that goes to many clients (channel broadcast, NICK change) is
+ * serialized once into a SharedBuffer and every recipient's send queue
+ * just keeps a reference to it. The buffer deletes itself when the last
+ * queue releases it, so fan-out cost no longer depends on line length.
+ *
+ * Usage:
+ *   SharedBuffer* buf = SharedBuffer::create(line);	// refs = 1 (caller)
+ *   conn->queueShared(buf);						// refs + 1 per queue
+ *   buf->release();								// drop caller's ref
+ */
+
+class SharedBuffer
+{
+	public:
+		static SharedBuffer*	create(const std::string& data);
+
+		void		retain();
+		void		release();
+
+		const char*	data() const;
+		size_t		size() const;
+
+	private:
+		const std::string	_data;
+		volatile int		_refs;			//* Updated with __sync atomics
+
+		explicit SharedBuffer(const std::string& data);
+		~SharedBuffer();
+
+		SharedBuffer(const SharedBuffer&);
+		SharedBuffer& operator=(const SharedBuffer&);
+};
+
+#endif
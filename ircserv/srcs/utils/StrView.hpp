@@ -0,0 +1,65 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   StrView.hpp                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 16:40:12 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 16:40:12 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef STR_VIEW_HPP
+#define STR_VIEW_HPP
+
+#include <string>
+#include <cstring>
+#include <cstddef>
+
+/**
+ * StrView: Non-owning pointer + length span over someone else's bytes
+ *
+ * Used by the parser to point into the receive buffer without copying.
+ * It converts implicitly to std::string, so code that wants to keep the
+ * data (store a topic, a nickname...) copies exactly at that point.
+ * A StrView is only valid while the bytes it points to are.
+ */
+
+class StrView
+{
+	public:
+		StrView() : _data(""), _size(0) {}
+		StrView(const char* data, size_t size) : _data(data), _size(size) {}
+
+		const char*	data() const { return _data; }
+		size_t		size() const { return _size; }
+		size_t		length() const { return _size; }
+		bool		empty() const { return _size == 0; }
+		char		operator[](size_t i) const { return _data[i]; }
+
+		std::string	str() const { return std::string(_data, _size); }
+		operator std::string() const { return str(); }
+
+		bool	equals(const char* s, size_t n) const
+		{
+			return _size == n && std::memcmp(_data, s, n) == 0;
+		}
+
+	private:
+		const char*	_data;
+		size_t		_size;
+};
+
+inline bool operator==(const StrView& a, const std::string& b) { return a.equals(b.data(), b.size()); }
+inline bool operator!=(const StrView& a, const std::string& b) { return !(a == b); }
+inline bool operator==(const std::string& a, const StrView& b) { return b == a; }
+inline bool operator!=(const std::string& a, const StrView& b) { return !(b == a); }
+
+inline std::string operator+(const std::string& a, const StrView& b)
+{
+	std::string out(a);
+	return out.append(b.data(), b.size());
+}
+
+#endif
@@ -0,0 +1,201 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   TimerWheel.cpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 21:12:03 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 21:12:03 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "TimerWheel.hpp"
+
+static const unsigned MASK = TimerWheel::SLOTS - 1;
+
+TimerWheel::Node::Node() : prev(NULL), next(NULL), expires(0), owner(NULL)
+{
+}
+
+TimerWheel::TimerWheel(unsigned long now) : _current(now), _count(0)
+{
+	for (unsigned level = 0; level < LEVELS; ++level)
+	{
+		_occupied[level] = 0;
+		for (unsigned slot = 0; slot < SLOTS; ++slot)
+		{
+			_slots[level][slot].prev = &_slots[level][slot];
+			_slots[level][slot].next = &_slots[level][slot];
+		}
+	}
+}
+
+//* ============================================================================
+//* SCHEDULING
+//* ============================================================================
+
+void TimerWheel::schedule(Node* node, unsigned long expires)
+{
+	if (isScheduled(node))
+		unlink(node);
+	node->expires = expires;
+	insert(node, _current + 1);
+}
+
+void TimerWheel::cancel(Node* node)
+{
+	if (isScheduled(node))
+		unlink(node);
+}
+
+bool TimerWheel::isScheduled(const Node* node)
+{
+	return (node->next != NULL);
+}
+
+size_t TimerWheel::size() const
+{
+	return (_count);
+}
+
+//* Bucket from the distance to the deadline. Past deadlines fire at
+//* `earliest` (the next tick, or the one being processed while cascading);
+//* deadlines beyond the top level wait in its farthest bucket and are
+//* placed again when it cascades, so they never fire early.
+void TimerWheel::insert(Node* node, unsigned long earliest)
+{
+	unsigned long at = node->expires > earliest ? node->expires : earliest;
+	unsigned long delta = at - _current;
+	unsigned level = 0;
+	while (level + 1 < LEVELS && delta >= (1UL << (SLOT_BITS * (level + 1))))
+		level++;
+	unsigned long range = 1UL << (SLOT_BITS * LEVELS);
+	if (delta >= range)
+		at = _current + range - 1;
+
+	unsigned slot = (at >> (SLOT_BITS * level)) & MASK;
+	Node* head = &_slots[level][slot];
+	node->prev = head->prev;
+	node->next = head;
+	head->prev->next = node;
+	head->prev = node;
+	_occupied[level] |= 1U << slot;
+	_count++;
+}
+
+void TimerWheel::unlink(Node* node)
+{
+	Node* next = node->next;
+	node->prev->next = next;
+	next->prev = node->prev;
+	node->prev = NULL;
+	node->next = NULL;
+	_count--;
+
+	// Bucket now empty (only the sentinel left): clear its bit
+	if (next->next == next)
+	{
+		for (unsigned level = 0; level < LEVELS; ++level)
+		{
+			Node* first = &_slots[level][0];
+			if (next >= first && next < first + SLOTS)
+			{
+				_occupied[level] &= ~(1U << (next - first));
+				break;
+			}
+		}
+	}
+}
+
+//* ============================================================================
+//* EXPIRY
+//* ============================================================================
+
+//* Every timer of the bucket that is due moves to a lower level (or fires
+//* through level 0) now that its whole range is within reach
+void TimerWheel::cascade(unsigned level)
+{
+	unsigned slot = (_current >> (SLOT_BITS * level)) & MASK;
+	Node* head = &_slots[level][slot];
+	while (head->next != head)
+	{
+		Node* node = head->next;
+		unlink(node);
+		insert(node, _current);
+	}
+}
+
+void TimerWheel::advance(unsigned long now, std::vector<Node*>& expired)
+{
+	while (_current < now)
+	{
+		if (_count == 0)
+		{
+			_current = now;
+			break;
+		}
+		// Nothing on level 0: jump straight to the next cascade point
+		if (_occupied[0] == 0)
+		{
+			unsigned long boundary = (_current | MASK) + 1;
+			if (boundary > now)
+			{
+				_current = now;
+				break;
+			}
+			_current = boundary - 1;
+		}
+
+		_current++;
+		unsigned slot = _current & MASK;
+		if (slot == 0)
+		{
+			// Lower level first: whatever the upper ones hand down lands in
+			// buckets ahead of the one just emptied
+			for (unsigned level = 1; level < LEVELS; ++level)
+			{
+				cascade(level);
+				if (((_current >> (SLOT_BITS * level)) & MASK) != 0)
+					break;
+			}
+		}
+
+		Node* head = &_slots[0][slot];
+		while (head->next != head)
+		{
+			Node* node = head->next;
+			unlink(node);
+			expired.push_back(node);
+		}
+	}
+}
+
+//* Nearest bucket, on any level, that advance() will visit: level 0 buckets
+//* fire, upper ones cascade. Upper levels only give a lower bound, which is
+//* all a wait timeout needs.
+long TimerWheel::next() const
+{
+	if (_count == 0)
+		return (-1);
+
+	unsigned long best = 0;
+	for (unsigned level = 0; level < LEVELS; ++level)
+	{
+		if (_occupied[level] == 0)
+			continue;
+		unsigned shift = SLOT_BITS * level;
+		unsigned long block = _current >> shift;
+		for (unsigned step = 1; step <= SLOTS; ++step)
+		{
+			if (_occupied[level] & (1U << ((block + step) & MASK)))
+			{
+				unsigned long ticks = ((block + step) << shift) - _current;
+				if (best == 0 || ticks < best)
+					best = ticks;
+				break;
+			}
+		}
+	}
+	return (static_cast<long>(best));
+}
@@ -0,0 +1,80 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   TimerWheel.hpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 21:12:03 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 21:12:03 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef TIMER_WHEEL_HPP
+#define TIMER_WHEEL_HPP
+
+#include <vector>
+#include <cstddef>
+
+/**
+ * TimerWheel: Hierarchical timing wheel (Varghese & Lauck)
+ *
+ * LEVELS wheels of SLOTS buckets each; level N buckets span SLOTS^N ticks.
+ * A timer goes to the lowest level whose range covers its distance, and
+ * moves down one level each time the wheel above it turns (cascade), so
+ * schedule() and cancel() are O(1) whatever the number of timers.
+ *
+ * Timers are intrusive nodes (no allocation): the owner embeds a Node and
+ * gets it back from advance() once it expires. A node sits in at most one
+ * bucket; scheduling it again moves it.
+ *
+ * Time is in ticks (the caller picks the unit). A per-level bitmap of
+ * non-empty buckets lets advance() skip idle stretches and next() tell
+ * when the wheel needs to run again without scanning buckets.
+ */
+
+class TimerWheel
+{
+	public:
+		struct Node
+		{
+			Node*			prev;
+			Node*			next;
+			unsigned long	expires;			//* Tick
+			void*			owner;
+
+			Node();
+		};
+
+		static const unsigned	SLOT_BITS = 5;
+		static const unsigned	SLOTS = 1U << SLOT_BITS;	//* One bit each in an unsigned
+		static const unsigned	LEVELS = 5;					//* 2^25 ticks of range
+
+		explicit TimerWheel(unsigned long now);
+
+		void	schedule(Node* node, unsigned long expires);
+		void	cancel(Node* node);
+		static bool	isScheduled(const Node* node);
+		size_t	size() const;
+
+		//* Fire everything due up to `now`: nodes are unlinked and appended
+		void	advance(unsigned long now, std::vector<Node*>& expired);
+
+		//* Ticks from the last advance() until it has work again, -1 if empty
+		long	next() const;
+
+	private:
+		Node			_slots[LEVELS][SLOTS];		//* Sentinels of circular lists
+		unsigned		_occupied[LEVELS];			//* Bit per non-empty bucket
+		unsigned long	_current;					//* Last tick processed
+		size_t			_count;
+
+		void	insert(Node* node, unsigned long earliest);
+		void	unlink(Node* node);
+		void	cascade(unsigned level);
+
+		TimerWheel(const TimerWheel&);
+		TimerWheel& operator=(const TimerWheel&);
+};
+
+#endif
@@ -0,0 +1,65 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   TokenBucket.cpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 20:05:41 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 20:05:41 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "TokenBucket.hpp"
+
+static const long UNIT = 1000;				//* Credit units per token
+
+TokenBucket::TokenBucket() : _credit(0), _capacity(0), _rate(0), _last(0)
+{
+}
+
+//* Starts full: a client may send its whole burst right after connecting
+void TokenBucket::configure(unsigned long burst, unsigned long rate, unsigned long now)
+{
+	_capacity = static_cast<long>(burst) * UNIT;
+	_credit = _capacity;
+	_rate = rate;
+	_last = now;
+}
+
+bool TokenBucket::enabled() const
+{
+	return (_rate != 0);
+}
+
+bool TokenBucket::ready(unsigned long now)
+{
+	if (!_rate)
+		return (true);
+	if (now > _last)
+	{
+		unsigned long gained = (now - _last) * _rate;
+		if (gained > static_cast<unsigned long>(_capacity - _credit))
+			_credit = _capacity;
+		else
+			_credit += static_cast<long>(gained);
+		_last = now;
+	}
+	return (_credit >= UNIT);
+}
+
+void TokenBucket::charge(unsigned long cost)
+{
+	if (_rate)
+		_credit -= static_cast<long>(cost) * UNIT;
+}
+
+unsigned long TokenBucket::delay(unsigned long now) const
+{
+	if (!_rate)
+		return (0);
+	long credit = _credit + static_cast<long>((now > _last ? now - _last : 0) * _rate);
+	if (credit >= UNIT)
+		return (0);
+	return ((static_cast<unsigned long>(UNIT - credit) + _rate - 1) / _rate);
+}
@@ -0,0 +1,50 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   TokenBucket.hpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: miaviles <miaviles@student.42madrid>       +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 20:05:41 by miaviles          #+#    #+#             */
+/*   Updated: 2026/10/18 20:05:41 by miaviles         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef TOKEN_BUCKET_HPP
+#define TOKEN_BUCKET_HPP
+
+/**
+ * TokenBucket: Command rate limiter of one connection (flood control)
+ *
+ * Refills at `rate` tokens per second up to `burst`. Credit is kept in
+ * thousandths of a token so slow rates still refill every millisecond.
+ *
+ * Works on a debt model, like the classic ircd penalty: a command may run
+ * while at least one whole token is available, and its cost is charged
+ * afterwards. An expensive command (WHO on a big channel) can push the
+ * credit below zero, delaying whatever the client sends next.
+ *
+ * A rate of 0 disables the limit: ready() is always true.
+ * Times are milliseconds from any monotonic clock.
+ */
+
+class TokenBucket
+{
+	public:
+		TokenBucket();
+
+		void			configure(unsigned long burst, unsigned long rate, unsigned long now);
+		bool			enabled() const;
+
+		bool			ready(unsigned long now);			//* Refill, true if a command may run
+		void			charge(unsigned long cost);			//* Cost in tokens, may go into debt
+		unsigned long	delay(unsigned long now) const;		//* ms until ready() turns true
+
+	private:
+		long			_credit;			//* Thousandths of a token, negative = debt
+		long			_capacity;			//* burst * 1000
+		unsigned long	_rate;				//* Tokens/s, i.e. thousandths per ms
+		unsigned long	_last;				//* Time of the last refill
+};
+
+#endif
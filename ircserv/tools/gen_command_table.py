@@ -0,0 +1,116 @@
+#!/usr/bin/env python3
+"""Regenerate the perfect-hash tables of srcs/irc/CommandTable.cpp.
+
+Command names come from the CommandId enum in srcs/irc/CommandTable.hpp
+(CMD_PRIVMSG -> "PRIVMSG", CMD_UNKNOWN and CMD_COUNT excluded). The hash is
+the one lookupCommand() computes:
+
+    slot = (len + ASSOC[c0] + ASSOC[c1] + ASSOC[c_last]) % TABLE_SIZE
+
+ASSOC weights are drawn at random for the letters that appear in those
+positions (0 for the others) until every name lands in its own slot. The
+draw is seeded, so the same names and seed always give the same tables;
+seed 7 and size 32 produce the tables checked in today.
+
+Usage (from ircserv/):
+    python3 tools/gen_command_table.py            # print ASSOC and SLOTS
+    python3 tools/gen_command_table.py --write    # rewrite CommandTable.cpp
+Options: --seed=N (default 7), --size=N (default 32, a power of two is not
+required), --max-tries=N (default 1000000 draws before giving up).
+"""
+import os
+import random
+import re
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+HEADER = os.path.join(HERE, "..", "srcs", "irc", "CommandTable.hpp")
+SOURCE = os.path.join(HERE, "..", "srcs", "irc", "CommandTable.cpp")
+LETTERS = [chr(ord("A") + i) for i in range(26)]
+
+
+def command_names():
+    text = open(HEADER).read()
+    body = re.search(r"enum CommandId\s*\{(.*?)\};", text, re.S).group(1)
+    names = re.findall(r"\bCMD_([A-Z]+)\b", body)
+    return [n for n in names if n not in ("UNKNOWN", "COUNT")]
+
+
+def slot_of(name, assoc, size):
+    return (len(name) + assoc[name[0]] + assoc[name[1]] + assoc[name[-1]]) % size
+
+
+def search(names, size, seed, max_tries):
+    used = set(c for n in names for c in (n[0], n[1], n[-1]))
+    rng = random.Random(seed)
+    for _ in range(max_tries):
+        assoc = dict((c, rng.randrange(size) if c in used else 0) for c in LETTERS)
+        slots = [slot_of(n, assoc, size) for n in names]
+        if len(set(slots)) == len(names):
+            return assoc, dict(zip(slots, names))
+    return None, None
+
+
+def render(names, assoc, slots, size):
+    weights = ["%2d" % assoc[c] for c in LETTERS]
+    out = []
+    out.append("static const size_t TABLE_SIZE = %d;" % size)
+    out.append("static const size_t MIN_LENGTH = %d;" % min(len(n) for n in names))
+    out.append("static const size_t MAX_LENGTH = %d;" % max(len(n) for n in names))
+    out.append("")
+    out.append("static const unsigned char ASSOC[26] =")
+    out.append("{")
+    out.append("\t" + ", ".join(weights[:13]) + ",\t//* A..M")
+    out.append("\t" + ", ".join(weights[13:]) + "\t//* N..Z")
+    out.append("};")
+    out.append("")
+    out.append("static const CommandEntry SLOTS[TABLE_SIZE] =")
+    out.append("{")
+    for i in range(size):
+        if i in slots:
+            name = slots[i]
+            out.append("\t{ %s%d, CMD_%s }," % (('"%s",' % name).ljust(11), len(name), name))
+        else:
+            out.append("\t{ %s0, CMD_UNKNOWN }," % "NULL,".ljust(11))
+    out.append("};")
+    return "\n".join(out) + "\n"
+
+
+def main(argv):
+    options = {"seed": 7, "size": 32, "max-tries": 1000000}
+    write = False
+    for arg in argv:
+        if arg == "--write":
+            write = True
+            continue
+        match = re.match(r"--(seed|size|max-tries)=(\d+)$", arg)
+        if not match:
+            sys.stderr.write(__doc__)
+            return 1
+        options[match.group(1)] = int(match.group(2))
+
+    names = command_names()
+    if options["size"] < len(names):
+        sys.stderr.write("size %d is smaller than the %d commands\n" % (options["size"], len(names)))
+        return 1
+    assoc, slots = search(names, options["size"], options["seed"], options["max-tries"])
+    if assoc is None:
+        sys.stderr.write("no collision-free weights found: try another --seed or a larger --size\n")
+        return 1
+    tables = render(names, assoc, slots, options["size"])
+
+    if not write:
+        sys.stdout.write(tables)
+        return 0
+    source = open(SOURCE).read()
+    pattern = re.compile(r"static const size_t TABLE_SIZE = .*?\nstatic const CommandEntry SLOTS\[TABLE_SIZE\] =\n\{\n.*?\n\};\n", re.S)
+    if not pattern.search(source):
+        sys.stderr.write("tables not found in %s\n" % SOURCE)
+        return 1
+    open(SOURCE, "w").write(pattern.sub(lambda m: tables, source, count=1))
+    print("%s: %d commands in %d slots" % (os.path.relpath(SOURCE), len(names), options["size"]))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))